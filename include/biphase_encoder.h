@@ -10,6 +10,8 @@
 #ifndef ENCODE_ORC_BIPHASE_ENCODER_H
 #define ENCODE_ORC_BIPHASE_ENCODER_H
 
+#include "manchester_encoder.h"
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -25,9 +27,43 @@ namespace encode_orc {
  * - Bit length: 2.0 µs per bit
  * - Total frame length: 48 µs (24 bits)
  * - MSB first transmission
+ *
+ * An encoder object holds the rendered '0' and '1' bit cells for one
+ * sample rate and pair of levels, and writes codes straight into the
+ * caller's line buffers. The static encode() is kept for one-off use.
  */
 class BiphaseEncoder {
 public:
+    /**
+     * @brief Build the bit cells for a signal format
+     * @param sample_rate Sample rate in Hz
+     * @param line_period_h Line period (H) in seconds
+     * @param high_level High voltage level (in 16-bit scale)
+     * @param low_level Low voltage level (in 16-bit scale)
+     */
+    BiphaseEncoder(double sample_rate,
+                   double line_period_h,
+                   uint16_t high_level,
+                   uint16_t low_level);
+
+    /**
+     * @brief Render a 24-bit code into a line at the standard start position
+     * @param value 24-bit value (MSB first on the line)
+     * @param line_buffer Line to render into (already contains sync/burst/blanking)
+     * @param buffer_size Samples in the line
+     */
+    void render(uint32_t value, uint16_t* line_buffer, int32_t buffer_size) const;
+
+    /**
+     * @brief Render the three LaserDisc VBI codes of a field in one call
+     * @param values Codes for field lines 16, 17 and 18
+     * @param lines Lines to render into, in the same order
+     * @param buffer_size Samples in each line
+     */
+    void render_lines(const std::array<uint32_t, 3>& values,
+                      const std::array<uint16_t*, 3>& lines,
+                      int32_t buffer_size) const;
+
     /**
      * @brief Encode three 8-bit values into biphase signal
      * @param byte0 First byte (MSB of 24-bit value)
@@ -75,18 +111,8 @@ public:
     static int32_t get_signal_start_position(double sample_rate, double line_period_h);
 
 private:
-    /**
-     * @brief Generate a single biphase bit
-     * @param bit_value Logical bit value (0 or 1)
-     * @param sample_rate Sample rate in Hz
-     * @param high_level High voltage level
-     * @param low_level Low voltage level
-     * @return Vector of samples for this bit
-     */
-    static std::vector<uint16_t> encode_bit(bool bit_value,
-                                            double sample_rate,
-                                            uint16_t high_level,
-                                            uint16_t low_level);
+    ManchesterBitCells cells_;
+    int32_t start_position_;
 };
 
 } // namespace encode_orc
@@ -0,0 +1,192 @@
+/*
+ * File:        buffer_pool.h
+ * Module:      encode-orc
+ * Purpose:     Aligned sample storage and recycled buffer pools
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_BUFFER_POOL_H
+#define ENCODE_ORC_BUFFER_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Raw storage for field and frame sample buffers
+ *
+ * Every block starts on a 64-byte boundary, so lines and planes begin on a
+ * cache line and vector loads of the first samples never split one. With
+ * huge pages enabled, blocks of at least HUGE_PAGE_SIZE bytes are aligned
+ * to a huge page and the kernel is asked to back them with transparent huge
+ * pages (Linux only; elsewhere the setting has no effect).
+ */
+class SampleStorage {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /**
+     * @brief Allocate an aligned block
+     * @param bytes Size of the block
+     * @throws std::bad_alloc if the allocation fails
+     */
+    static void* allocate(size_t bytes);
+
+    /**
+     * @brief Free a block from allocate()
+     */
+    static void deallocate(void* block) noexcept;
+
+    /**
+     * @brief Back large blocks with huge pages (default: off)
+     *
+     * Set once at startup, before any encoding starts.
+     */
+    static void set_huge_pages(bool enabled);
+
+    /**
+     * @brief Check if huge-page backing is enabled
+     */
+    static bool huge_pages_enabled();
+};
+
+/**
+ * @brief Standard allocator handing out SampleStorage blocks
+ */
+template <typename T>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(SampleStorage::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t /* count */) noexcept {
+        SampleStorage::deallocate(block);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const noexcept { return false; }
+};
+
+/**
+ * @brief 16-bit sample storage of fields and frame buffers
+ */
+using SampleVector = std::vector<uint16_t, AlignedAllocator<uint16_t>>;
+
+/**
+ * @brief Buffer counts of a BufferPool
+ */
+struct BufferPoolStats {
+    size_t allocated = 0;   ///< Buffers created so far
+    size_t live = 0;        ///< Buffers currently handed out
+    size_t peak = 0;        ///< Most buffers handed out at once
+    size_t reused = 0;      ///< acquire() calls served by a recycled buffer
+};
+
+/**
+ * @brief Thread-safe pool of recycled buffers
+ *
+ * acquire() passes ownership of a buffer to the caller as a Handle; when
+ * the handle is destroyed or reset the buffer goes back to the pool with
+ * its storage intact, so the next acquire() (of the same size of field or
+ * frame) needs no allocation. Buffers keep whatever the previous owner
+ * left in them.
+ *
+ * The pool must outlive every handle it gives out.
+ */
+template <typename T>
+class BufferPool {
+public:
+    /**
+     * @brief Handle deleter that returns the buffer to its pool
+     */
+    class Recycler {
+    public:
+        Recycler() noexcept = default;
+        explicit Recycler(BufferPool* pool) noexcept : pool_(pool) {}
+
+        void operator()(T* buffer) const noexcept {
+            if (pool_) {
+                pool_->release(buffer);
+            } else {
+                delete buffer;
+            }
+        }
+
+    private:
+        BufferPool* pool_ = nullptr;
+    };
+
+    using Handle = std::unique_ptr<T, Recycler>;
+
+    BufferPool() = default;
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Take a buffer, recycled if one is free
+     */
+    Handle acquire() {
+        std::unique_ptr<T> buffer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                buffer = std::move(free_.back());
+                free_.pop_back();
+                ++stats_.reused;
+            } else {
+                ++stats_.allocated;
+                // Room for every buffer, so release() never allocates
+                free_.reserve(stats_.allocated);
+            }
+            ++stats_.live;
+            stats_.peak = std::max(stats_.peak, stats_.live);
+        }
+        if (!buffer) {
+            buffer = std::make_unique<T>();
+        }
+        return Handle(buffer.release(), Recycler(this));
+    }
+
+    /**
+     * @brief Current buffer counts
+     */
+    BufferPoolStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<T>> free_;
+    BufferPoolStats stats_;
+
+    void release(T* buffer) noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --stats_.live;
+        free_.emplace_back(buffer);
+    }
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_BUFFER_POOL_H
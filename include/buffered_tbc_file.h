@@ -0,0 +1,238 @@
+/*
+ * File:        buffered_tbc_file.h
+ * Module:      encode-orc
+ * Purpose:     Buffered, batched file backend for TBC sample output
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_BUFFERED_TBC_FILE_H
+#define ENCODE_ORC_BUFFERED_TBC_FILE_H
+
+#include "field.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+struct iovec;
+
+namespace encode_orc {
+
+/**
+ * @brief Output file for 16-bit little-endian TBC samples
+ *
+ * Samples are staged in a large page-aligned buffer and written with a
+ * single system call each time the buffer fills, so a PAL field costs a
+ * memcpy rather than hundreds of thousands of stream writes. On
+ * little-endian hosts a field that does not fit in the remaining buffer
+ * space is written together with the staged data in one gathered write
+ * straight from the field's own memory; big-endian hosts byte-swap into
+ * the buffer instead.
+ *
+ * Optionally the file is opened with O_DIRECT (where supported) so long
+ * outputs bypass the page cache; the buffer is then always written in
+ * whole aligned blocks and only the final tail goes through the cache.
+ *
+ * A file can also be opened at a byte offset with open_at(), so several
+ * writers (one per section) fill their own regions of the same output
+ * concurrently; every write is a positioned write, so the writers never
+ * share a file position.
+ *
+ * Write throughput is tracked and logged when the file is closed.
+ */
+class BufferedTBCFile {
+public:
+    /// Default staging buffer size (a dozen or so PAL fields)
+    static constexpr size_t DEFAULT_BUFFER_BYTES = 8 * 1024 * 1024;
+
+    /// Block alignment used for the buffer and for direct I/O writes
+    static constexpr size_t BLOCK_ALIGNMENT = 4096;
+
+    /**
+     * @brief Write statistics since the file was opened
+     */
+    struct Stats {
+        uint64_t bytes_written = 0;
+        uint64_t write_calls = 0;
+        double write_seconds = 0.0;
+
+        /**
+         * @brief Throughput of the write calls in MB/s (0 if nothing written)
+         */
+        double throughput_mb_per_second() const {
+            return write_seconds > 0.0 ? static_cast<double>(bytes_written) / write_seconds / 1.0e6 : 0.0;
+        }
+    };
+
+    /**
+     * @brief Construct a closed file
+     * @param buffer_bytes Staging buffer size (rounded up to BLOCK_ALIGNMENT)
+     */
+    explicit BufferedTBCFile(size_t buffer_bytes = DEFAULT_BUFFER_BYTES);
+
+    /**
+     * @brief Destructor - flushes and closes the file
+     */
+    ~BufferedTBCFile();
+
+    BufferedTBCFile(const BufferedTBCFile&) = delete;
+    BufferedTBCFile& operator=(const BufferedTBCFile&) = delete;
+
+    /**
+     * @brief Create (or truncate) a file for writing
+     *
+     * Uses direct I/O if default_direct_io() is set and the filesystem
+     * supports it, otherwise falls back to normal buffered writes.
+     *
+     * @param filename Path to the file
+     * @return true on success, false on failure (see error())
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Open a file for writing from a byte offset, keeping its contents
+     *
+     * Creates the file if it does not exist. Region writers always use
+     * buffered writes, as sections rarely start on a block boundary.
+     *
+     * @param filename Path to the file
+     * @param offset Byte offset of the first sample written
+     * @return true on success, false on failure (see error())
+     */
+    bool open_at(const std::string& filename, int64_t offset);
+
+    /**
+     * @brief Reserve disk space for the whole file
+     *
+     * Allocates @p bytes with fallocate() so a full disk is reported before
+     * encoding starts rather than part way through, and sets the file size
+     * so sections can be written into it in any order. On filesystems
+     * without fallocate support the file is only extended (sparse).
+     *
+     * @param bytes Final file size
+     * @return true on success, false on failure (see error())
+     */
+    bool preallocate(int64_t bytes);
+
+    /**
+     * @brief Write any staged data and close the file
+     *
+     * Under direct I/O the unaligned tail is synced before the file is
+     * closed, so the file is as durable as after sync().
+     * @return true if every write succeeded, false otherwise
+     */
+    bool close();
+
+    /**
+     * @brief Check if the file is open
+     */
+    bool is_open() const { return fd_ >= 0; }
+
+    /**
+     * @brief Append a field's samples
+     * @param field Field to write
+     * @return true on success, false on failure
+     */
+    bool write_field(const Field& field) {
+        return write_samples(field.data().data(), field.size());
+    }
+
+    /**
+     * @brief Append 16-bit samples (written little-endian)
+     * @param samples Sample data
+     * @param count Number of samples
+     * @return true on success, false on failure
+     */
+    bool write_samples(const uint16_t* samples, size_t count);
+
+    /**
+     * @brief Write staged data to the file
+     *
+     * With direct I/O only whole blocks are written; the remainder stays
+     * staged until the next flush or close().
+     *
+     * @return true on success, false on failure
+     */
+    bool flush();
+
+    /**
+     * @brief Write staged data and wait until the file's data is on disk
+     *
+     * As with flush(), under direct I/O an unaligned remainder stays
+     * staged; flushed_position() tells how much is safely written.
+     *
+     * @return true on success, false on failure
+     */
+    bool sync();
+
+    /**
+     * @brief Bytes accepted so far (written plus staged), not counting the open_at() offset
+     */
+    int64_t position() const { return position_; }
+
+    /**
+     * @brief Bytes handed to the file so far (position() minus anything still staged)
+     */
+    int64_t flushed_position() const { return position_ - static_cast<int64_t>(staged_); }
+
+    /**
+     * @brief Whether the file was opened with direct I/O
+     */
+    bool direct_io() const { return direct_io_; }
+
+    /**
+     * @brief Write statistics since open()
+     */
+    const Stats& stats() const { return stats_; }
+
+    /**
+     * @brief Path of the open (or last opened) file
+     */
+    const std::string& filename() const { return filename_; }
+
+    /**
+     * @brief Description of the first failure
+     */
+    const std::string& error() const { return error_; }
+
+    /**
+     * @brief Request direct I/O for files opened from now on
+     */
+    static void set_default_direct_io(bool enabled);
+
+    /**
+     * @brief Whether direct I/O is requested for new files
+     */
+    static bool default_direct_io();
+
+private:
+    struct FreeDeleter {
+        void operator()(uint8_t* p) const { std::free(p); }
+    };
+
+    int fd_ = -1;
+    std::string filename_;
+    std::string error_;
+    bool direct_io_ = false;
+    bool failed_ = false;
+
+    std::unique_ptr<uint8_t, FreeDeleter> buffer_;
+    size_t capacity_;
+    size_t staged_ = 0;
+    int64_t position_ = 0;
+    int64_t write_offset_ = 0;    // File offset of the next write
+    Stats stats_;
+
+    bool open_file(const std::string& filename, int flags, int64_t offset, bool allow_direct_io);
+    void stage(const uint16_t* samples, size_t count);
+    bool flush_staged(bool final);
+    bool write_vectors(struct iovec* vectors, int count);
+    void fail(const std::string& message);
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_BUFFERED_TBC_FILE_H
@@ -0,0 +1,108 @@
+/*
+ * File:        checkpoint.h
+ * Module:      encode-orc
+ * Purpose:     Resume checkpoint recording how much of each section is on disk
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_CHECKPOINT_H
+#define ENCODE_ORC_CHECKPOINT_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Sidecar file (<output>.checkpoint) that lets a killed encode resume
+ *
+ * Every field's position in the output is fixed by the OutputPlan, so the
+ * only state worth keeping is how many fields of each section are safely
+ * on disk. The output is synced before the checkpoint is updated, so it
+ * never claims more than has been written. A fingerprint of the project
+ * and the output-affecting settings guards against resuming into output
+ * made from something else.
+ *
+ * The checkpoint is replaced atomically (write and fsync a temporary file,
+ * rename it, then fsync the directory) and may be updated from several
+ * threads, one per section.
+ */
+class Checkpoint {
+public:
+    /**
+     * @brief Checkpoint with no progress
+     * @param output_filename Project output filename (.tbc)
+     * @param fingerprint Fingerprint of the project and settings (see fingerprint())
+     * @param section_count Number of sections in the project
+     */
+    Checkpoint(const std::string& output_filename, uint64_t fingerprint, size_t section_count);
+
+    /**
+     * @brief Path of the checkpoint file for a project output
+     */
+    static std::string filename_for(const std::string& output_filename);
+
+    /**
+     * @brief Stable 64-bit fingerprint (FNV-1a) of some text
+     */
+    static uint64_t fingerprint(const std::string& text);
+
+    /**
+     * @brief Path of the checkpoint file
+     */
+    const std::string& filename() const { return filename_; }
+
+    /**
+     * @brief Whether a checkpoint file exists
+     */
+    bool exists() const;
+
+    /**
+     * @brief Read the progress from the checkpoint file
+     * @param error_message Set on failure, including a fingerprint or section count mismatch
+     * @return true on success, false on error
+     */
+    bool load(std::string& error_message);
+
+    /**
+     * @brief Fields of section @p section that are on disk
+     */
+    int64_t section_fields(size_t section) const;
+
+    /**
+     * @brief Record the fields of section @p section that are on disk
+     */
+    void set_section_fields(size_t section, int64_t fields);
+
+    /**
+     * @brief Fields on disk over all sections
+     */
+    int64_t total_fields() const;
+
+    /**
+     * @brief Write the checkpoint file
+     * @param error_message Set on failure
+     * @return true on success, false on error
+     */
+    bool save(std::string& error_message);
+
+    /**
+     * @brief Delete the checkpoint file (once the encode has finished)
+     */
+    void remove();
+
+private:
+    std::string filename_;
+    uint64_t fingerprint_;
+    mutable std::mutex mutex_;      // Guards section_fields_
+    std::mutex save_mutex_;         // Serialises save()
+    std::vector<int64_t> section_fields_;
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_CHECKPOINT_H
@@ -11,6 +11,7 @@
 #define ENCODE_ORC_COLOR_BURST_GENERATOR_H
 
 #include "video_parameters.h"
+#include "subcarrier_table.h"
 #include <cstdint>
 #include <cmath>
 
@@ -30,8 +31,9 @@ public:
     /**
      * @brief Construct a color burst generator
      * @param params Video parameters for the system (NTSC or PAL)
+     * @param subcarrier Subcarrier table for the same parameters
      */
-    explicit ColorBurstGenerator(const VideoParameters& params);
+    ColorBurstGenerator(const VideoParameters& params, const SubcarrierTable& subcarrier);
     
     /**
      * @brief Generate NTSC color burst with custom center level
@@ -57,6 +59,7 @@ public:
 
 private:
     const VideoParameters& params_;
+    const SubcarrierTable& subcarrier_;
     
     // Signal levels (16-bit samples)
     int32_t sync_level_;
@@ -70,32 +73,6 @@ private:
     // Constants
     static constexpr double PI = 3.141592653589793238463;
     
-    /**
-     * @brief Calculate phase for NTSC
-     * @param field_number Field number in sequence
-     * @param line_number Line number within field
-     * @param sample Sample position within line
-     * @return Phase in radians
-     */
-    double calculate_ntsc_phase(int32_t field_number, int32_t line_number, int32_t sample) const;
-    
-    /**
-     * @brief Calculate phase for PAL
-     * @param field_number Field number in sequence
-     * @param line_number Line number within field
-     * @param sample Sample position within line
-     * @return Phase in radians
-     */
-    double calculate_pal_phase(int32_t field_number, int32_t line_number, int32_t sample) const;
-    
-    /**
-     * @brief Calculate PAL V-switch for a given field and line
-     * @param field_number Field number
-     * @param line_number Line number within field
-     * @return +1 or -1 for V-switch
-     */
-    int32_t get_pal_v_switch(int32_t field_number, int32_t line_number) const;
-    
     /**
      * @brief Calculate envelope shaping factor for burst amplitude
      * @param sample Current sample position within burst
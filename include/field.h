@@ -10,8 +10,10 @@
 #ifndef ENCODE_ORC_FIELD_H
 #define ENCODE_ORC_FIELD_H
 
+#include "buffer_pool.h"
 #include <cstdint>
 #include <vector>
+#include <cstddef>
 
 namespace encode_orc {
 
@@ -19,7 +21,7 @@ namespace encode_orc {
  * @brief Represents a single interlaced video field
  * 
  * A field contains one set of scan lines from an interlaced video frame.
- * Fields are stored as 16-bit unsigned samples.
+ * Fields are stored as 16-bit unsigned samples in 64-byte-aligned storage.
  */
 class Field {
 public:
@@ -54,12 +56,12 @@ public:
     /**
      * @brief Access sample data (mutable)
      */
-    std::vector<uint16_t>& data() { return data_; }
+    SampleVector& data() { return data_; }
     
     /**
      * @brief Access sample data (const)
      */
-    const std::vector<uint16_t>& data() const { return data_; }
+    const SampleVector& data() const { return data_; }
     
     /**
      * @brief Get pointer to raw data for a specific line
@@ -125,7 +127,7 @@ public:
 private:
     int32_t width_ = 0;
     int32_t height_ = 0;
-    std::vector<uint16_t> data_;
+    SampleVector data_;
 };
 
 /**
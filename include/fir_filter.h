@@ -15,11 +15,35 @@
 #include <vector>
 #include <array>
 #include <cstdint>
+#include <cstddef>
 #include <algorithm>
 #include <cassert>
+#include <memory>
+#include <string>
 
 namespace encode_orc {
 
+/**
+ * @brief Filter applied by the encoders to each line of 16-bit samples
+ */
+class SampleFilter {
+public:
+    virtual ~SampleFilter() = default;
+
+    /**
+     * @brief Filter 16-bit samples from input into output
+     * @param input Source samples
+     * @param output Destination (must not overlap input)
+     * @param num_samples Number of samples
+     */
+    virtual void apply(const uint16_t* input, uint16_t* output, int32_t num_samples) const = 0;
+
+    /**
+     * @brief Get number of filter taps
+     */
+    virtual size_t num_taps() const = 0;
+};
+
 /**
  * @brief FIR filter with arbitrary coefficients
  * 
@@ -28,48 +52,80 @@ namespace encode_orc {
  * frequencies above the video bandwidth limits.
  * 
  * The number of filter taps must be odd to ensure zero phase distortion.
+ * 
+ * 16-bit filtering runs on vectorised kernels (AVX2 or SSE4.1, picked at
+ * runtime from the CPU, with a portable scalar fallback) in one of three
+ * precisions:
+ * - Exact: double precision, bit-identical to the scalar reference path
+ * - Float: single precision, symmetric taps folded to halve the multiplies
+ * - Fixed: 32-bit fixed point, symmetric taps folded
+ * 
+ * Float and Fixed stay within error_bound() of the reference. With
+ * verification enabled every filtered line is also run through the
+ * reference path and checked against that bound.
  */
-class FIRFilter {
+class FIRFilter : public SampleFilter {
 public:
+    /**
+     * @brief Arithmetic used by the 16-bit kernels
+     */
+    enum class Precision {
+        Exact,
+        Float,
+        Fixed
+    };
+
     /**
      * @brief Construct a FIR filter with given coefficients
      * @param coefficients Filter tap coefficients (must have odd length)
      */
-    explicit FIRFilter(const std::vector<double>& coefficients)
-        : coeffs_(coefficients)
-    {
-        assert((coefficients.size() % 2) == 1);
-    }
+    explicit FIRFilter(const std::vector<double>& coefficients);
 
     /**
      * @brief Apply filter to a vector of samples (in-place)
      * @param samples Input/output samples to filter
      */
-    void apply(std::vector<double>& samples) const {
-        if (samples.empty()) return;
-
-        thread_local std::vector<double> tmp;
-        tmp.resize(samples.size());
-        apply_internal(samples.data(), tmp.data(), static_cast<int>(samples.size()));
-        std::copy(tmp.begin(), tmp.end(), samples.begin());
-    }
+    void apply(std::vector<double>& samples) const;
 
     /**
      * @brief Apply filter to a vector of samples (in-place, 16-bit)
      * @param samples Input/output samples to filter
      */
-    void apply(std::vector<uint16_t>& samples) const {
-        if (samples.empty()) return;
+    void apply(std::vector<uint16_t>& samples) const;
 
-        thread_local std::vector<double> tmp_double;
-        tmp_double.resize(samples.size());
+    /**
+     * @brief Filter 16-bit samples from input into output
+     * @param input Source samples
+     * @param output Destination (must not overlap input)
+     * @param num_samples Number of samples
+     * @throws std::runtime_error if verification is enabled and the result
+     *         is outside error_bound()
+     */
+    void apply(const uint16_t* input, uint16_t* output, int32_t num_samples) const override;
 
-        for (size_t i = 0; i < samples.size(); ++i) {
-            tmp_double[i] = static_cast<double>(samples[i]);
-        }
+    /**
+     * @brief Filter 16-bit samples with the scalar double-precision reference
+     * @param input Source samples
+     * @param output Destination (must not overlap input)
+     * @param num_samples Number of samples
+     */
+    void apply_reference(const uint16_t* input, uint16_t* output, int32_t num_samples) const;
 
-        apply_internal_16bit(tmp_double.data(), samples.data(), static_cast<int>(samples.size()));
-    }
+    /**
+     * @brief Largest output difference from the reference path for this precision
+     * @return 0 for Exact, otherwise a bound in 16-bit sample units
+     */
+    int32_t error_bound() const;
+
+    /**
+     * @brief Select the arithmetic used by apply()
+     */
+    void set_precision(Precision precision) { precision_ = precision; }
+
+    /**
+     * @brief Arithmetic used by apply()
+     */
+    Precision precision() const { return precision_; }
 
     /**
      * @brief Check if filter is valid (has odd number of taps)
@@ -81,95 +137,106 @@ public:
     /**
      * @brief Get number of filter taps
      */
-    size_t num_taps() const {
+    size_t num_taps() const override {
         return coeffs_.size();
     }
 
+    /**
+     * @brief Check if the coefficients are symmetric (folded kernels apply)
+     */
+    bool is_symmetric() const { return symmetric_; }
+
+    /**
+     * @brief Precision given to newly constructed filters (default: Exact)
+     * 
+     * Set once at startup, before any encoding starts.
+     */
+    static void set_default_precision(Precision precision);
+
+    /**
+     * @brief Precision given to newly constructed filters
+     */
+    static Precision default_precision();
+
+    /**
+     * @brief Check every 16-bit apply() against the reference path
+     * 
+     * Set once at startup, before any encoding starts.
+     */
+    static void set_verification(bool enabled);
+
+    /**
+     * @brief Check if verification is enabled
+     */
+    static bool verification_enabled();
+
+    /**
+     * @brief Name of the instruction set the kernels dispatch to
+     * @return "avx2", "sse4.1" or "scalar"
+     */
+    static const char* instruction_set();
+
+    /**
+     * @brief Run the kernels on a lower instruction set than the CPU's best
+     * 
+     * For tests that compare the kernels with each other. Set before any
+     * encoding starts.
+     * @param name "avx2", "sse4.1" or "scalar"
+     * @return false if the name is unknown or the CPU does not support it
+     */
+    static bool set_instruction_set(const std::string& name);
+
 private:
     std::vector<double> coeffs_;
+    std::vector<float> coeffs_float_;
+    std::vector<int32_t> coeffs_fixed_;
+    int32_t fixed_shift_ = 0;
+    int32_t float_error_bound_ = 1;
+    int32_t fixed_error_bound_ = 1;
+    bool symmetric_ = false;
+    Precision precision_ = Precision::Exact;
 
     /**
      * @brief Internal filter application for double samples
      * Uses edge reflection padding to avoid amplitude distortion at boundaries
      */
-    void apply_internal(const double* input_data, double* output_data, int num_samples) const {
-        const int num_taps = static_cast<int>(coeffs_.size());
-        const int overlap = num_taps / 2;
-
-        // Create padded version with reflection at edges to avoid artifacts
-        thread_local std::vector<double> padded;
-        padded.resize(num_samples + 2 * overlap);
-        
-        // Reflect at left edge
-        for (int i = 0; i < overlap; ++i) {
-            padded[overlap - 1 - i] = input_data[i];
-        }
-        
-        // Copy center
-        for (int i = 0; i < num_samples; ++i) {
-            padded[overlap + i] = input_data[i];
-        }
-        
-        // Reflect at right edge
-        for (int i = 0; i < overlap; ++i) {
-            padded[overlap + num_samples + i] = input_data[num_samples - 2 - i];
-        }
-        
-        // Apply filter to entire padded signal
-        for (int i = 0; i < num_samples; ++i) {
-            double v = 0.0;
-            for (int j = 0; j < num_taps; ++j) {
-                v += coeffs_[j] * padded[i + j];
-            }
-            output_data[i] = v;
-        }
+    void apply_internal(const double* input_data, double* output_data, int num_samples) const;
+};
+
+/**
+ * @brief FIR filter with compile-time coefficients
+ * 
+ * Coeffs provides a constexpr std::array<double, N> named values. The tap
+ * loop is fully unrolled with the coefficients as constants, and the
+ * arithmetic matches FIRFilter's Exact precision bit for bit.
+ * 
+ * apply() is instantiated in fir_filter.cpp for the built-in coefficient
+ * sets below; user-supplied taps go through FIRFilter.
+ */
+template <size_t N, typename Coeffs>
+class FixedFIRFilter : public SampleFilter {
+    static_assert((N % 2) == 1, "FIR filters need an odd number of taps");
+    static_assert(Coeffs::values.size() == N, "coefficient count does not match N");
+
+public:
+    void apply(const uint16_t* input, uint16_t* output, int32_t num_samples) const override;
+
+    size_t num_taps() const override {
+        return N;
     }
 
     /**
-     * @brief Internal filter application converting to/from 16-bit
-     * Uses edge reflection padding to avoid amplitude distortion at boundaries
+     * @brief The filter coefficients
      */
-    void apply_internal_16bit(const double* input_double, uint16_t* output_data, int num_samples) const {
-        const int num_taps = static_cast<int>(coeffs_.size());
-        const int overlap = num_taps / 2;
-
-        // Create padded version with reflection at edges to avoid artifacts
-        thread_local std::vector<double> padded;
-        padded.resize(num_samples + 2 * overlap);
-        
-        // Reflect at left edge
-        for (int i = 0; i < overlap; ++i) {
-            padded[overlap - 1 - i] = input_double[i];
-        }
-        
-        // Copy center
-        for (int i = 0; i < num_samples; ++i) {
-            padded[overlap + i] = input_double[i];
-        }
-        
-        // Reflect at right edge
-        for (int i = 0; i < overlap; ++i) {
-            padded[overlap + num_samples + i] = input_double[num_samples - 2 - i];
-        }
-        
-        // Apply filter to entire padded signal
-        for (int i = 0; i < num_samples; ++i) {
-            double v = 0.0;
-            for (int j = 0; j < num_taps; ++j) {
-                v += coeffs_[j] * padded[i + j];
-            }
-            output_data[i] = static_cast<uint16_t>(v);
-        }
+    static constexpr const std::array<double, N>& coefficients() {
+        return Coeffs::values;
     }
 };
 
-/**
- * @brief Predefined filter configurations
- */
 namespace Filters {
 
     /**
-     * @brief Create a 1.3 MHz low-pass filter for PAL
+     * @brief PAL 1.3 MHz U/V low-pass coefficients
      * 
      * 13-tap Gaussian window filter generated by:
      * c = scipy.signal.gaussian(13, 1.52); c / sum(c)
@@ -177,8 +244,8 @@ namespace Filters {
      * Specifications: 0 dB @ 0 Hz, >= -3 dB @ 1.3 MHz, <= -20 dB @ 4.0 MHz
      * Reference: Clarke p8, Poynton p342
      */
-    inline FIRFilter create_pal_uv_filter() {
-        const std::vector<double> coeffs{
+    struct PalUVCoefficients {
+        static constexpr std::array<double, 13> values{{
             0.00010852890120228184,
             0.0011732778293138913,
             0.008227778710181127,
@@ -192,39 +259,110 @@ namespace Filters {
             0.008227778710181127,
             0.0011732778293138913,
             0.00010852890120228184
-        };
-        return FIRFilter(coeffs);
-    }
+        }};
+    };
 
     /**
-     * @brief Create a 1.3 MHz low-pass filter for NTSC
+     * @brief NTSC 1.3 MHz U/V (I/Q wideband) low-pass coefficients
      * 
-     * 9-tap filter for U/V (I/Q wideband) chroma components
      * Specifications: 0 dB @ 0 Hz, >= -2 dB @ 1.3 MHz, < -20 dB @ 3.6 MHz
      * Reference: Clarke p15, Poynton p342
      */
-    inline FIRFilter create_ntsc_uv_filter() {
-        const std::vector<double> coeffs{
+    struct NtscUVCoefficients {
+        static constexpr std::array<double, 9> values{{
             0.0021, 0.0191, 0.0903, 0.2308, 0.3153,
             0.2308, 0.0903, 0.0191, 0.0021
-        };
-        return FIRFilter(coeffs);
-    }
+        }};
+    };
 
     /**
-     * @brief Create a 0.6 MHz low-pass filter for NTSC Q channel
+     * @brief NTSC 0.6 MHz narrowband Q low-pass coefficients
      * 
-     * 23-tap filter for narrowband Q (I/Q) mode only
      * Specifications: 0 dB @ 0 Hz, >= -2 dB @ 0.4 MHz, >= -6 dB @ 0.5 MHz, <= -6 dB @ 0.6 MHz
      * Reference: Clarke p15
      */
-    inline FIRFilter create_ntsc_q_filter() {
-        const std::vector<double> coeffs{
+    struct NtscQCoefficients {
+        static constexpr std::array<double, 23> values{{
             0.0002, 0.0027, 0.0085, 0.0171, 0.0278, 0.0398, 0.0522, 0.0639, 0.0742, 0.0821, 0.0872,
             0.0889,
             0.0872, 0.0821, 0.0742, 0.0639, 0.0522, 0.0398, 0.0278, 0.0171, 0.0085, 0.0027, 0.0002
-        };
-        return FIRFilter(coeffs);
+        }};
+    };
+
+    using PalUVFilter = FixedFIRFilter<13, PalUVCoefficients>;
+    using NtscUVFilter = FixedFIRFilter<9, NtscUVCoefficients>;
+    using NtscQFilter = FixedFIRFilter<23, NtscQCoefficients>;
+
+} // namespace Filters
+
+extern template class FixedFIRFilter<13, Filters::PalUVCoefficients>;
+extern template class FixedFIRFilter<9, Filters::NtscUVCoefficients>;
+extern template class FixedFIRFilter<23, Filters::NtscQCoefficients>;
+
+/**
+ * @brief Predefined filter configurations
+ */
+namespace Filters {
+
+    /**
+     * @brief Create a 1.3 MHz low-pass filter for PAL (runtime taps)
+     */
+    inline FIRFilter create_pal_uv_filter() {
+        const auto& c = PalUVCoefficients::values;
+        return FIRFilter(std::vector<double>(c.begin(), c.end()));
+    }
+
+    /**
+     * @brief Create a 1.3 MHz low-pass filter for NTSC (runtime taps)
+     */
+    inline FIRFilter create_ntsc_uv_filter() {
+        const auto& c = NtscUVCoefficients::values;
+        return FIRFilter(std::vector<double>(c.begin(), c.end()));
+    }
+
+    /**
+     * @brief Create a 0.6 MHz low-pass filter for NTSC Q channel (runtime taps)
+     */
+    inline FIRFilter create_ntsc_q_filter() {
+        const auto& c = NtscQCoefficients::values;
+        return FIRFilter(std::vector<double>(c.begin(), c.end()));
+    }
+
+    /**
+     * @brief Pick the filter implementation for a built-in coefficient set
+     * 
+     * The compile-time specialisation is used for the default Exact
+     * precision; Float/Fixed precision and verification need the runtime
+     * FIRFilter.
+     */
+    template <typename Fixed>
+    std::unique_ptr<SampleFilter> make_filter(FIRFilter (*create_runtime)()) {
+        if (FIRFilter::default_precision() == FIRFilter::Precision::Exact &&
+            !FIRFilter::verification_enabled()) {
+            return std::make_unique<Fixed>();
+        }
+        return std::make_unique<FIRFilter>(create_runtime());
+    }
+
+    /**
+     * @brief Best available 1.3 MHz low-pass filter for PAL
+     */
+    inline std::unique_ptr<SampleFilter> make_pal_uv_filter() {
+        return make_filter<PalUVFilter>(create_pal_uv_filter);
+    }
+
+    /**
+     * @brief Best available 1.3 MHz low-pass filter for NTSC
+     */
+    inline std::unique_ptr<SampleFilter> make_ntsc_uv_filter() {
+        return make_filter<NtscUVFilter>(create_ntsc_uv_filter);
+    }
+
+    /**
+     * @brief Best available 0.6 MHz low-pass filter for the NTSC Q channel
+     */
+    inline std::unique_ptr<SampleFilter> make_ntsc_q_filter() {
+        return make_filter<NtscQFilter>(create_ntsc_q_filter);
     }
 
 } // namespace Filters
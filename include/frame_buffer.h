@@ -10,6 +10,7 @@
 #ifndef ENCODE_ORC_FRAME_BUFFER_H
 #define ENCODE_ORC_FRAME_BUFFER_H
 
+#include "buffer_pool.h"
 #include <cstdint>
 #include <vector>
 #include <stdexcept>
@@ -39,7 +40,7 @@ struct YUV444P16Pixel {
  * 
  * This class stores a single progressive frame of video data in RGB48 or YUV444P16 format.
  * The data layout is planar for YUV (Y plane, then U plane, then V plane) and
- * interleaved for RGB.
+ * interleaved for RGB, in 64-byte-aligned storage.
  */
 class FrameBuffer {
 public:
@@ -51,6 +52,18 @@ public:
         YUV444P16   // 16-bit YUV, planar (Y..., U..., V...)
     };
     
+    /**
+     * @brief Luma code range of the frame content
+     * 
+     * Studio frames carry 10-bit code values (Y ≤ 1023, including sub-black
+     * and overshoot); full-range frames use the whole 16-bit scale.
+     */
+    enum class SignalRange {
+        Unknown,    // Not classified yet
+        Studio,     // 10-bit studio code space (Y ≤ 1023)
+        Full        // Full 16-bit range
+    };
+    
     /**
      * @brief Construct an empty frame buffer
      */
@@ -90,12 +103,12 @@ public:
     /**
      * @brief Access raw data (mutable)
      */
-    std::vector<uint16_t>& data() { return data_; }
+    SampleVector& data() { return data_; }
     
     /**
      * @brief Access raw data (const)
      */
-    const std::vector<uint16_t>& data() const { return data_; }
+    const SampleVector& data() const { return data_; }
     
     /**
      * @brief Get pointer to raw data
@@ -117,11 +130,60 @@ public:
         width_ = width;
         height_ = height;
         format_ = format;
+        signal_range_ = SignalRange::Unknown;
         
         // For both RGB48 and YUV444P16, we need 3 components per pixel
         data_.resize(width * height * 3);
     }
     
+    /**
+     * @brief Get the cached signal range (Unknown until classified)
+     */
+    SignalRange signal_range() const { return signal_range_; }
+    
+    /**
+     * @brief Set the signal range when the producer already knows it
+     */
+    void set_signal_range(SignalRange range) { signal_range_ = range; }
+    
+    /**
+     * @brief Classify the frame content and cache the result
+     * 
+     * Loaders call this once after filling the frame so encoders never have to
+     * rescan it. Call again after modifying pixel data through data().
+     * @return The detected range
+     */
+    SignalRange update_signal_range() {
+        signal_range_ = detect_signal_range();
+        return signal_range_;
+    }
+    
+    /**
+     * @brief Scan the Y plane to classify the frame (does not update the cache)
+     */
+    SignalRange detect_signal_range() const {
+        if (format_ != Format::YUV444P16) {
+            return SignalRange::Full;
+        }
+        const size_t pixel_count = static_cast<size_t>(width_) * static_cast<size_t>(height_);
+        for (size_t i = 0; i < pixel_count; ++i) {
+            if (data_[i] > 1023) {
+                return SignalRange::Full;
+            }
+        }
+        return SignalRange::Studio;
+    }
+    
+    /**
+     * @brief Check whether the frame holds studio-range (10-bit) values
+     * 
+     * Uses the cached range; an unclassified frame is scanned on each call.
+     */
+    bool is_studio_range() const {
+        SignalRange range = (signal_range_ != SignalRange::Unknown) ? signal_range_ : detect_signal_range();
+        return range == SignalRange::Studio;
+    }
+    
     /**
      * @brief Set an RGB pixel
      * @param x Horizontal position (0-indexed)
@@ -205,7 +267,8 @@ private:
     int32_t width_ = 0;
     int32_t height_ = 0;
     Format format_ = Format::RGB48;
-    std::vector<uint16_t> data_;
+    SignalRange signal_range_ = SignalRange::Unknown;
+    SampleVector data_;
 };
 
 } // namespace encode_orc
@@ -0,0 +1,240 @@
+/*
+ * File:        frame_encode_pipeline.h
+ * Module:      encode-orc
+ * Purpose:     Multi-threaded frame encoding pipeline with in-order output
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_FRAME_ENCODE_PIPELINE_H
+#define ENCODE_ORC_FRAME_ENCODE_PIPELINE_H
+
+#include "buffer_pool.h"
+#include "field.h"
+#include "frame_buffer.h"
+#include "video_parameters.h"
+#include "source_video_standard.h"
+#include "metadata.h"
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Output of encoding one source frame
+ *
+ * In composite mode only @c composite is populated; in separate Y/C mode
+ * only the four Y/C fields are populated.
+ */
+struct EncodedFrame {
+    Frame composite;
+    Field y_field1;
+    Field c_field1;
+    Field y_field2;
+    Field c_field2;
+};
+
+/**
+ * @brief Encodes frames on a pool of worker threads and emits them in order
+ *
+ * Each worker owns its own PAL/NTSC encoder. Frames are submitted in output
+ * order by the calling thread, encoded out of order by the workers, and
+ * handed to the sink strictly in submission order (the sink always runs on
+ * the calling thread, so it needs no locking).
+ *
+ * With a thread count of 1 no workers are started and each frame is encoded
+ * inline inside submit().
+ *
+ * Worker encoders live as long as the pipeline. A pipeline can be re-run with
+ * start()/finish() any number of times, and configure() between runs
+ * reconfigures the existing encoders rather than rebuilding them.
+ *
+ * Still images are submitted with repeated_frame set. Because the encoded
+ * signal depends on the field number only through the colour sequence
+ * position and the VBI/VITC lines, each worker keeps the frames it has
+ * encoded for each sequence position and replays them with just those lines
+ * refreshed.
+ *
+ * Encoded frames come from a BufferPool and are encoded in place, and the
+ * job queue and reorder window are fixed rings, so once every buffer has
+ * been used once the encode loop makes no heap allocations.
+ *
+ * A frame's VBI is copied into its job, so it need not outlive submit().
+ * A submitted FrameBuffer (other than a repeated one) may be reused once
+ * max_in_flight() further frames have been submitted, so streamed sources
+ * only need a ring of max_in_flight() + 1 buffers.
+ */
+class FrameEncodePipeline {
+public:
+    /**
+     * @brief Receives encoded frames in order; return false to abort
+     */
+    using FrameSink = std::function<bool(const EncodedFrame& frame)>;
+
+    /**
+     * @brief Construct a pipeline
+     * @param params Video parameters (system selects the PAL or NTSC encoder)
+     * @param source_standard Source video standard applied to every worker encoder
+     * @param enable_chroma_filter Enable chroma low-pass filter
+     * @param enable_luma_filter Enable luma low-pass filter
+     * @param separate_yc Produce separate Y/C fields instead of composite
+     * @param num_threads Worker count (0 = one per hardware thread)
+     */
+    FrameEncodePipeline(const VideoParameters& params,
+                        SourceVideoStandard source_standard,
+                        bool enable_chroma_filter,
+                        bool enable_luma_filter,
+                        bool separate_yc,
+                        int32_t num_threads);
+
+    ~FrameEncodePipeline();
+
+    FrameEncodePipeline(const FrameEncodePipeline&) = delete;
+    FrameEncodePipeline& operator=(const FrameEncodePipeline&) = delete;
+
+    /**
+     * @brief Change encoder settings for the next run
+     * @param params Video parameters (system selects the PAL or NTSC encoder)
+     * @param source_standard Source video standard applied to every worker encoder
+     * @param enable_chroma_filter Enable chroma low-pass filter
+     * @param enable_luma_filter Enable luma low-pass filter
+     * @param separate_yc Produce separate Y/C fields instead of composite
+     */
+    void configure(const VideoParameters& params,
+                   SourceVideoStandard source_standard,
+                   bool enable_chroma_filter,
+                   bool enable_luma_filter,
+                   bool separate_yc);
+
+    /**
+     * @brief Split each field's active lines across threads, per worker
+     * @param line_threads Threads per field, including the worker (1 = serial)
+     *
+     * Meant for low-latency single-frame encodes (one worker); applied at
+     * the next start().
+     */
+    void set_line_threads(int32_t line_threads) { line_threads_ = line_threads; }
+
+    /**
+     * @brief Start the workers
+     * @param sink Callback receiving each encoded frame in submission order
+     */
+    void start(FrameSink sink);
+
+    /**
+     * @brief Queue a frame for encoding
+     *
+     * Blocks while the reorder window is full, writing completed frames to the
+     * sink as they become available.
+     *
+     * @param frame_buffer Source frame in YUV444P16 format
+     * @param field_number First field number of the frame
+     * @param frame_vbi Optional VBI data for the frame's two fields (nullptr to
+     *        skip VBI); copied, so it need not outlive the call
+     * @param repeated_frame true when every frame of this run uses the same
+     *        frame_buffer (a still image); workers then encode each colour
+     *        sequence position once and only refresh the VBI/VITC lines after that
+     * @return true on success, false if encoding or the sink failed
+     */
+    bool submit(const FrameBuffer& frame_buffer, int32_t field_number,
+                const FrameVBI* frame_vbi = nullptr, bool repeated_frame = false);
+
+    /**
+     * @brief Wait for all queued frames to be written and stop the workers
+     * @return true on success, false if encoding or the sink failed
+     */
+    bool finish();
+
+    /**
+     * @brief Number of encoding threads in use
+     */
+    int32_t num_threads() const { return num_threads_; }
+    
+    /**
+     * @brief Maximum number of submitted frames not yet handed to the sink
+     */
+    size_t max_in_flight() const { return max_in_flight_; }
+
+    /**
+     * @brief Counts of the encoded-frame pool (peak is the number of frames
+     *        the pipeline needed at once)
+     */
+    BufferPoolStats buffer_stats() const { return frame_pool_.stats(); }
+
+    /**
+     * @brief Get error message from the first failure
+     */
+    const std::string& get_error() const { return error_message_; }
+
+    /**
+     * @brief Resolve a requested thread count (0 = hardware concurrency)
+     */
+    static int32_t resolve_thread_count(int32_t requested);
+
+private:
+    struct Job {
+        int64_t sequence;
+        const FrameBuffer* frame_buffer;
+        int32_t field_number;
+        std::optional<FrameVBI> vbi;
+        bool repeated_frame;
+
+        const FrameVBI* frame_vbi() const { return vbi ? &*vbi : nullptr; }
+    };
+
+    class Worker;
+    using FrameHandle = BufferPool<EncodedFrame>::Handle;
+
+    VideoParameters params_;
+    SourceVideoStandard source_standard_;
+    bool enable_chroma_filter_;
+    bool enable_luma_filter_;
+    bool separate_yc_;
+    int32_t num_threads_;
+    int32_t line_threads_ = 1;
+    size_t max_in_flight_;
+
+    FrameSink sink_;
+    std::string error_message_;
+
+    // One encoder per thread, reused across runs
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Encoded frames, recycled once the sink has written them (declared
+    // before anything holding a handle)
+    BufferPool<EncodedFrame> frame_pool_;
+
+    // Inline (single-threaded) state
+    bool inline_ = false;
+
+    // Threaded state (guarded by mutex_)
+    std::mutex mutex_;
+    std::condition_variable job_ready_;
+    std::condition_variable result_ready_;
+    std::vector<Job> jobs_;             // Ring of max_in_flight_ queued jobs
+    size_t jobs_head_ = 0;
+    size_t jobs_count_ = 0;
+    std::vector<FrameHandle> results_;  // Reorder window, indexed by sequence % max_in_flight_
+    int64_t next_sequence_ = 0;
+    int64_t next_write_ = 0;
+    bool stopping_ = false;
+    bool failed_ = false;
+    std::vector<std::thread> threads_;
+
+    void worker_loop(Worker& worker);
+    bool write_ready(std::unique_lock<std::mutex>& lock, bool block);
+    void fail_locked(const std::string& message);
+    void stop_workers();
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_FRAME_ENCODE_PIPELINE_H
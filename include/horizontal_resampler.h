@@ -0,0 +1,120 @@
+/*
+ * File:        horizontal_resampler.h
+ * Module:      encode-orc
+ * Purpose:     Maps source pixels onto the 4fSC active line
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_HORIZONTAL_RESAMPLER_H
+#define ENCODE_ORC_HORIZONTAL_RESAMPLER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Resamples a line of source pixels to the active line width
+ *
+ * The encoders map e.g. 720 source pixels onto 922 (PAL) or 760 (NTSC)
+ * active samples. Every lookup is precomputed when the resampler is
+ * built, so resampling a line is a table walk with no per-sample
+ * float-to-int conversion or clamping.
+ *
+ * Two modes are available:
+ * - Nearest: each sample repeats the source pixel it falls in, the same
+ *   mapping the encoders have always used
+ * - Polyphase: band-limited interpolation with an 8-tap Lanczos kernel.
+ *   The source/output ratio reduces to L output samples per M source
+ *   pixels, so only L distinct kernels (phases) exist; they are built
+ *   once and the inner loop is vectorised (AVX2 where available)
+ */
+class HorizontalResampler {
+public:
+    /**
+     * @brief Resampling method
+     */
+    enum class Mode {
+        Nearest,
+        Polyphase
+    };
+
+    /// Kernel length of the polyphase mode
+    static constexpr int32_t POLYPHASE_TAPS = 8;
+
+    /**
+     * @brief Build the resampling tables
+     * @param source_width Source pixels per line
+     * @param output_width Output samples per line
+     * @param mode Resampling method
+     */
+    HorizontalResampler(int32_t source_width, int32_t output_width, Mode mode);
+
+    /**
+     * @brief Resample one line
+     * @param input source_width() samples
+     * @param output output_width() samples (must not overlap input)
+     */
+    void apply(const uint16_t* input, uint16_t* output) const;
+
+    /**
+     * @brief Source pixels per line
+     */
+    int32_t source_width() const { return source_width_; }
+
+    /**
+     * @brief Output samples per line
+     */
+    int32_t output_width() const { return output_width_; }
+
+    /**
+     * @brief Resampling method
+     */
+    Mode mode() const { return mode_; }
+
+    /**
+     * @brief Number of distinct kernels (output samples per repeat of the ratio)
+     */
+    int32_t num_phases() const { return num_phases_; }
+
+    /**
+     * @brief Check if the resampler was built for these widths and mode
+     */
+    bool matches(int32_t source_width, int32_t output_width, Mode mode) const {
+        return source_width_ == source_width && output_width_ == output_width && mode_ == mode;
+    }
+
+    /**
+     * @brief Mode used by the encoders (default: Nearest)
+     *
+     * Set once at startup, before any encoding starts.
+     */
+    static void set_default_mode(Mode mode);
+
+    /**
+     * @brief Mode used by the encoders
+     */
+    static Mode default_mode();
+
+private:
+    int32_t source_width_;
+    int32_t output_width_;
+    Mode mode_;
+    int32_t num_phases_ = 1;
+
+    // Nearest: source pixel of each output sample.
+    // Polyphase: first tap of each output sample in the padded line.
+    std::vector<int32_t> index_;
+
+    // Polyphase weights, tap-major (weights_[tap * output_width_ + sample])
+    // so the vector loop loads them contiguously
+    std::vector<float> weights_;
+
+    void apply_polyphase(const uint16_t* input, uint16_t* output) const;
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_HORIZONTAL_RESAMPLER_H
@@ -0,0 +1,192 @@
+/*
+ * File:        line_modulator.h
+ * Module:      encode-orc
+ * Purpose:     Converts resampled Y/U/V (Y/I/Q) lines into luma and chroma levels
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_LINE_MODULATOR_H
+#define ENCODE_ORC_LINE_MODULATOR_H
+
+#include "subcarrier_table.h"
+#include "video_parameters.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Per-sample level conversion and subcarrier modulation of a line
+ *
+ * Takes one active line of resampled samples and works out every sample's
+ * luma level and its chroma, U·sin + V·cos of the subcarrier (I/Q for
+ * NTSC) scaled to the luma range. Two precisions are available:
+ * - Exact: double precision, the arithmetic the encoders have always used
+ * - Fixed: integer only. 10-bit studio codes go through lookup tables of
+ *   their luma level and chroma amplitudes, full-range samples through
+ *   fixed-point scale factors, and the subcarrier is Q15. The modulation
+ *   loop is vectorised (AVX2 or SSE4.1, picked at runtime from the CPU,
+ *   with a portable scalar fallback that gives identical results)
+ *
+ * Fixed stays within error_bound() of Exact. With verification enabled
+ * every line is also run through the Exact path and checked against that
+ * bound.
+ */
+class LineModulator {
+public:
+    /**
+     * @brief Arithmetic used by modulate()
+     */
+    enum class Precision {
+        Exact,
+        Fixed
+    };
+
+    /**
+     * @brief Build the tables for a signal format
+     * @param params Video parameters (levels and active line)
+     * @param subcarrier Subcarrier phase for the same signal format
+     * @param u_max Peak of the first colour-difference signal (U or I)
+     * @param v_max Peak of the second colour-difference signal (V or Q)
+     */
+    LineModulator(const VideoParameters& params,
+                  std::shared_ptr<const SubcarrierTable> subcarrier,
+                  double u_max, double v_max);
+
+    /**
+     * @brief Work out the luma and chroma levels of an active line
+     * @param y Luma samples (active width entries)
+     * @param u First colour-difference samples (U or I)
+     * @param v Second colour-difference samples (V or Q)
+     * @param studio_range_input true for 10-bit studio codes (chroma 0-896), false for 0-65535
+     * @param line_phase Subcarrier phase of the line
+     * @param luma Output luma levels
+     * @param chroma Output chroma levels (centred on zero)
+     * @throws std::runtime_error if verification is enabled and the result
+     *         is outside error_bound()
+     */
+    void modulate(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                  bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                  int32_t* luma, int32_t* chroma) const;
+
+    /**
+     * @brief Work out the levels with the double-precision reference
+     *
+     * Same parameters as modulate().
+     */
+    void modulate_reference(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                            bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                            int32_t* luma, int32_t* chroma) const;
+
+    /**
+     * @brief Largest luma or chroma difference from the reference for this precision
+     * @return 0 for Exact, otherwise a bound in 16-bit sample units
+     */
+    int32_t error_bound() const;
+
+    /**
+     * @brief Arithmetic used by modulate()
+     *
+     * Fixed falls back to Exact for levels too large for its 32-bit
+     * arithmetic (white - black close to the full 16-bit range).
+     */
+    Precision precision() const { return precision_; }
+
+    /**
+     * @brief Check if the modulator was built for this signal format
+     */
+    bool matches(const VideoParameters& params) const {
+        return params_.has_same_signal_format(params);
+    }
+
+    /**
+     * @brief Precision given to newly constructed modulators (default: Exact)
+     *
+     * Set once at startup, before any encoding starts.
+     */
+    static void set_default_precision(Precision precision);
+
+    /**
+     * @brief Precision given to newly constructed modulators
+     */
+    static Precision default_precision();
+
+    /**
+     * @brief Check every modulated line against the reference path
+     *
+     * Set once at startup, before any encoding starts.
+     */
+    static void set_verification(bool enabled);
+
+    /**
+     * @brief Check if verification is enabled
+     */
+    static bool verification_enabled();
+
+    /**
+     * @brief Name of the instruction set the fixed-point kernel dispatches to
+     * @return "avx2", "sse4.1" or "scalar"
+     */
+    static const char* instruction_set();
+
+    /**
+     * @brief Run the fixed-point kernel on a lower instruction set than the CPU's best
+     *
+     * For tests that compare the kernels with each other. Set before any
+     * encoding starts.
+     * @param name "avx2", "sse4.1" or "scalar"
+     * @return false if the name is unknown or the CPU does not support it
+     */
+    static bool set_instruction_set(const std::string& name);
+
+private:
+    VideoParameters params_;
+    std::shared_ptr<const SubcarrierTable> subcarrier_;
+    double u_max_;
+    double v_max_;
+    int32_t active_start_;
+    int32_t active_width_;
+    int32_t black_level_;
+    int32_t luma_range_;
+    Precision precision_ = Precision::Exact;
+    int32_t fixed_error_bound_ = 1;
+
+    // Studio range: luma level and chroma amplitudes of each 10-bit code
+    std::vector<int32_t> studio_luma_;
+    std::vector<int32_t> studio_u_;
+    std::vector<int32_t> studio_v_;
+
+    // Full range: luma = black + (y * scale) >> 16 and
+    // amplitude = ((x - 32768) * scale + offset) >> 15
+    uint32_t full_luma_scale_ = 0;
+    int32_t full_u_scale_ = 0;
+    int32_t full_u_offset_ = 0;
+    int32_t full_v_scale_ = 0;
+    int32_t full_v_offset_ = 0;
+
+    // Q15 sin/cos of the phase advance to each active sample
+    std::vector<int32_t> sample_sin_;
+    std::vector<int32_t> sample_cos_;
+
+    /**
+     * @brief Build the fixed-point tables
+     * @return false if the levels do not fit the fixed-point arithmetic
+     */
+    bool build_fixed_tables();
+
+    void modulate_fixed(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                        bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                        int32_t* luma, int32_t* chroma) const;
+
+    void verify(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                const int32_t* luma, const int32_t* chroma) const;
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_LINE_MODULATOR_H
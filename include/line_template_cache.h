@@ -0,0 +1,87 @@
+/*
+ * File:        line_template_cache.h
+ * Module:      encode-orc
+ * Purpose:     Cache of the fixed sync, blanking and burst lines of a field
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_LINE_TEMPLATE_CACHE_H
+#define ENCODE_ORC_LINE_TEMPLATE_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Lines that only depend on the line number and colour-sequence position
+ *
+ * Vertical sync, blanking with sync and burst, and the chroma burst lines of
+ * the Y/C output are the same every time a (line, field in the colour
+ * sequence) pair comes round. Each line is generated once, on first use,
+ * and copied into the field after that.
+ *
+ * A template is stored as the samples up to the last change plus the level
+ * that fills the rest of the line, so the mostly flat lines stay small.
+ *
+ * Not thread-safe: each encoder owns its caches, and rebuilds them when the
+ * signal format (including the video levels) changes. Once prepare() has
+ * run for a field, copy() of that field's lines (within the field) only
+ * reads the cache and may be called from several threads at once.
+ */
+class LineTemplateCache {
+public:
+    /**
+     * @brief Writes one template line
+     *
+     * Called with a zero-filled line of the cache's width, a line number and
+     * a field number within the colour sequence.
+     */
+    using Generator = std::function<void(uint16_t* line_buffer, int32_t line_number, int32_t field_number)>;
+
+    /**
+     * @brief Create an empty cache
+     * @param line_width Samples per line
+     * @param num_lines Lines per field
+     * @param sequence_fields Fields before the lines repeat (the colour sequence)
+     * @param generator Writes a template line
+     */
+    LineTemplateCache(int32_t line_width, int32_t num_lines, int32_t sequence_fields, Generator generator);
+
+    /**
+     * @brief Copy a line's template, generating it on first use
+     * @param line_buffer Destination (line_width samples)
+     * @param line_number Line number within the field (0-based)
+     * @param field_number Field number (any non-negative value)
+     */
+    void copy(uint16_t* line_buffer, int32_t line_number, int32_t field_number);
+
+    /**
+     * @brief Generate every template of a field that is not built yet
+     * @param field_number Field number (any non-negative value)
+     */
+    void prepare(int32_t field_number);
+
+private:
+    struct Template {
+        std::vector<uint16_t> head;   // Samples up to the last change
+        uint16_t tail = 0;            // Level of the rest of the line
+        bool built = false;
+    };
+
+    int32_t line_width_;
+    int32_t num_lines_;
+    int32_t sequence_fields_;
+    Generator generator_;
+    std::vector<Template> templates_;   // [field in sequence][line]
+    std::vector<uint16_t> scratch_;
+
+    void build(Template& entry, int32_t line_number, int32_t sequence_field);
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_LINE_TEMPLATE_CACHE_H
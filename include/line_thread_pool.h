@@ -0,0 +1,87 @@
+/*
+ * File:        line_thread_pool.h
+ * Module:      encode-orc
+ * Purpose:     Threads that share out the lines of a single field
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_LINE_THREAD_POOL_H
+#define ENCODE_ORC_LINE_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Runs a per-line function over a range of lines on several threads
+ *
+ * Used by the encoders to split the active lines of one field, so a single
+ * field (for example a preview of field N) comes back in a fraction of a
+ * serial pass. Lines are handed out one at a time from a shared counter and
+ * the calling thread works alongside the pool's threads; the threads stay
+ * parked between runs.
+ *
+ * The line function must only touch state that is per line or read-only
+ * (per-thread scratch buffers are fine). run() is not re-entrant: one
+ * range at a time per pool.
+ */
+class LineThreadPool {
+public:
+    /**
+     * @brief Start the threads
+     * @param num_threads Threads working on a range, including the caller (at least 2)
+     */
+    explicit LineThreadPool(int32_t num_threads);
+
+    ~LineThreadPool();
+
+    LineThreadPool(const LineThreadPool&) = delete;
+    LineThreadPool& operator=(const LineThreadPool&) = delete;
+
+    /**
+     * @brief Threads working on a range, including the caller
+     */
+    int32_t num_threads() const { return static_cast<int32_t>(threads_.size()) + 1; }
+
+    /**
+     * @brief Call line_function(line) for every line in [begin, end) and wait for all of them
+     * @param begin First line
+     * @param end One past the last line
+     * @param line_function Work for one line
+     * @throws The first exception thrown by line_function; the remaining
+     *         lines are skipped
+     */
+    void run(int32_t begin, int32_t end, const std::function<void(int32_t line)>& line_function);
+
+private:
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable work_done_;
+    uint64_t generation_ = 0;   // Bumped for every run()
+    int32_t busy_ = 0;          // Pool threads still working on this run
+    bool stopping_ = false;
+    std::exception_ptr error_;
+
+    // The current range, set by run() before the threads are woken
+    const std::function<void(int32_t)>* line_function_ = nullptr;
+    std::atomic<int32_t> next_line_{0};
+    int32_t end_line_ = 0;
+
+    void thread_loop();
+    void work();
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_LINE_THREAD_POOL_H
@@ -106,6 +106,56 @@ private:
                           uint16_t level);
 };
 
+/**
+ * @brief Precomputed Manchester bit cells for one bit layout
+ * 
+ * Renders the '0' and '1' cells once with ManchesterEncoder::render_bit()
+ * and afterwards copies them straight into the caller's line buffer, so
+ * rendering a code needs no allocation and no trigonometry. The output is
+ * identical to ManchesterEncoder::render_bits().
+ */
+class ManchesterBitCells {
+public:
+    /**
+     * @brief Build the '0' and '1' cells
+     * @param samples_per_bit Samples allocated per bit cell
+     * @param low_level Voltage level for "low" state (16-bit value)
+     * @param high_level Voltage level for "high" state (16-bit value)
+     * @param rise_fall_samples Number of samples for transition ramps (0 = instantaneous)
+     */
+    ManchesterBitCells(int32_t samples_per_bit,
+                       uint16_t low_level,
+                       uint16_t high_level,
+                       int32_t rise_fall_samples);
+
+    /**
+     * @brief Render the low bits of a value, most significant first
+     * @param value Bits to render
+     * @param num_bits Number of bits to render (1-32)
+     * @param bit_start_pos Sample position where the first bit begins
+     * @param line_buffer Output buffer to render into
+     * @param buffer_size Total size of line_buffer
+     */
+    void render(uint32_t value,
+                int32_t num_bits,
+                int32_t bit_start_pos,
+                uint16_t* line_buffer,
+                int32_t buffer_size) const;
+
+    /**
+     * @brief Samples allocated per bit cell
+     */
+    int32_t samples_per_bit() const { return samples_per_bit_; }
+
+private:
+    int32_t samples_per_bit_;
+    uint16_t low_level_;
+    uint16_t high_level_;
+    int32_t rise_fall_samples_;
+    bool self_contained_;            // Every bit stays within its own cell
+    std::vector<uint16_t> cells_;    // '0' cell followed by the '1' cell
+};
+
 } // namespace encode_orc
 
 #endif // ENCODE_ORC_MANCHESTER_ENCODER_H
@@ -70,6 +70,14 @@ struct VBIData {
     int32_t vbi2 = 0;   // VBI line 18 data
 };
 
+/**
+ * @brief VBI data for the two fields of a frame, as handed to the encoders
+ */
+struct FrameVBI {
+    VBIData field1;
+    VBIData field2;
+};
+
 /**
  * @brief Dropout location matching ld-decode's drop_outs table
  */
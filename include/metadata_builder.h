@@ -0,0 +1,77 @@
+/*
+ * File:        metadata_builder.h
+ * Module:      encode-orc
+ * Purpose:     Project metadata with support for CAV, CLV chapter, and CLV timecode modes
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_METADATA_BUILDER_H
+#define ENCODE_ORC_METADATA_BUILDER_H
+
+#include "video_parameters.h"
+#include "yaml_config.h"
+#include "output_plan.h"
+#include "metadata.h"
+#include "vbi_schedule.h"
+#include <string>
+#include <cstdint>
+
+namespace encode_orc {
+
+/**
+ * @brief Metadata for a whole project, built once before encoding
+ *
+ * The VBI of every field comes from vbi_schedule(), which follows the
+ * section configuration (continuous timecode/chapter progression across
+ * all sections). The encoders render the biphase lines from the same
+ * schedule that write() stores in the .db, so the two can never disagree.
+ *
+ * Field numbers are absolute positions in the output, as laid out by the
+ * OutputPlan. The builder is read-only once built, so any number of
+ * encoders (for example one per parallel section) may share it.
+ */
+class MetadataBuilder {
+public:
+    /**
+     * @brief Build the capture and per-field metadata for a project
+     * @param config YAML project configuration with all sections
+     * @param system Video system (PAL or NTSC)
+     * @param plan Output plan for the project's sections
+     * @param error_message Output parameter for error description
+     * @return true on success, false on error
+     */
+    bool build(const YAMLProjectConfig& config,
+               VideoSystem system,
+               const OutputPlan& plan,
+               std::string& error_message);
+
+    /**
+     * @brief VBI of every field of the project
+     */
+    const VBISchedule& vbi_schedule() const { return vbi_schedule_; }
+
+    /**
+     * @brief Write the metadata database
+     *
+     * The database is on disk when this returns.
+     * @param output_db Path to output metadata database file (replaced if it exists)
+     * @param error_message Output parameter for error description
+     * @return true on success, false on error
+     */
+    bool write(const std::string& output_db, std::string& error_message) const;
+
+    /**
+     * @brief The metadata written by write()
+     */
+    const CaptureMetadata& metadata() const { return metadata_; }
+
+private:
+    CaptureMetadata metadata_;
+    VBISchedule vbi_schedule_;
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_METADATA_BUILDER_H
@@ -11,7 +11,10 @@
 #define ENCODE_ORC_METADATA_WRITER_H
 
 #include "metadata.h"
+#include "vbi_schedule.h"
 #include <sqlite3.h>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <memory>
 
@@ -22,6 +25,12 @@ namespace encode_orc {
  * 
  * Implements the ld-decode metadata schema for storing field-level
  * and capture-level metadata.
+ * 
+ * write_metadata() is a bulk write: every table is filled inside one
+ * transaction, and each table's INSERT is prepared once and re-run with
+ * bound parameters for every row, so a long capture costs three statement
+ * parses rather than one per row. The database is a fresh file written in
+ * one go, so by default it runs without a journal or fsync.
  */
 class MetadataWriter {
 public:
@@ -42,12 +51,38 @@ public:
     MetadataWriter& operator=(const MetadataWriter&) = delete;
     
     /**
-     * @brief Open/create a metadata database file
+     * @brief Rollback journal of the database while it is written
+     */
+    enum class JournalMode {
+        OFF,      // No journal (the file is written once, start to finish)
+        WAL,      // Write-ahead log
+        DELETE    // SQLite default rollback journal
+    };
+    
+    /**
+     * @brief Connection settings applied when the database is opened
+     */
+    struct Options {
+        JournalMode journal_mode = JournalMode::OFF;
+        bool synchronous = false;          // fsync on commit
+        int32_t cache_size_kib = 65536;    // Page cache size
+    };
+    
+    /**
+     * @brief Open/create a metadata database file with the default Options
      * @param filename Path to .tbc.db file to create
      * @return true on success, false on failure
      */
     bool open(const std::string& filename);
     
+    /**
+     * @brief Open/create a metadata database file
+     * @param filename Path to .tbc.db file to create
+     * @param options Journal, sync and cache settings
+     * @return true on success, false on failure
+     */
+    bool open(const std::string& filename, const Options& options);
+    
     /**
      * @brief Close the database
      */
@@ -67,6 +102,17 @@ public:
      */
     bool write_metadata(const CaptureMetadata& metadata);
     
+    /**
+     * @brief Write capture metadata, taking the vbi table from a VBI schedule
+     * 
+     * metadata.vbi_data is ignored; each field's VBI is computed from
+     * @p vbi_schedule as its row is written.
+     * @param metadata Capture metadata structure
+     * @param vbi_schedule VBI of every field
+     * @return true on success, false on failure
+     */
+    bool write_metadata(const CaptureMetadata& metadata, const VBISchedule& vbi_schedule);
+    
     /**
      * @brief Get last error message
      */
@@ -90,16 +136,41 @@ private:
      */
     bool write_fields(const CaptureMetadata& metadata);
     
+    /**
+     * @brief Supplies the VBI of a field (false if the field has none)
+     */
+    using FieldVBISource = std::function<bool(int64_t field_id, VBIData& vbi)>;
+    
+    /**
+     * @brief Write every table in one transaction
+     */
+    bool write_all(const CaptureMetadata& metadata, const FieldVBISource& field_vbi);
+    
     /**
      * @brief Write vbi table
      */
-    bool write_vbi(const CaptureMetadata& metadata);
+    bool write_vbi(const CaptureMetadata& metadata, const FieldVBISource& field_vbi);
     
     /**
      * @brief Execute SQL statement
      */
     bool execute_sql(const char* sql);
     
+    struct StatementDeleter {
+        void operator()(sqlite3_stmt* statement) const { sqlite3_finalize(statement); }
+    };
+    using Statement = std::unique_ptr<sqlite3_stmt, StatementDeleter>;
+    
+    /**
+     * @brief Compile a statement for repeated use (null on error)
+     */
+    Statement prepare(const char* sql);
+    
+    /**
+     * @brief Run a bound statement and reset it for the next row
+     */
+    bool step(sqlite3_stmt* statement);
+    
     sqlite3* db_;
     std::string error_message_;
 };
@@ -13,6 +13,7 @@
 #include "frame_buffer.h"
 #include "video_parameters.h"
 #include "video_loader_base.h"
+#include <cstdio>
 #include <string>
 #include <vector>
 #include <memory>
@@ -26,7 +27,9 @@ namespace encode_orc {
  * and converts them to YUV444P16 frame buffers for video encoding.
  * 
  * Uses ffmpeg command-line tool to decode video frames to raw YUV422P10LE format,
- * which is then converted to YUV444P16 for the encoder.
+ * which is read from ffmpeg's stdout and converted to YUV444P16 for the encoder.
+ * Frames can be loaded all at once or streamed (see
+ * VideoLoaderBase::start_stream()), which keeps only a few frames in memory.
  * 
  * Supported formats:
  * - v210 (10-bit 4:2:2 YUV uncompressed)
@@ -35,6 +38,9 @@ namespace encode_orc {
  */
 class MOVLoader : public VideoLoaderBase {
 public:
+    MOVLoader() = default;
+    ~MOVLoader() override;
+    
     /**
      * @brief Open a MOV file and prepare for frame extraction
      * 
@@ -117,9 +123,22 @@ public:
      */
     bool is_open() const override { return is_open_; }
 
+protected:
+    bool open_frame_stream(int32_t start_frame, int32_t num_frames,
+                           std::string& error_message) override;
+    bool read_stream_frame(FrameBuffer& frame, bool& end_of_stream,
+                           std::string& error_message) override;
+    bool close_frame_stream(bool complete, std::string& error_message) override;
+
 private:
     std::string filename_;
-
+    
+    // Width of the frames ffmpeg actually outputs (0 = not probed yet)
+    int32_t output_width_ = 0;
+    
+    // Running ffmpeg stream and its per-frame read buffer
+    FILE* stream_pipe_ = nullptr;
+    std::vector<uint8_t> stream_data_;
     
     /**
      * @brief Get video information using ffprobe
@@ -130,18 +149,29 @@ private:
     bool probe_video_info(std::string& error_message);
     
     /**
-     * @brief Extract frames using ffmpeg to temporary YUV file
+     * @brief Build the ffmpeg command that decodes a frame range to raw YUV422P10LE
      * 
      * @param start_frame Starting frame number
      * @param num_frames Number of frames
-     * @param temp_yuv_file Path to temporary YUV file
-     * @param error_message Error message if extraction fails
+     * @return Shell command line writing the frames to stdout
+     */
+    std::string build_ffmpeg_command(int32_t start_frame, int32_t num_frames) const;
+    
+    /**
+     * @brief Find the width ffmpeg outputs by decoding a single frame
+     * 
+     * ffmpeg may apply crop metadata, so the decoded width can differ from
+     * the width reported by ffprobe.
+     * 
+     * @param error_message Error message if the probe fails
      * @return true on success, false on error
      */
-    bool extract_frames_to_yuv(int32_t start_frame,
-                               int32_t num_frames,
-                               const std::string& temp_yuv_file,
-                               std::string& error_message);
+    bool probe_output_width(std::string& error_message);
+    
+    /**
+     * @brief Size in bytes of one YUV422P10LE frame
+     */
+    size_t yuv_frame_size(int32_t width) const;
     
     /**
      * @brief Convert YUV422P10LE planar data to YUV444P16 frame buffer
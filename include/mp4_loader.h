@@ -13,6 +13,7 @@
 #include "frame_buffer.h"
 #include "video_parameters.h"
 #include "video_loader_base.h"
+#include <cstdio>
 #include <string>
 #include <vector>
 #include <memory>
@@ -26,15 +27,15 @@ namespace encode_orc {
  * and converts them to YUV444P16 frame buffers for video encoding.
  * 
  * Uses ffmpeg command-line tool to decode video frames to raw YUV420P format,
- * which is then converted to YUV444P16 for the encoder.
- * 
- * Supported formats:
- * - H.264/AVC encoded MP4 files
- * - H.265/HEVC encoded MP4 files
- * - Any other codec supported by ffmpeg that can be decoded to YUV420P
+ * which is read from ffmpeg's stdout and converted to YUV444P16 for the encoder.
+ * Frames can be loaded all at once or streamed (see
+ * VideoLoaderBase::start_stream()), which keeps only a few frames in memory.
  */
 class MP4Loader : public VideoLoaderBase {
 public:
+    MP4Loader() = default;
+    ~MP4Loader() override;
+    
     /**
      * @brief Open an MP4 file and prepare for frame extraction
      * 
@@ -117,9 +118,19 @@ public:
      */
     bool is_open() const override { return is_open_; }
 
+protected:
+    bool open_frame_stream(int32_t start_frame, int32_t num_frames,
+                           std::string& error_message) override;
+    bool read_stream_frame(FrameBuffer& frame, bool& end_of_stream,
+                           std::string& error_message) override;
+    bool close_frame_stream(bool complete, std::string& error_message) override;
+
 private:
     std::string filename_;
-
+    
+    // Running ffmpeg stream and its per-frame read buffer
+    FILE* stream_pipe_ = nullptr;
+    std::vector<uint8_t> stream_data_;
     
     /**
      * @brief Get video information using ffprobe
@@ -130,18 +141,13 @@ private:
     bool probe_video_info(std::string& error_message);
     
     /**
-     * @brief Extract frames using ffmpeg to temporary YUV file
+     * @brief Build the ffmpeg command that decodes a frame range to raw YUV420P
      * 
      * @param start_frame Starting frame number
      * @param num_frames Number of frames
-     * @param temp_yuv_file Path to temporary YUV file
-     * @param error_message Error message if extraction fails
-     * @return true on success, false on error
+     * @return Shell command line writing the frames to stdout
      */
-    bool extract_frames_to_yuv(int32_t start_frame,
-                               int32_t num_frames,
-                               const std::string& temp_yuv_file,
-                               std::string& error_message);
+    std::string build_ffmpeg_command(int32_t start_frame, int32_t num_frames) const;
     
     /**
      * @brief Convert YUV420P planar data to YUV444P16 frame buffer
@@ -11,7 +11,10 @@
 #define ENCODE_ORC_NTSC_VITS_GENERATOR_H
 
 #include "video_parameters.h"
+#include "subcarrier_table.h"
+#include "vits_line_cache.h"
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <cmath>
 
@@ -65,6 +68,16 @@ public:
 
 private:
     VideoParameters params_;
+    std::shared_ptr<const SubcarrierTable> subcarrier_;
+    
+    // Test signals, as indices into the rendered line cache
+    static constexpr int32_t VIR = 0;
+    static constexpr int32_t NTC7_COMPOSITE = 1;
+    static constexpr int32_t NTC7_COMBINATION = 2;
+    static constexpr int32_t NUM_SIGNALS = 3;
+    
+    // Rendered test signals by colour-sequence position
+    VITSLineCache lines_;
     
     // NTSC-specific constants
     static constexpr double PI = 3.141592653589793238463;
@@ -88,15 +101,6 @@ private:
      */
     int32_t ire_to_sample(double ire) const;
     
-    /**
-     * @brief Calculate phase for a given field, line, and sample position
-     * @param field_number Field number in sequence
-     * @param line_number Line number within field
-     * @param sample Sample position within line
-     * @return Phase in radians
-     */
-    double calculate_phase(int32_t field_number, int32_t line_number, int32_t sample) const;
-    
     /**
      * @brief Generate horizontal sync pulse
      * @param line_buffer Output buffer
@@ -196,6 +200,13 @@ private:
     void generate_multiburst_packet(uint16_t* line_buffer, double start_time, double duration,
                                    double frequency, double pedestal_ire, double amplitude_pp);
     
+    /**
+     * @brief Render the test signals behind the public generate_* functions
+     */
+    void render_vir(uint16_t* line_buffer, int32_t field_number);
+    void render_ntc7_composite(uint16_t* line_buffer, int32_t field_number);
+    void render_ntc7_combination(uint16_t* line_buffer, int32_t field_number);
+    
     /**
      * @brief Clamp value to 16-bit unsigned range
      */
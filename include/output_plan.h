@@ -0,0 +1,97 @@
+/*
+ * File:        output_plan.h
+ * Module:      encode-orc
+ * Purpose:     Byte layout of a project's output files, computed before encoding
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_OUTPUT_PLAN_H
+#define ENCODE_ORC_OUTPUT_PLAN_H
+
+#include "video_parameters.h"
+#include "yaml_config.h"
+#include <cstdint>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Where every section lands in the output, and how big the files get
+ *
+ * A field is always field_width * field_height 16-bit samples, and every
+ * section's frame count is known once the MOV/MP4 durations have been
+ * probed, so the size of each output file (.tbc, or .tbcy and .tbcc, which
+ * are the same size) and the field offset of every section follow directly
+ * from the project. The output is preallocated from the plan, and each
+ * section writes its fields at the offsets given here.
+ */
+class OutputPlan {
+public:
+    /**
+     * @brief Fields of one section
+     */
+    struct Extent {
+        int64_t first_field = 0;
+        int64_t field_count = 0;
+    };
+
+    /**
+     * @brief Plan the output of a project
+     * @param sections Project sections (durations already resolved)
+     * @param params Video parameters of the output (field size)
+     * @param separate_yc Separate Y and C files instead of one composite file
+     */
+    OutputPlan(const std::vector<VideoSection>& sections, const VideoParameters& params, bool separate_yc);
+
+    /**
+     * @brief Frames produced by a section (0 for a section without a source)
+     */
+    static int32_t section_frames(const VideoSection& section);
+
+    /**
+     * @brief Fields of section @p index (in project order)
+     */
+    const Extent& section(size_t index) const { return sections_[index]; }
+
+    /**
+     * @brief Size of one field in bytes
+     */
+    int64_t field_bytes() const { return field_bytes_; }
+
+    /**
+     * @brief Fields in the whole project
+     */
+    int64_t total_fields() const { return total_fields_; }
+
+    /**
+     * @brief Size of each output file in bytes
+     */
+    int64_t file_bytes() const { return total_fields_ * field_bytes_; }
+
+    /**
+     * @brief Number of output files (1 composite, or 2 for Y/C)
+     */
+    int32_t file_count() const { return file_count_; }
+
+    /**
+     * @brief Disk space needed for all output files
+     */
+    int64_t total_bytes() const { return file_bytes() * file_count_; }
+
+    /**
+     * @brief Byte offset of a field in each output file
+     */
+    int64_t byte_offset(int64_t field) const { return field * field_bytes_; }
+
+private:
+    std::vector<Extent> sections_;
+    int64_t field_bytes_ = 0;
+    int64_t total_fields_ = 0;
+    int32_t file_count_ = 1;
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_OUTPUT_PLAN_H
@@ -18,8 +18,15 @@
 #include "pal_vits_generator.h"
 #include "vitc_generator.h"
 #include "fir_filter.h"
+#include "horizontal_resampler.h"
+#include "subcarrier_table.h"
+#include "line_modulator.h"
+#include "line_template_cache.h"
+#include "biphase_encoder.h"
+#include "line_thread_pool.h"
 #include <cstdint>
 #include <cmath>
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -50,11 +57,11 @@ public:
      * @brief Encode a progressive frame to two interlaced PAL fields
      * @param frame_buffer Input frame in YUV444P16 format
      * @param field_number Starting field number (for V-switch calculation)
-     * @param vbi_data Optional VBI data (vbi0, vbi1, vbi2) to encode in VBI lines (nullptr to skip VBI)
+     * @param frame_vbi Optional VBI data for the frame's two fields (nullptr to skip VBI)
      * @return Frame containing two encoded PAL composite fields
      */
     Frame encode_frame(const FrameBuffer& frame_buffer, int32_t field_number,
-                      const class VBIData* vbi_data = nullptr);
+                      const FrameVBI* frame_vbi = nullptr);
     
     /**
      * @brief Encode a single field from half of a progressive frame
@@ -67,6 +74,51 @@ public:
     Field encode_field(const FrameBuffer& frame_buffer, int32_t field_number, bool is_first_field,
                       const class VBIData* vbi_data = nullptr);
     
+    /**
+     * @brief Encode a progressive frame into an existing frame
+     * 
+     * The fields are resized if needed and every sample is overwritten, so
+     * a recycled frame is encoded without allocating.
+     * @param frame_buffer Input frame in YUV444P16 format
+     * @param field_number Starting field number
+     * @param frame Output frame
+     * @param frame_vbi Optional VBI data for the frame's two fields (nullptr to skip VBI)
+     */
+    void encode_frame(const FrameBuffer& frame_buffer, int32_t field_number, Frame& frame,
+                      const FrameVBI* frame_vbi = nullptr);
+    
+    /**
+     * @brief Encode a single field into an existing field
+     * @param frame_buffer Input frame in YUV444P16 format
+     * @param field_number Field number
+     * @param is_first_field true for first field (even lines), false for second (odd lines)
+     * @param field Output field (resized if needed, every sample overwritten)
+     * @param vbi_data Optional VBI data (nullptr to skip VBI)
+     */
+    void encode_field(const FrameBuffer& frame_buffer, int32_t field_number, bool is_first_field,
+                      Field& field, const class VBIData* vbi_data = nullptr);
+    
+    /**
+     * @brief Reconfigure the encoder for a new section
+     * @param params Video parameters
+     * @param enable_chroma_filter Enable chroma low-pass filter
+     * @param enable_luma_filter Enable luma low-pass filter
+     * 
+     * Leaves the encoder in the same state as a newly constructed one
+     * (VITS/VITC disabled) but keeps filters and generators allocated when
+     * the signal format has not changed.
+     */
+    void reconfigure(const VideoParameters& params,
+                     bool enable_chroma_filter = true,
+                     bool enable_luma_filter = false);
+    
+    /**
+     * @brief Disable VITS/VITC and clear the VITC frame offset
+     * 
+     * Generators stay allocated so a later enable does not reallocate them.
+     */
+    void reset();
+    
     /**
      * @brief Enable VITS (Vertical Interval Test Signals)
      */
@@ -109,6 +161,18 @@ public:
      */
     bool is_vitc_enabled() const;
     
+    /**
+     * @brief Split the active lines of each field across threads
+     * @param num_threads Threads per field, including the caller (1 = serial)
+     *
+     * Every active line depends only on its line number, the field number
+     * and the source frame, so the lines of one field can be encoded in
+     * any order. This cuts the time to produce a single field (e.g. for a
+     * preview); for batch encodes, frame-level threads scale better. The
+     * output is the same for any thread count.
+     */
+    void set_line_threads(int32_t num_threads);
+    
     /**
      * @brief Encode frame to separate Y and C fields (for separate Y/C TBC output)
      * @param frame_buffer Input frame in YUV444P16 format
@@ -117,12 +181,44 @@ public:
      * @param c_field1 Output C field 1
      * @param y_field2 Output Y field 2
      * @param c_field2 Output C field 2
-     * @param vbi_data Optional VBI data (vbi0, vbi1, vbi2) to encode in VBI lines (nullptr to skip VBI)
+     * @param frame_vbi Optional VBI data for the frame's two fields (nullptr to skip VBI)
      */
     void encode_frame_yc(const FrameBuffer& frame_buffer, int32_t field_number,
                          Field& y_field1, Field& c_field1,
                          Field& y_field2, Field& c_field2,
-                         const class VBIData* vbi_data = nullptr);
+                         const FrameVBI* frame_vbi = nullptr);
+    
+    /**
+     * @brief Number of fields after which the PAL subcarrier phase repeats
+     * 
+     * Encoding the same source frame at field_number and at
+     * field_number + COLOUR_SEQUENCE_FIELDS gives identical fields apart from
+     * the lines refreshed by refresh_data_lines().
+     */
+    static constexpr int32_t COLOUR_SEQUENCE_FIELDS = 8;
+    
+    /**
+     * @brief Re-render only the lines carrying per-frame data (biphase VBI and VITC)
+     * @param frame Frame previously produced by encode_frame() at the same colour sequence position
+     * @param field_number Starting field number of the frame being produced
+     * @param frame_vbi Optional VBI data for the frame's two fields (nullptr to skip VBI)
+     */
+    void refresh_data_lines(Frame& frame, int32_t field_number,
+                            const FrameVBI* frame_vbi = nullptr);
+    
+    /**
+     * @brief Y/C counterpart of refresh_data_lines()
+     * @param field_number Starting field number of the frame being produced
+     * @param y_field1 Y field 1 previously produced by encode_frame_yc()
+     * @param c_field1 C field 1 previously produced by encode_frame_yc()
+     * @param y_field2 Y field 2 previously produced by encode_frame_yc()
+     * @param c_field2 C field 2 previously produced by encode_frame_yc()
+     * @param frame_vbi Optional VBI data for the frame's two fields (nullptr to skip VBI)
+     */
+    void refresh_data_lines_yc(int32_t field_number,
+                               Field& y_field1, Field& c_field1,
+                               Field& y_field2, Field& c_field2,
+                               const FrameVBI* frame_vbi = nullptr);
 
 private:
     VideoParameters params_;
@@ -137,11 +233,34 @@ private:
     int32_t vitc_start_frame_offset_ = 0;
     
     // Filters (optional)
-    std::optional<FIRFilter> chroma_filter_;  // 1.3 MHz low-pass for U/V
-    std::optional<FIRFilter> luma_filter_;    // Optional low-pass for Y
+    std::unique_ptr<SampleFilter> chroma_filter_;  // 1.3 MHz low-pass for U/V
+    std::unique_ptr<SampleFilter> luma_filter_;    // Optional low-pass for Y
+    
+    // Source pixels to active samples (rebuilt if the source width changes)
+    std::unique_ptr<HorizontalResampler> resampler_;
+    
+    // Subcarrier phase for this signal format (shared between encoders)
+    std::shared_ptr<const SubcarrierTable> subcarrier_;
+    
+    // Luma levels and chroma modulation of the active line (rebuilt if the
+    // signal format changes)
+    std::unique_ptr<LineModulator> modulator_;
+    
+    // Vsync and blanking/sync/burst lines (composite) and burst lines (Y/C
+    // chroma), rebuilt if the signal format or video levels change
+    std::unique_ptr<LineTemplateCache> line_templates_;
+    std::unique_ptr<LineTemplateCache> chroma_templates_;
+    
+    // Biphase VBI bit cells (rebuilt if the signal format changes)
+    std::unique_ptr<BiphaseEncoder> biphase_;
+    
+    // Threads sharing the active lines of a field (null = serial)
+    std::unique_ptr<LineThreadPool> line_pool_;
     
     // PAL-specific constants
     static constexpr double PI = 3.141592653589793238463;
+    static constexpr double U_MAX = 0.436010;            // Peak U (normalised)
+    static constexpr double V_MAX = 0.614975;            // Peak V (normalised)
     static constexpr int32_t LINES_PER_FIELD = 313;      // PAL has 625 lines total (313 per field)
     static constexpr int32_t ACTIVE_LINES_START = 23;     // First active video line
     static constexpr int32_t ACTIVE_LINES_END = 310;      // Last active video line
@@ -158,6 +277,43 @@ private:
     double sample_rate_;
     double samples_per_cycle_;
     
+    /**
+     * @brief Encode one composite line of the vertical blanking interval
+     * @param line_buffer Pointer to line data
+     * @param line Line number within field (0-indexed)
+     * @param field_number Field number in sequence
+     * @param is_first_field true for the first field of the frame
+     * @param vbi_data Optional VBI data (nullptr to skip VBI)
+     */
+    void encode_vbi_line(uint16_t* line_buffer, int32_t line, int32_t field_number,
+                         bool is_first_field, const class VBIData* vbi_data);
+    
+    /**
+     * @brief Encode one field to separate Y and C fields
+     * @param frame_buffer Input frame in YUV444P16 format
+     * @param field_number Field number in sequence
+     * @param is_first_field true for first field (even lines), false for second (odd lines)
+     * @param y_field Output Y field
+     * @param c_field Output C field
+     * @param vbi_data Optional VBI data (nullptr to skip VBI)
+     */
+    void encode_field_yc(const FrameBuffer& frame_buffer, int32_t field_number,
+                         bool is_first_field, Field& y_field, Field& c_field,
+                         const class VBIData* vbi_data);
+    
+    /**
+     * @brief Encode one Y/C line pair of the vertical blanking interval
+     * @param y_line Pointer to Y line data
+     * @param c_line Pointer to C line data
+     * @param line Line number within field (0-indexed)
+     * @param field_number Field number in sequence
+     * @param is_first_field true for the first field of the frame
+     * @param vbi_data Optional VBI data (nullptr to skip VBI)
+     */
+    void encode_vbi_line_yc(uint16_t* y_line, uint16_t* c_line, int32_t line,
+                            int32_t field_number, bool is_first_field,
+                            const class VBIData* vbi_data);
+    
     /**
      * @brief Generate horizontal sync pulse for a line
      * @param line_buffer Pointer to line data
@@ -173,6 +329,24 @@ private:
      */
     void generate_color_burst(uint16_t* line_buffer, int32_t line_number, int32_t field_number);
     
+    /**
+     * @brief Get the resampler from a source line to the active line
+     * @param source_width Source pixels per line
+     */
+    const HorizontalResampler& resampler_for(int32_t source_width);
+    
+    /**
+     * @brief Run encode_line for every active line of a field
+     *
+     * With line threads, the shared templates and the resampler are built
+     * first, so the lines only read them.
+     * @param field_number Field number in sequence
+     * @param source_width Source pixels per line
+     * @param encode_line Encodes one line (called with the line number in the field)
+     */
+    void encode_active_lines(int32_t field_number, int32_t source_width,
+                             const std::function<void(int32_t line)>& encode_line);
+    
     /**
      * @brief Encode active video line with PAL color subcarrier
      * @param line_buffer Pointer to line data
@@ -193,6 +367,54 @@ private:
                            int32_t width,
                            bool studio_range_input = false);
     
+    /**
+     * @brief Encode active video line to separate Y and C lines
+     * @param y_buffer Pointer to Y line data
+     * @param c_buffer Pointer to C line data
+     * @param y_line Pointer to Y (luma) line data from frame buffer
+     * @param u_line Pointer to U (chroma) line data from frame buffer
+     * @param v_line Pointer to V (chroma) line data from frame buffer
+     * @param line_number Line number in field (for absolute line calculation)
+     * @param field_number Field number (for absolute line calculation)
+     * @param width Width of active video in pixels
+     * @param studio_range_input true if input is studio range (0-1023), false if full-range (0-65535)
+     */
+    void encode_active_line_yc(uint16_t* y_buffer,
+                               uint16_t* c_buffer,
+                               const uint16_t* y_line,
+                               const uint16_t* u_line,
+                               const uint16_t* v_line,
+                               int32_t line_number,
+                               int32_t field_number,
+                               int32_t width,
+                               bool studio_range_input);
+    
+    /**
+     * @brief Luma and modulated chroma levels of the active part of a line
+     * 
+     * The line kernel shared by the composite and Y/C paths: filters and
+     * resamples the source line, then works out every active sample's luma
+     * level and its chroma (subcarrier-modulated, centred on zero).
+     * @param y_line Pointer to Y (luma) line data from frame buffer
+     * @param u_line Pointer to U (chroma) line data from frame buffer
+     * @param v_line Pointer to V (chroma) line data from frame buffer
+     * @param line_number Line number in field (for absolute line calculation)
+     * @param field_number Field number (for absolute line calculation)
+     * @param width Width of active video in pixels
+     * @param studio_range_input true if input is studio range (0-1023), false if full-range (0-65535)
+     * @param luma Output luma levels (active width entries)
+     * @param chroma Output chroma levels (active width entries)
+     */
+    void encode_active_levels(const uint16_t* y_line,
+                              const uint16_t* u_line,
+                              const uint16_t* v_line,
+                              int32_t line_number,
+                              int32_t field_number,
+                              int32_t width,
+                              bool studio_range_input,
+                              int32_t* luma,
+                              int32_t* chroma);
+    
     /**
      * @brief Generate vertical sync line
      * @param line_buffer Pointer to line data
@@ -207,14 +429,18 @@ private:
     void generate_blanking_line(uint16_t* line_buffer);
     
     /**
-     * @brief Generate VBI line with biphase-encoded data
-     * @param line_buffer Pointer to line data
-     * @param line_number Line number within field (0-indexed)
+     * @brief Draw the biphase VBI and VITC lines of a field in one pass
+     * 
+     * encode_vbi_line() and encode_vbi_line_yc() lay down the blanking of
+     * these lines; the three biphase codes and the VITC word are then
+     * rendered together straight into the field.
+     * @param field Composite or Y field
      * @param field_number Field number in sequence
-     * @param vbi_value 24-bit VBI value to encode (vbi0, vbi1, or vbi2)
+     * @param is_first_field true for the first field of the frame
+     * @param vbi_data Optional VBI data (nullptr to skip VBI)
      */
-    void generate_biphase_vbi_line(uint16_t* line_buffer, int32_t line_number,
-                                   int32_t field_number, int32_t vbi_value);
+    void encode_data_lines(Field& field, int32_t field_number, bool is_first_field,
+                           const class VBIData* vbi_data);
     
     /**
      * @brief Generate color burst on chroma channel (centered at 32768)
@@ -224,16 +450,6 @@ private:
      */
     void generate_color_burst_chroma(uint16_t* line_buffer, int32_t line_number, int32_t field_number);
     
-    /**
-     * @brief Generate color burst on chroma channel for part of a line
-     * @param line_buffer Pointer to line data
-     * @param line_number Line number within field (0-indexed)
-     * @param field_number Field number in sequence
-     * @param burst_end End position for burst (active video starts here)
-     */
-    void generate_color_burst_chroma_line(uint16_t* line_buffer, int32_t line_number, 
-                                          int32_t field_number, int32_t burst_end);
-    
     /**
      * @brief Calculate PAL V-switch sign for a given field
      * @param field_number Field number (0-indexed)
@@ -254,19 +470,6 @@ private:
         if (value > 65535) return 65535;
         return static_cast<uint16_t>(value);
     }
-    
-    /**
-     * @brief Convert YUV to composite PAL signal sample
-     * @param y Luma value (16-bit)
-     * @param u U chroma value (16-bit)
-     * @param v V chroma value (16-bit)
-     * @param phase Subcarrier phase (radians)
-     * @param v_switch PAL V-switch (+1 or -1)
-     * @param studio_range_input true if input is studio range (0-1023), false if full-range (0-65535)
-     * @return Composite video sample (16-bit)
-     */
-    uint16_t yuv_to_composite(uint16_t y, uint16_t u, uint16_t v, 
-                             double phase, int32_t v_switch, bool studio_range_input = false);
 };
 
 } // namespace encode_orc
@@ -11,7 +11,10 @@
 #define ENCODE_ORC_PAL_VITS_GENERATOR_H
 
 #include "video_parameters.h"
+#include "subcarrier_table.h"
+#include "vits_line_cache.h"
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <cmath>
 
@@ -70,6 +73,17 @@ public:
 
 private:
     VideoParameters params_;
+    std::shared_ptr<const SubcarrierTable> subcarrier_;
+    
+    // Test signals, as indices into the rendered line cache
+    static constexpr int32_t ITU_COMPOSITE = 0;
+    static constexpr int32_t UK_NATIONAL = 1;
+    static constexpr int32_t ITU_ITS = 2;
+    static constexpr int32_t MULTIBURST = 3;
+    static constexpr int32_t NUM_SIGNALS = 4;
+    
+    // Rendered test signals by colour-sequence position
+    VITSLineCache lines_;
     
     // PAL-specific constants
     static constexpr double PI = 3.141592653589793238463;
@@ -93,23 +107,6 @@ private:
      */
     int32_t ire_to_sample(double ire) const;
     
-    /**
-     * @brief Calculate phase for a given field and line
-     * @param field_number Field number in sequence
-     * @param line_number Line number within field
-     * @param sample Sample position within line
-     * @return Phase in radians
-     */
-    double calculate_phase(int32_t field_number, int32_t line_number, int32_t sample) const;
-    
-    /**
-     * @brief Calculate PAL V-switch for a given field and line
-     * @param field_number Field number
-     * @param line_number Line number within field
-     * @return +1 or -1 for V-switch
-     */
-    int32_t get_v_switch(int32_t field_number, int32_t line_number) const;
-    
     /**
      * @brief Generate horizontal sync pulse
      * @param line_buffer Output buffer
@@ -197,6 +194,14 @@ private:
     void generate_multiburst_packet(uint16_t* line_buffer, double start_time, double duration,
                                    double frequency, double pedestal_ire, double amplitude_pp);
     
+    /**
+     * @brief Render the test signals behind the public generate_* functions
+     */
+    void render_itu_composite(uint16_t* line_buffer, int32_t field_number);
+    void render_uk_national(uint16_t* line_buffer, int32_t field_number);
+    void render_itu_its(uint16_t* line_buffer, int32_t field_number);
+    void render_multiburst(uint16_t* line_buffer, int32_t field_number);
+    
     /**
      * @brief Clamp value to 16-bit unsigned range
      */
@@ -0,0 +1,119 @@
+/*
+ * File:        subcarrier_table.h
+ * Module:      encode-orc
+ * Purpose:     Precomputed colour subcarrier phase for PAL and NTSC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_SUBCARRIER_TABLE_H
+#define ENCODE_ORC_SUBCARRIER_TABLE_H
+
+#include "video_parameters.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Subcarrier sin/cos for every (field, line, sample) of a signal format
+ *
+ * The subcarrier phase at the start of a line only depends on the field's
+ * position in the colour-framing sequence (8 fields for PAL, 4 for NTSC)
+ * and the line number. With 283.7516 (PAL) and 227.5 (NTSC) cycles per
+ * line the fractional phase is always an exact multiple of 1/2500 or 1/4
+ * of a cycle, so it is worked out in integers and looked up in a one-cycle
+ * table; the phase advance along the line is a second table indexed by
+ * sample. No trigonometry is left on the per-line or per-sample path and
+ * the phase no longer loses precision as field numbers grow.
+ */
+class SubcarrierTable {
+public:
+    /**
+     * @brief Subcarrier phase at sample 0 of a line
+     */
+    struct LinePhase {
+        double sin = 0.0;       ///< sin of the phase
+        double cos = 1.0;       ///< cos of the phase
+        int32_t v_switch = 1;   ///< PAL V-switch (+1 or -1); always +1 for NTSC
+
+        /**
+         * @brief The same line phase advanced by a fixed angle
+         * @param sin_offset sin of the angle
+         * @param cos_offset cos of the angle
+         */
+        LinePhase shifted(double sin_offset, double cos_offset) const {
+            return {sin * cos_offset + cos * sin_offset, cos * cos_offset - sin * sin_offset, v_switch};
+        }
+    };
+
+    /**
+     * @brief Build the tables for a signal format
+     * @param params Video parameters (PAL uses the 8-field sequence, others NTSC's 4)
+     */
+    explicit SubcarrierTable(const VideoParameters& params);
+
+    /**
+     * @brief Shared table for a signal format, built on first use
+     *
+     * Thread-safe; every encoder and generator working on the same format
+     * gets the same table.
+     */
+    static std::shared_ptr<const SubcarrierTable> for_parameters(const VideoParameters& params);
+
+    /**
+     * @brief Phase at the start of a line
+     * @param field_number Field number (any non-negative value)
+     * @param line_number Line number within the field (0-based)
+     */
+    LinePhase line_phase(int32_t field_number, int32_t line_number) const;
+
+    /**
+     * @brief sin of the subcarrier at a sample of a line
+     * @param line Line phase from line_phase()
+     * @param sample Sample within the line (0 to field_width - 1)
+     */
+    double sin_at(const LinePhase& line, int32_t sample) const {
+        return line.sin * sample_cos_[sample] + line.cos * sample_sin_[sample];
+    }
+
+    /**
+     * @brief cos of the subcarrier at a sample of a line
+     * @param line Line phase from line_phase()
+     * @param sample Sample within the line (0 to field_width - 1)
+     */
+    double cos_at(const LinePhase& line, int32_t sample) const {
+        return line.cos * sample_cos_[sample] - line.sin * sample_sin_[sample];
+    }
+
+    /**
+     * @brief Fields in the colour-framing sequence (8 for PAL, 4 for NTSC)
+     */
+    int32_t sequence_fields() const { return sequence_fields_; }
+
+    /**
+     * @brief Check if the table was built for this signal format
+     */
+    bool matches(const VideoParameters& params) const {
+        return params_.has_same_signal_format(params);
+    }
+
+private:
+    VideoParameters params_;
+    bool pal_;
+    int32_t sequence_fields_;
+
+    // sin/cos of each fractional line phase (k / cycle_steps of a cycle)
+    std::vector<double> cycle_sin_;
+    std::vector<double> cycle_cos_;
+
+    // sin/cos of the phase advance from sample 0 to each sample of a line
+    std::vector<double> sample_sin_;
+    std::vector<double> sample_cos_;
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_SUBCARRIER_TABLE_H
@@ -0,0 +1,184 @@
+/*
+ * File:        tbc_output_sink.h
+ * Module:      encode-orc
+ * Purpose:     Project output files that encoded sections append to
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_TBC_OUTPUT_SINK_H
+#define ENCODE_ORC_TBC_OUTPUT_SINK_H
+
+#include "tbc_writer.h"
+#include "yc_tbc_writer.h"
+#include "frame_encode_pipeline.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief The final output file(s) of a project
+ *
+ * Opened once per project; every section's encoded frames are appended
+ * straight into the final .tbc (composite) or .tbcy/.tbcc (separate Y/C,
+ * or .tbc/_chroma.tbc in legacy naming). field_offset() tells the caller
+ * where the next section starts.
+ *
+ * The project output is created with open() and sized up front with
+ * reserve() from the OutputPlan. For sections encoded in parallel, each
+ * section then gets its own sink from open_section(), which writes the
+ * section's fields at their planned place in the same file(s).
+ *
+ * sync() (called by itself at the interval given to set_sync_interval())
+ * makes sure everything written so far is on disk and reports how far
+ * that is, which is what the resume checkpoint records.
+ */
+class TBCOutputSink {
+public:
+    TBCOutputSink() = default;
+
+    /**
+     * @brief Destructor - closes any open files
+     */
+    ~TBCOutputSink() {
+        close();
+    }
+
+    TBCOutputSink(const TBCOutputSink&) = delete;
+    TBCOutputSink& operator=(const TBCOutputSink&) = delete;
+
+    /**
+     * @brief Create the output file(s), replacing any existing ones
+     * @param output_filename Project output filename (.tbc); in Y/C mode the
+     *        .tbc extension is replaced by the Y/C naming scheme
+     * @param separate_yc Write separate Y and C files instead of composite
+     * @param yc_legacy Use legacy Y/C naming (.tbc/_chroma.tbc)
+     * @return true on success, false on error (see error())
+     */
+    bool open(const std::string& output_filename, bool separate_yc, bool yc_legacy);
+
+    /**
+     * @brief Open the existing output file(s) to write one section's fields
+     * @param output_filename Project output filename, as passed to open()
+     * @param separate_yc Write separate Y and C files instead of composite
+     * @param yc_legacy Use legacy Y/C naming (.tbc/_chroma.tbc)
+     * @param first_field Field number of the section's first field
+     * @param field_bytes Size of one field in bytes
+     * @return true on success, false on error (see error())
+     */
+    bool open_section(const std::string& output_filename, bool separate_yc, bool yc_legacy,
+                      int64_t first_field, int64_t field_bytes);
+
+    /**
+     * @brief Reserve disk space for the whole project in every output file
+     * @param file_bytes Final size of each file (OutputPlan::file_bytes())
+     * @return true on success, false on error, e.g. a full disk (see error())
+     */
+    bool reserve(int64_t file_bytes);
+
+    /**
+     * @brief Append both fields of an encoded frame
+     * @param frame Encoded frame (composite or Y/C, matching the open mode)
+     * @return true on success, false on error
+     */
+    bool write_frame(const EncodedFrame& frame);
+
+    /**
+     * @brief Write out buffered data and close the file(s)
+     * @return true if everything was written, false on error
+     */
+    bool close();
+
+    /**
+     * @brief Called after each sync() with synced_field_offset()
+     */
+    using SyncCallback = std::function<void(int64_t synced_field_offset)>;
+
+    /**
+     * @brief Sync the output every so often while frames are written
+     *
+     * Kept until changed, also across open() and open_section().
+     * @param seconds Minimum time between syncs (0 = only explicit sync() calls)
+     * @param callback Called after every successful sync (may be empty)
+     */
+    void set_sync_interval(double seconds, SyncCallback callback);
+
+    /**
+     * @brief Write out buffered data and wait until it is on disk
+     * @return true on success, false on error
+     */
+    bool sync();
+
+    /**
+     * @brief Field number after the last field known to be on disk (see sync())
+     */
+    int64_t synced_field_offset() const { return synced_field_offset_; }
+
+    /**
+     * @brief Check if the sink is open
+     */
+    bool is_open() const;
+
+    /**
+     * @brief Whether the sink expects separate Y/C frames
+     */
+    bool separate_yc() const { return separate_yc_; }
+
+    /**
+     * @brief Field number after the last one written (the first field of the next section)
+     */
+    int64_t field_offset() const { return fields_written_; }
+
+    /**
+     * @brief Paths of the output files (composite, or luma then chroma)
+     */
+    const std::vector<std::string>& filenames() const { return filenames_; }
+
+    /**
+     * @brief Get error message from the last failure
+     */
+    const std::string& error() const { return error_message_; }
+
+    /**
+     * @brief Base filename used for Y/C outputs (output filename without .tbc)
+     */
+    static std::string yc_base_filename(const std::string& output_filename);
+
+    /**
+     * @brief Paths of the output files open() would create (composite, or luma then chroma)
+     */
+    static std::vector<std::string> filenames_for(const std::string& output_filename,
+                                                  bool separate_yc, bool yc_legacy);
+
+private:
+    bool separate_yc_ = false;
+    TBCWriter composite_writer_;
+    std::unique_ptr<YCTBCWriter> yc_writer_;
+    std::vector<std::string> filenames_;
+    int64_t fields_written_ = 0;
+    int64_t first_field_ = 0;           // Field the files were opened at
+    int64_t field_bytes_ = 0;           // Size of one field, known after the first frame
+    int64_t synced_field_offset_ = 0;
+    std::string error_message_;
+
+    std::chrono::steady_clock::duration sync_interval_{0};
+    std::chrono::steady_clock::time_point next_sync_;
+    SyncCallback sync_callback_;
+
+    // Writers of the open file(s)
+    std::vector<TBCWriter*> writers();
+
+    // Offset < 0 creates (truncates) the files, otherwise opens them at offset
+    bool open_files(const std::string& output_filename, bool separate_yc, bool yc_legacy,
+                    int64_t offset);
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_TBC_OUTPUT_SINK_H
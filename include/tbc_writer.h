@@ -11,8 +11,8 @@
 #define ENCODE_ORC_TBC_WRITER_H
 
 #include "field.h"
+#include "buffered_tbc_file.h"
 #include <string>
-#include <fstream>
 #include <cstdint>
 
 namespace encode_orc {
@@ -24,6 +24,8 @@ namespace encode_orc {
  * unsigned samples in little-endian format.
  * 
  * Can be used for combined Y+C composite output, or separate Y and C files.
+ * Output goes through BufferedTBCFile, so fields are batched into large
+ * writes rather than written sample by sample.
  */
 class TBCWriter {
 public:
@@ -51,8 +53,7 @@ public:
     bool open(const std::string& filename) {
         close();
         
-        file_.open(filename, std::ios::binary | std::ios::trunc);
-        if (!file_) {
+        if (!file_.open(filename)) {
             return false;
         }
         
@@ -61,12 +62,37 @@ public:
     }
     
     /**
-     * @brief Close the TBC file
+     * @brief Open a TBC file for writing fields from a byte offset onwards
+     * @param filename Path to TBC file (created if missing, never truncated)
+     * @param offset Byte offset of the first field written
+     * @return true on success, false on failure
      */
-    void close() {
-        if (file_.is_open()) {
-            file_.close();
+    bool open_at(const std::string& filename, int64_t offset) {
+        close();
+        
+        if (!file_.open_at(filename, offset)) {
+            return false;
         }
+        
+        filename_ = filename;
+        return true;
+    }
+    
+    /**
+     * @brief Reserve disk space for the final size of the open TBC file
+     * @param bytes Final file size
+     * @return true on success, false on failure (see error())
+     */
+    bool preallocate(int64_t bytes) {
+        return file_.preallocate(bytes);
+    }
+    
+    /**
+     * @brief Close the TBC file, writing out any buffered fields
+     * @return true if all data was written, false on failure
+     */
+    bool close() {
+        return file_.close();
     }
     
     /**
@@ -92,32 +118,50 @@ public:
         if (!file_.is_open()) {
             return false;
         }
-        
-        // Write 16-bit samples in little-endian format
-        const auto& data = field.data();
-        for (uint16_t sample : data) {
-            // Write low byte then high byte (little-endian)
-            uint8_t low = sample & 0xFF;
-            uint8_t high = (sample >> 8) & 0xFF;
-            file_.write(reinterpret_cast<const char*>(&low), 1);
-            file_.write(reinterpret_cast<const char*>(&high), 1);
-        }
-        
-        return file_.good();
+        return file_.write_field(field);
+    }
+    
+    /**
+     * @brief Write out buffered fields and wait until they are on disk
+     * @return true on success, false on failure (see error())
+     */
+    bool sync() {
+        return file_.sync();
+    }
+    
+    /**
+     * @brief Bytes written to the file so far, excluding any still buffered
+     */
+    int64_t flushed() const {
+        return file_.flushed_position();
     }
     
     /**
-     * @brief Get current file position
+     * @brief Get current file position (including buffered data)
      */
     int64_t tell() const {
         if (!file_.is_open()) {
             return -1;
         }
-        return const_cast<std::ofstream&>(file_).tellp();
+        return file_.position();
+    }
+    
+    /**
+     * @brief Get write statistics for the current file
+     */
+    const BufferedTBCFile::Stats& stats() const {
+        return file_.stats();
+    }
+    
+    /**
+     * @brief Get the error from the last failed operation
+     */
+    const std::string& error() const {
+        return file_.error();
     }
 
 private:
-    std::ofstream file_;
+    BufferedTBCFile file_;
     std::string filename_;
 };
 
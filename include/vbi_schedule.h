@@ -0,0 +1,111 @@
+/*
+ * File:        vbi_schedule.h
+ * Module:      encode-orc
+ * Purpose:     On-demand LaserDisc VBI codes for any field of a project
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_VBI_SCHEDULE_H
+#define ENCODE_ORC_VBI_SCHEDULE_H
+
+#include "video_parameters.h"
+#include "yaml_config.h"
+#include "output_plan.h"
+#include "metadata.h"
+#include <cstdint>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Biphase VBI (lines 16, 17 and 18) of every field, computed when asked for
+ *
+ * Only the settings of each section (disc area, CAV picture start, CLV
+ * chapter and timecode start) and its place in the OutputPlan are kept; the
+ * VBI of a field is worked out from those on every call. Memory therefore
+ * does not grow with the length of the programme, and any field can be
+ * queried in any order, from any thread, without a prebuilt table.
+ *
+ * Field numbers are absolute positions in the output. A project whose
+ * standard has no LaserDisc VBI has an empty schedule.
+ */
+class VBISchedule {
+public:
+    /**
+     * @brief Empty schedule (no field carries VBI)
+     */
+    VBISchedule() = default;
+
+    /**
+     * @brief Schedule the VBI of a project
+     * @param config YAML project configuration with all sections
+     * @param system Video system (PAL or NTSC)
+     * @param plan Output plan for the project's sections
+     */
+    VBISchedule(const YAMLProjectConfig& config, VideoSystem system, const OutputPlan& plan);
+
+    /**
+     * @brief true if no field carries VBI
+     */
+    bool empty() const { return sections_.empty(); }
+
+    /**
+     * @brief VBI of one field
+     * @param field_number Absolute field number
+     * @param vbi Set to the field's VBI
+     * @return true if the field carries VBI, false if not (or out of range)
+     */
+    bool field_vbi(int64_t field_number, VBIData& vbi) const;
+
+    /**
+     * @brief VBI for the two fields of the frame starting at @p field_number
+     * @param field_number Absolute number of the frame's first field
+     * @param vbi Set to the frame's VBI
+     * @return true if the frame carries VBI, false if not (or out of range)
+     */
+    bool frame_vbi(int64_t field_number, FrameVBI& vbi) const;
+
+private:
+    enum class DiscArea {
+        LeadIn,
+        Programme,
+        LeadOut
+    };
+
+    // One section's settings; sections are kept in output order
+    struct Section {
+        int64_t first_field = 0;
+        int64_t field_count = 0;
+        DiscArea disc_area = DiscArea::Programme;
+        int32_t picture_start = 0;      // CAV picture number of the first frame (0 = not used)
+        int32_t chapter = 0;            // CLV chapter number (0 = not used)
+        bool has_timecode = false;
+        int32_t timecode_start = 0;     // CLV timecode of the first frame, in frames
+    };
+
+    std::vector<Section> sections_;
+    int32_t fps_ = 25;
+
+    /**
+     * @brief Section containing @p field_number, or nullptr
+     */
+    const Section* find(int64_t field_number) const;
+
+    /**
+     * @brief VBI of a field within a section
+     * @param section Section the field belongs to
+     * @param field_number Absolute field number
+     */
+    VBIData compute(const Section& section, int64_t field_number) const;
+
+    /**
+     * @brief Two-digit BCD of @p value (0-99)
+     */
+    static int32_t to_bcd(int32_t value) { return ((value / 10) << 4) | (value % 10); }
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_VBI_SCHEDULE_H
@@ -14,18 +14,32 @@
 #include "source_video_standard.h"
 #include "pal_encoder.h"
 #include "ntsc_encoder.h"
-#include "tbc_writer.h"
-#include "metadata_writer.h"
+#include "tbc_output_sink.h"
+#include "metadata.h"
+#include "frame_buffer.h"
+#include "frame_encode_pipeline.h"
 #include <string>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace encode_orc {
 
+class VideoLoaderBase;
+class VBISchedule;
+
 /**
  * @brief Main video encoder class
  * 
- * Coordinates raw image loading (Y'CbCr 4:2:2 or PNG), PAL/NTSC encoding, and file output
+ * Coordinates raw image loading (Y'CbCr 4:2:2 or PNG), PAL/NTSC encoding, and file output.
+ * Reuse one instance for all sections of a project: its encoding pipeline (and the
+ * PAL/NTSC encoders inside it) is kept between calls and only reconfigured.
+ * 
+ * Each encode_* call appends one section to the project's TBCOutputSink. Metadata
+ * is not written here; the caller builds it once for the whole project, and the
+ * biphase VBI of each frame comes from the same VBISchedule (see set_vbi_schedule()).
  */
 class VideoEncoder {
 public:
@@ -46,125 +60,113 @@ public:
     
     /**
      * @brief Encode video with Y'CbCr 4:2:2 raw image repeated for multiple frames
-     * @param output_filename Output .tbc filename (or base filename for Y/C mode)
+     * @param output Project output the encoded fields are appended to
      * @param system Video system (PAL or NTSC)
+     * @param source_standard Source video standard (IEC LaserDisc, consumer-tape, or none)
      * @param yuv422_file Path to Y'CbCr 4:2:2 raw image file (YUYV packed, 10-bit studio range)
      * @param num_frames Number of frames to encode (image repeated each frame)
-     * @param verbose Enable verbose output
-     * @param picture_start Starting CAV picture number (0 = not used)
-     * @param chapter CLV chapter number (0 = not used)
-     * @param timecode_start CLV timecode HH:MM:SS:FF (empty = not used)
      * @param enable_chroma_filter Enable 1.3 MHz chroma low-pass filter (default: true)
      * @param enable_luma_filter Enable luma low-pass filter (default: false)
-     * @param separate_yc Enable separate Y/C TBC output (default: false)
-     * @param yc_legacy Use legacy naming (.tbc/.tbc_chroma) instead of modern (.tbcy/.tbcc) (default: false)
+     * @param first_frame First frame to encode; earlier frames are already in the output (resume)
      * @return true on success, false on error
      */
-    bool encode_yuv422_image(const std::string& output_filename,
+    bool encode_yuv422_image(TBCOutputSink& output,
                             VideoSystem system,
                             SourceVideoStandard source_standard,
                             const std::string& yuv422_file,
                             int32_t num_frames,
-                            int32_t picture_start = 0,
-                            int32_t chapter = 0,
-                            const std::string& timecode_start = "",
                             bool enable_chroma_filter = true,
                             bool enable_luma_filter = false,
-                            bool separate_yc = false,
-                            bool yc_legacy = false);
+                            int32_t first_frame = 0);
     
     /**
      * @brief Encode video with PNG image repeated for multiple frames
-     * @param output_filename Output .tbc filename (or base filename for Y/C mode)
+     * @param output Project output the encoded fields are appended to
      * @param system Video system (PAL or NTSC)
+     * @param source_standard Source video standard (IEC LaserDisc, consumer-tape, or none)
      * @param png_file Path to PNG image file
      * @param num_frames Number of frames to encode (image repeated each frame)
-     * @param verbose Enable verbose output
-     * @param picture_start Starting CAV picture number (0 = not used)
-     * @param chapter CLV chapter number (0 = not used)
-     * @param timecode_start CLV timecode HH:MM:SS:FF (empty = not used)
      * @param enable_chroma_filter Enable 1.3 MHz chroma low-pass filter (default: true)
      * @param enable_luma_filter Enable luma low-pass filter (default: false)
-     * @param separate_yc Enable separate Y/C TBC output (default: false)
-     * @param yc_legacy Use legacy naming (.tbc/.tbc_chroma) instead of modern (.tbcy/.tbcc) (default: false)
+     * @param first_frame First frame to encode; earlier frames are already in the output (resume)
      * @return true on success, false on error
      */
-    bool encode_png_image(const std::string& output_filename,
+    bool encode_png_image(TBCOutputSink& output,
                           VideoSystem system,
                           SourceVideoStandard source_standard,
                           const std::string& png_file,
                           int32_t num_frames,
-                          int32_t picture_start = 0,
-                          int32_t chapter = 0,
-                          const std::string& timecode_start = "",
                           bool enable_chroma_filter = true,
                           bool enable_luma_filter = false,
-                          bool separate_yc = false,
-                          bool yc_legacy = false);
+                          int32_t first_frame = 0);
     
     /**
      * @brief Encode video from MOV file frames
-     * @param output_filename Output .tbc filename (or base filename for Y/C mode)
+     * @param output Project output the encoded fields are appended to
      * @param system Video system (PAL or NTSC)
      * @param source_standard Source video standard (IEC LaserDisc, consumer-tape, or none)
      * @param mov_file Path to MOV file (v210 or other ffmpeg-supported format)
      * @param num_frames Number of frames to encode
      * @param start_frame Starting frame number in MOV file (0-indexed, default: 0)
-     * @param verbose Enable verbose output
-     * @param picture_start Starting CAV picture number (0 = not used)
-     * @param chapter CLV chapter number (0 = not used)
-     * @param timecode_start CLV timecode HH:MM:SS:FF (empty = not used)
      * @param enable_chroma_filter Enable 1.3 MHz chroma low-pass filter (default: true)
      * @param enable_luma_filter Enable luma low-pass filter (default: false)
-     * @param separate_yc Enable separate Y/C TBC output (default: false)
-     * @param yc_legacy Use legacy naming (.tbc/.tbc_chroma) instead of modern (.tbcy/.tbcc) (default: false)
+     * @param first_frame First frame to encode; earlier frames are already in the output (resume)
      * @return true on success, false on error
      */
-    bool encode_mov_file(const std::string& output_filename,
+    bool encode_mov_file(TBCOutputSink& output,
                          VideoSystem system,
                          SourceVideoStandard source_standard,
                          const std::string& mov_file,
                          int32_t num_frames,
                          int32_t start_frame = 0,
-                         int32_t picture_start = 0,
-                         int32_t chapter = 0,
-                         const std::string& timecode_start = "",
                          bool enable_chroma_filter = true,
                          bool enable_luma_filter = false,
-                         bool separate_yc = false,
-                         bool yc_legacy = false);
+                         int32_t first_frame = 0);
     
     /**
      * @brief Encode video from MP4 file frames
-     * @param output_filename Output .tbc filename (or base filename for Y/C mode)
+     * @param output Project output the encoded fields are appended to
      * @param system Video system (PAL or NTSC)
      * @param source_standard Source video standard (IEC LaserDisc, consumer-tape, or none)
      * @param mp4_file Path to MP4 file (H.264, H.265, or other ffmpeg-supported codec)
      * @param num_frames Number of frames to encode
      * @param start_frame Starting frame number in MP4 file (0-indexed, default: 0)
-     * @param verbose Enable verbose output
-     * @param picture_start Starting CAV picture number (0 = not used)
-     * @param chapter CLV chapter number (0 = not used)
-     * @param timecode_start CLV timecode HH:MM:SS:FF (empty = not used)
      * @param enable_chroma_filter Enable 1.3 MHz chroma low-pass filter (default: true)
      * @param enable_luma_filter Enable luma low-pass filter (default: false)
-     * @param separate_yc Enable separate Y/C TBC output (default: false)
-     * @param yc_legacy Use legacy naming (.tbc/.tbc_chroma) instead of modern (.tbcy/.tbcc) (default: false)
+     * @param first_frame First frame to encode; earlier frames are already in the output (resume)
      * @return true on success, false on error
      */
-    bool encode_mp4_file(const std::string& output_filename,
+    bool encode_mp4_file(TBCOutputSink& output,
                          VideoSystem system,
                          SourceVideoStandard source_standard,
                          const std::string& mp4_file,
                          int32_t num_frames,
                          int32_t start_frame = 0,
-                         int32_t picture_start = 0,
-                         int32_t chapter = 0,
-                         const std::string& timecode_start = "",
                          bool enable_chroma_filter = true,
                          bool enable_luma_filter = false,
-                         bool separate_yc = false,
-                         bool yc_legacy = false);
+                         int32_t first_frame = 0);
+    
+    /**
+     * @brief Set the number of encoding threads
+     * @param num_threads Worker count (0 = one per hardware thread, 1 = single-threaded)
+     */
+    void set_num_threads(int32_t num_threads) { num_threads_ = num_threads; }
+    
+    /**
+     * @brief Set the number of threads sharing the lines of each field
+     * @param line_threads Threads per field (1 = serial)
+     */
+    void set_line_threads(int32_t line_threads) { line_threads_ = line_threads; }
+    
+    /**
+     * @brief Set the schedule the VBI lines are rendered from
+     * 
+     * Frames are looked up by their field position in the output, so this
+     * works the same for sequential and parallel sections. Without a
+     * schedule no VBI is rendered.
+     * @param vbi_schedule Project VBI schedule (must outlive the encoding), or nullptr
+     */
+    void set_vbi_schedule(const VBISchedule* vbi_schedule) { vbi_schedule_ = vbi_schedule; }
     
     /**
      * @brief Get error message from last operation
@@ -173,6 +175,83 @@ public:
     
 private:
     std::string error_message_;
+    int32_t num_threads_ = 0;
+    int32_t line_threads_ = 1;
+    const VBISchedule* vbi_schedule_ = nullptr;
+    std::unique_ptr<FrameEncodePipeline> pipeline_;
+    
+    // Scratch source frames, recycled from one section to the next
+    BufferPool<FrameBuffer> frame_buffer_pool_;
+    
+    /**
+     * @brief Supplies source frame @p frame_num, in order
+     * 
+     * A source may decode into @p scratch and return it, or return a frame it
+     * owns. Returns nullptr on failure, after setting error_message_.
+     */
+    using FrameSource = std::function<const FrameBuffer*(int32_t frame_num, FrameBuffer& scratch)>;
+    
+    /**
+     * @brief Encode frames through the frame pipeline and write them out in order
+     * @param output Project output (its mode selects composite or separate Y/C encoding)
+     * @param params Video parameters
+     * @param source_standard Source video standard
+     * @param frames Source frames (a single frame is repeated for every output frame)
+     * @param num_frames Number of frames to encode
+     * @param first_frame First frame to encode (earlier frames are already in the output)
+     * @param enable_chroma_filter Enable chroma low-pass filter
+     * @param enable_luma_filter Enable luma low-pass filter
+     * @return true on success, false on error
+     */
+    bool encode_frames(TBCOutputSink& output,
+                       const VideoParameters& params,
+                       SourceVideoStandard source_standard,
+                       const std::vector<FrameBuffer>& frames,
+                       int32_t num_frames,
+                       int32_t first_frame,
+                       bool enable_chroma_filter,
+                       bool enable_luma_filter);
+    
+    /**
+     * @brief Encode frames pulled one at a time from a frame source
+     * 
+     * Only a ring of FrameEncodePipeline::max_in_flight() + 1 scratch frames
+     * is used, however long the section is. The ring comes from
+     * frame_buffer_pool_, so later sections reuse the same buffers.
+     * 
+     * @param output Project output (its mode selects composite or separate Y/C encoding)
+     * @param params Video parameters
+     * @param source_standard Source video standard
+     * @param source Frame source called once per frame in output order
+     * @param repeated_frame true if the source returns the same still frame every time
+     * @param num_frames Number of frames to encode
+     * @param first_frame First frame to encode (earlier frames are already in the output)
+     * @param enable_chroma_filter Enable chroma low-pass filter
+     * @param enable_luma_filter Enable luma low-pass filter
+     * @return true on success, false on error
+     */
+    bool encode_frames(TBCOutputSink& output,
+                       const VideoParameters& params,
+                       SourceVideoStandard source_standard,
+                       const FrameSource& source,
+                       bool repeated_frame,
+                       int32_t num_frames,
+                       int32_t first_frame,
+                       bool enable_chroma_filter,
+                       bool enable_luma_filter);
+    
+    /**
+     * @brief Make a frame source that takes frames from a loader's stream
+     * 
+     * The stream must already be started. Running out of frames early is an
+     * error, since file sections must be frame-accurate.
+     * 
+     * @param loader Loader with a running stream
+     * @param num_frames Number of frames requested
+     * @param source_name File type for error messages (e.g. "MOV")
+     */
+    FrameSource stream_source(VideoLoaderBase& loader, int32_t num_frames,
+                              const std::string& source_name);
     
     // Static video level overrides for all encoding operations
     static std::optional<int32_t> s_blanking_16b_ire_override;
@@ -13,7 +13,14 @@
 #include "frame_buffer.h"
 #include "video_parameters.h"
 #include <cstdint>
+#include <cstddef>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace encode_orc {
 
@@ -190,10 +197,24 @@ public:
  * Provides common interface for all file-based video loaders.
  * Concrete implementations (MOVLoader, MP4Loader, etc.) inherit from this
  * and implement format-specific functionality.
+ * 
+ * Loaders that decode long sources can also stream: start_stream() runs a
+ * reader thread that decodes frames into a bounded prefetch queue, and
+ * next_frame() hands them out in order. Memory use is then set by the queue
+ * depth rather than by the number of frames in the section. Loaders that
+ * support streaming implement the open/read/close_frame_stream() hooks and
+ * must call stop_stream() from their destructor and close().
  */
 class VideoLoaderBase {
 public:
-    virtual ~VideoLoaderBase() = default;
+    /// Default number of decoded frames held ahead of the consumer
+    static constexpr size_t DEFAULT_PREFETCH_FRAMES = 4;
+    
+    VideoLoaderBase() = default;
+    virtual ~VideoLoaderBase();
+    
+    VideoLoaderBase(const VideoLoaderBase&) = delete;
+    VideoLoaderBase& operator=(const VideoLoaderBase&) = delete;
     
     /**
      * @brief Get video dimensions
@@ -240,6 +261,47 @@ public:
      * @return true if valid, false on error
      */
     virtual bool validate_format(VideoSystem system, std::string& error_message) = 0;
+    
+    /**
+     * @brief Start streaming consecutive frames on a background reader thread
+     * 
+     * Validates the request the same way as a full load, then starts the
+     * reader. Any stream already running is stopped first.
+     * 
+     * @param start_frame Starting frame number (0-indexed)
+     * @param num_frames Number of frames to stream
+     * @param expected_width Expected width
+     * @param expected_height Expected height
+     * @param params Video parameters
+     * @param error_message Error message if the stream cannot be started
+     * @param prefetch_frames Maximum number of decoded frames queued ahead of next_frame()
+     * @return true on success, false on error
+     */
+    bool start_stream(int32_t start_frame,
+                      int32_t num_frames,
+                      int32_t expected_width,
+                      int32_t expected_height,
+                      const VideoParameters& params,
+                      std::string& error_message,
+                      size_t prefetch_frames = DEFAULT_PREFETCH_FRAMES);
+    
+    /**
+     * @brief Take the next frame from the stream
+     * 
+     * Blocks until the reader has a frame ready. The previous contents of
+     * @p frame are recycled by the reader, so passing the same few buffers
+     * back in avoids reallocating every frame.
+     * 
+     * @param frame Output frame buffer in YUV444P16 format
+     * @param error_message Error message on failure (left empty at end of stream)
+     * @return true if a frame was returned, false at end of stream or on error
+     */
+    bool next_frame(FrameBuffer& frame, std::string& error_message);
+    
+    /**
+     * @brief Stop the reader thread and discard any queued frames
+     */
+    void stop_stream();
 
 protected:
     int32_t width_ = 0;
@@ -247,6 +309,51 @@ protected:
     int32_t frame_count_ = -1;
     double frame_rate_ = 0.0;
     bool is_open_ = false;
+    
+    /**
+     * @brief Begin decoding a frame range (called on the caller's thread)
+     * 
+     * The default implementation reports that streaming is not supported.
+     */
+    virtual bool open_frame_stream(int32_t start_frame, int32_t num_frames,
+                                   std::string& error_message);
+    
+    /**
+     * @brief Decode the next frame (called on the reader thread)
+     * 
+     * @param frame Output frame buffer (may hold a recycled frame)
+     * @param end_of_stream Set to true when no further frames are available
+     * @param error_message Error message if reading fails
+     * @return true on success or end of stream, false on error
+     */
+    virtual bool read_stream_frame(FrameBuffer& frame, bool& end_of_stream,
+                                   std::string& error_message);
+    
+    /**
+     * @brief Release decoding resources (called on the reader thread)
+     * 
+     * @param complete true if every frame was read, false if the stream was
+     *        stopped early or failed (decoder exit status should then be ignored)
+     * @param error_message Error message if the decoder reported a failure
+     * @return true on success, false on error
+     */
+    virtual bool close_frame_stream(bool complete, std::string& error_message);
+
+private:
+    // Streaming state (queue and flags guarded by stream_mutex_)
+    std::thread stream_thread_;
+    std::mutex stream_mutex_;
+    std::condition_variable stream_ready_;
+    std::condition_variable stream_space_;
+    std::deque<FrameBuffer> stream_queue_;
+    std::vector<FrameBuffer> stream_free_;
+    size_t stream_depth_ = DEFAULT_PREFETCH_FRAMES;
+    int32_t stream_num_frames_ = 0;
+    bool stream_stopping_ = false;
+    bool stream_finished_ = false;
+    std::string stream_error_;
+    
+    void stream_reader_loop();
 };
 
 } // namespace encode_orc
@@ -75,6 +75,27 @@ struct VideoParameters {
     bool is_mapped = false;              // true if processed by ld-discmap
     bool is_widescreen = false;          // true for 16:9, false for 4:3
     
+    /**
+     * @brief Check whether two parameter sets describe the same signal
+     * 
+     * Compares timing, geometry and levels (everything an encoder derives
+     * state from); decoder name and informational flags are ignored.
+     */
+    bool has_same_signal_format(const VideoParameters& other) const {
+        return system == other.system &&
+               fSC == other.fSC &&
+               sample_rate == other.sample_rate &&
+               field_width == other.field_width &&
+               field_height == other.field_height &&
+               active_video_start == other.active_video_start &&
+               active_video_end == other.active_video_end &&
+               colour_burst_start == other.colour_burst_start &&
+               colour_burst_end == other.colour_burst_end &&
+               white_16b_ire == other.white_16b_ire &&
+               black_16b_ire == other.black_16b_ire &&
+               blanking_16b_ire == other.blanking_16b_ire;
+    }
+    
     /**
      * @brief Initialize PAL parameters (subcarrier-locked)
      */
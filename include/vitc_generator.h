@@ -11,6 +11,7 @@
 #define ENCODE_ORC_VITC_GENERATOR_H
 
 #include "video_parameters.h"
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -25,6 +26,10 @@ namespace encode_orc {
  * - Biphase-mark waveform: mandatory mid-bit transition every bit; additional boundary transition only for logical 1
  * - Bit period 0.5517 µs; rise/fall ~200 ns; levels blanking to blanking+550 mV
  * - Start after colour burst and ≥11.2 µs from sync; end ≤1.9 µs before next sync
+ *
+ * The four possible bit cells (steady low, steady high, rising, falling) are
+ * rendered once at construction, so drawing a line is a run of copies with
+ * no allocation or trigonometry.
  */
 class VITCGenerator {
 public:
@@ -43,6 +48,23 @@ public:
                        int32_t line_number,
                        bool is_second_field) const;
 
+    /**
+     * @brief Render the same VITC word into several lines of a field
+     *
+     * Both VITC lines of a field carry the same timecode, so the word is
+     * built once and drawn into each line.
+     * @param system Video system (PAL/NTSC) for frame-rate and phase flags.
+     * @param total_frame Frame index (0-based) to encode into the timecode.
+     * @param line_buffers Output buffers (already contain sync/burst/blanking).
+     * @param line_count Number of entries in line_buffers.
+     * @param is_second_field True for the second field of the frame.
+     */
+    void generate_lines(VideoSystem system,
+                        int32_t total_frame,
+                        uint16_t* const* line_buffers,
+                        int32_t line_count,
+                        bool is_second_field) const;
+
     // Get the 90 raw VITC bits without waveform rendering (for testing/debugging)
     void get_vitc_bits(VideoSystem system,
                        int32_t total_frame,
@@ -63,12 +85,20 @@ private:
     uint16_t low_level_;             // Blanking level
     uint16_t high_level_;            // Blanking +550 mV level
 
+    static constexpr int32_t TOTAL_BITS = 90;
+    using Bits = std::array<uint8_t, TOTAL_BITS>;
+
+    // Bit cells indexed by [previous bit][bit]: steady low, rising, falling, steady high
+    std::array<std::vector<uint16_t>, 4> cells_;
+
     void build_vitc_bits(VideoSystem system,
                          int32_t total_frame,
                          bool is_second_field,
-                         std::vector<uint8_t>& bits) const;
-    static uint8_t compute_crc(const std::vector<uint8_t>& bits);
-    void render_nrz(const std::vector<uint8_t>& bits, uint16_t* line_buffer) const;
+                         Bits& bits) const;
+    static uint8_t compute_crc(const Bits& bits);
+    void render_nrz(const Bits& bits, uint16_t* line_buffer) const;
+    static void write_transition(uint16_t* line_buffer, int32_t ramp_len,
+                                 uint16_t from_level, uint16_t to_level);
 };
 
 } // namespace encode_orc
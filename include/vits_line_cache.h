@@ -0,0 +1,77 @@
+/*
+ * File:        vits_line_cache.h
+ * Module:      encode-orc
+ * Purpose:     Cache of rendered VITS lines by test signal and colour-sequence position
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#ifndef ENCODE_ORC_VITS_LINE_CACHE_H
+#define ENCODE_ORC_VITS_LINE_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace encode_orc {
+
+/**
+ * @brief Rendered test signals, keyed by (signal, field in the colour sequence)
+ *
+ * A VITS line only depends on which test signal it carries and the field's
+ * position in the colour-framing sequence, so each one is rendered once,
+ * on first use, and copied after that.
+ *
+ * Some signals draw over the line the encoder has already laid down (the
+ * NTSC VIR only writes its reference levels). The first render therefore
+ * runs twice, over two different backgrounds, and only the samples both
+ * agree on are treated as part of the signal. Drawing a cached line writes
+ * just those samples, exactly as rendering it would.
+ *
+ * Not thread-safe: each VITS generator owns its cache.
+ */
+class VITSLineCache {
+public:
+    /**
+     * @brief Renders one test signal into a line
+     *
+     * Must only write to the line, never read it.
+     */
+    using Renderer = std::function<void(int32_t signal, uint16_t* line_buffer, int32_t field_number)>;
+
+    /**
+     * @brief Create an empty cache
+     * @param line_width Samples per line
+     * @param num_signals Number of distinct test signals
+     * @param sequence_fields Fields before the signals repeat (the colour sequence)
+     * @param renderer Renders a signal
+     */
+    VITSLineCache(int32_t line_width, int32_t num_signals, int32_t sequence_fields, Renderer renderer);
+
+    /**
+     * @brief Draw a test signal into a line, rendering it on first use
+     * @param signal Test signal (0 to num_signals - 1)
+     * @param line_buffer Destination (line_width samples)
+     * @param field_number Field number (any non-negative value)
+     */
+    void draw(int32_t signal, uint16_t* line_buffer, int32_t field_number);
+
+private:
+    struct Entry {
+        std::vector<uint16_t> samples;                    // Rendered line
+        std::vector<std::pair<int32_t, int32_t>> runs;    // [begin, end) spans the signal writes
+        bool built = false;
+    };
+
+    int32_t line_width_;
+    int32_t num_signals_;
+    int32_t sequence_fields_;
+    Renderer renderer_;
+    std::vector<Entry> entries_;   // [field in sequence][signal]
+};
+
+} // namespace encode_orc
+
+#endif // ENCODE_ORC_VITS_LINE_CACHE_H
@@ -160,6 +160,7 @@ struct OutputConfig {
     std::string mode = "combined";  // combined (default), separate-yc
     std::string metadata_decoder = "encode-orc";  // decoder string in metadata (default: encode-orc)
     std::optional<VideoLevelsConfig> video_levels;  // Optional: override video signal levels
+    std::optional<int32_t> threads;  // Optional: encoding threads (0 = one per CPU, default)
 };
 
 /**
@@ -57,48 +57,32 @@ public:
      * @return true on success, false on failure
      */
     bool open(const std::string& base_filename) {
-        close();
-        
-        // Determine file extensions based on naming mode
-        std::string y_filename;
-        std::string c_filename;
-        
-        if (naming_mode_ == NamingMode::LEGACY) {
-            // Legacy: base.tbc and base_chroma.tbc
-            y_filename = base_filename + ".tbc";
-            c_filename = base_filename + "_chroma.tbc";
-        } else {
-            // Modern: base.tbcy and base.tbcc
-            y_filename = base_filename + ".tbcy";
-            c_filename = base_filename + ".tbcc";
-        }
-        
-        y_writer_ = std::make_unique<TBCWriter>();
-        c_writer_ = std::make_unique<TBCWriter>();
-        
-        if (!y_writer_->open(y_filename)) {
-            return false;
-        }
-        
-        if (!c_writer_->open(c_filename)) {
-            y_writer_->close();
-            return false;
-        }
-        
-        base_filename_ = base_filename;
-        return true;
+        return open_files(base_filename, -1);
+    }
+    
+    /**
+     * @brief Open existing Y and C TBC files for writing from a byte offset onwards
+     * @param base_filename Base path without extension (e.g., "output/video")
+     * @param offset Byte offset of the first field written (the same in both files)
+     * @return true on success, false on failure
+     */
+    bool open_at(const std::string& base_filename, int64_t offset) {
+        return open_files(base_filename, offset);
     }
     
     /**
      * @brief Close both Y and C TBC files
+     * @return true if all buffered data was written, false on failure
      */
-    void close() {
+    bool close() {
+        bool ok = true;
         if (y_writer_) {
-            y_writer_->close();
+            ok = y_writer_->close() && ok;
         }
         if (c_writer_) {
-            c_writer_->close();
+            ok = c_writer_->close() && ok;
         }
+        return ok;
     }
     
     /**
@@ -140,6 +124,26 @@ public:
         return c_writer_->write_field(field);
     }
     
+    /**
+     * @brief Paths of the Y and C files for a base filename
+     * @param base_filename Base path without extension
+     * @param mode Naming convention
+     * @param y_filename Set to the luma file path
+     * @param c_filename Set to the chroma file path
+     */
+    static void filenames_for(const std::string& base_filename, NamingMode mode,
+                              std::string& y_filename, std::string& c_filename) {
+        if (mode == NamingMode::LEGACY) {
+            // Legacy: base.tbc and base_chroma.tbc
+            y_filename = base_filename + ".tbc";
+            c_filename = base_filename + "_chroma.tbc";
+        } else {
+            // Modern: base.tbcy and base.tbcc
+            y_filename = base_filename + ".tbcy";
+            c_filename = base_filename + ".tbcc";
+        }
+    }
+    
     /**
      * @brief Get Y writer
      */
@@ -155,6 +159,30 @@ private:
     std::unique_ptr<TBCWriter> c_writer_;
     std::string base_filename_;
     NamingMode naming_mode_ = NamingMode::MODERN;
+    
+    // Offset < 0 creates (truncates) the files, otherwise opens them at offset
+    bool open_files(const std::string& base_filename, int64_t offset) {
+        close();
+        
+        std::string y_filename;
+        std::string c_filename;
+        filenames_for(base_filename, naming_mode_, y_filename, c_filename);
+        
+        y_writer_ = std::make_unique<TBCWriter>();
+        c_writer_ = std::make_unique<TBCWriter>();
+        
+        if (!(offset < 0 ? y_writer_->open(y_filename) : y_writer_->open_at(y_filename, offset))) {
+            return false;
+        }
+        
+        if (!(offset < 0 ? c_writer_->open(c_filename) : c_writer_->open_at(c_filename, offset))) {
+            y_writer_->close();
+            return false;
+        }
+        
+        base_filename_ = base_filename;
+        return true;
+    }
 };
 
 } // namespace encode_orc
@@ -8,7 +8,7 @@
  */
 
 #include "biphase_encoder.h"
-#include "manchester_encoder.h"
+#include <algorithm>
 #include <cmath>
 
 namespace encode_orc {
@@ -18,6 +18,34 @@ static constexpr double BIT_DURATION_US = 2.0;  // 2.0 µs per bit
 static constexpr int32_t TOTAL_BITS = 24;       // 24 bits total
 static constexpr double RISE_FALL_TIME_NS = 225.0;  // 225 ns rise/fall time
 
+static int32_t samples_per_bit_for(double sample_rate) {
+    return static_cast<int32_t>(sample_rate * BIT_DURATION_US * 1e-6);
+}
+
+static int32_t rise_fall_samples_for(double sample_rate) {
+    return std::max(1, static_cast<int32_t>(sample_rate * RISE_FALL_TIME_NS * 1e-9));
+}
+
+BiphaseEncoder::BiphaseEncoder(double sample_rate,
+                               double line_period_h,
+                               uint16_t high_level,
+                               uint16_t low_level)
+    : cells_(samples_per_bit_for(sample_rate), low_level, high_level, rise_fall_samples_for(sample_rate)),
+      start_position_(get_signal_start_position(sample_rate, line_period_h)) {
+}
+
+void BiphaseEncoder::render(uint32_t value, uint16_t* line_buffer, int32_t buffer_size) const {
+    cells_.render(value & 0xFFFFFF, TOTAL_BITS, start_position_, line_buffer, buffer_size);
+}
+
+void BiphaseEncoder::render_lines(const std::array<uint32_t, 3>& values,
+                                  const std::array<uint16_t*, 3>& lines,
+                                  int32_t buffer_size) const {
+    for (size_t i = 0; i < values.size(); ++i) {
+        render(values[i], lines[i], buffer_size);
+    }
+}
+
 std::vector<uint16_t> BiphaseEncoder::encode(uint8_t byte0,
                                              uint8_t byte1,
                                              uint8_t byte2,
@@ -30,22 +58,15 @@ std::vector<uint16_t> BiphaseEncoder::encode(uint8_t byte0,
                      static_cast<uint32_t>(byte2);
     
     // Total signal duration: 24 bits × 2.0 µs = 48 µs
-    int32_t samples_per_bit = static_cast<int32_t>(sample_rate * BIT_DURATION_US * 1e-6);
+    int32_t samples_per_bit = samples_per_bit_for(sample_rate);
     int32_t total_samples = samples_per_bit * TOTAL_BITS;
-    int32_t rise_fall_samples = static_cast<int32_t>(sample_rate * RISE_FALL_TIME_NS * 1e-9);
-    if (rise_fall_samples < 1) rise_fall_samples = 1;
+    int32_t rise_fall_samples = rise_fall_samples_for(sample_rate);
     
     std::vector<uint16_t> signal(total_samples);
     
-    // Convert 24-bit value to bit vector (MSB first)
-    std::vector<uint8_t> bits;
-    for (int32_t bit_index = TOTAL_BITS - 1; bit_index >= 0; --bit_index) {
-        bits.push_back((value >> bit_index) & 1);
-    }
-    
-    // Use shared Manchester encoder to render the bits
-    ManchesterEncoder::render_bits(bits, 0, samples_per_bit, low_level, high_level,
-                                   rise_fall_samples, signal.data(), total_samples);
+    // Render the bits MSB first from the shared Manchester bit cells
+    ManchesterBitCells cells(samples_per_bit, low_level, high_level, rise_fall_samples);
+    cells.render(value, TOTAL_BITS, 0, signal.data(), total_samples);
     
     return signal;
 }
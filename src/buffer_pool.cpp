@@ -0,0 +1,67 @@
+/*
+ * File:        buffer_pool.cpp
+ * Module:      encode-orc
+ * Purpose:     Aligned sample storage and recycled buffer pools
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "buffer_pool.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace encode_orc {
+
+namespace {
+
+std::atomic<bool> s_huge_pages{false};
+
+size_t round_up(size_t bytes, size_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+void* SampleStorage::allocate(size_t bytes) {
+    size_t alignment = ALIGNMENT;
+    if (s_huge_pages.load(std::memory_order_relaxed) && bytes >= HUGE_PAGE_SIZE) {
+        alignment = HUGE_PAGE_SIZE;
+    }
+
+    // aligned_alloc needs a size that is a multiple of the alignment
+    const size_t size = round_up(bytes > 0 ? bytes : 1, alignment);
+    void* block = std::aligned_alloc(alignment, size);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (alignment == HUGE_PAGE_SIZE) {
+        // Only a hint: without transparent huge pages the block stays on
+        // normal pages
+        madvise(block, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return block;
+}
+
+void SampleStorage::deallocate(void* block) noexcept {
+    std::free(block);
+}
+
+void SampleStorage::set_huge_pages(bool enabled) {
+    s_huge_pages.store(enabled);
+}
+
+bool SampleStorage::huge_pages_enabled() {
+    return s_huge_pages.load();
+}
+
+} // namespace encode_orc
@@ -0,0 +1,332 @@
+/*
+ * File:        buffered_tbc_file.cpp
+ * Module:      encode-orc
+ * Purpose:     Buffered, batched file backend for TBC sample output
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "buffered_tbc_file.h"
+#include "logging.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/statvfs.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace encode_orc {
+
+namespace {
+
+std::atomic<bool> s_default_direct_io{false};
+
+bool host_is_little_endian() {
+    const uint16_t probe = 1;
+    uint8_t first_byte;
+    std::memcpy(&first_byte, &probe, 1);
+    return first_byte == 1;
+}
+
+const bool s_little_endian = host_is_little_endian();
+
+int sync_data(int fd) {
+#if defined(__linux__)
+    return ::fdatasync(fd);
+#else
+    return ::fsync(fd);
+#endif
+}
+
+} // namespace
+
+BufferedTBCFile::BufferedTBCFile(size_t buffer_bytes)
+    : capacity_(std::max(BLOCK_ALIGNMENT,
+                         (buffer_bytes + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT)) {
+}
+
+BufferedTBCFile::~BufferedTBCFile() {
+    close();
+}
+
+void BufferedTBCFile::set_default_direct_io(bool enabled) {
+    s_default_direct_io.store(enabled);
+}
+
+bool BufferedTBCFile::default_direct_io() {
+    return s_default_direct_io.load();
+}
+
+bool BufferedTBCFile::open(const std::string& filename) {
+    return open_file(filename, O_WRONLY | O_CREAT | O_TRUNC, 0, default_direct_io());
+}
+
+bool BufferedTBCFile::open_at(const std::string& filename, int64_t offset) {
+    return open_file(filename, O_WRONLY | O_CREAT, offset, false);
+}
+
+bool BufferedTBCFile::open_file(const std::string& filename, int flags, int64_t offset, bool allow_direct_io) {
+    close();
+
+    filename_ = filename;
+    error_.clear();
+    failed_ = false;
+    staged_ = 0;
+    position_ = 0;
+    write_offset_ = offset;
+    stats_ = Stats();
+    direct_io_ = false;
+
+    if (!buffer_) {
+        buffer_.reset(static_cast<uint8_t*>(std::aligned_alloc(BLOCK_ALIGNMENT, capacity_)));
+        if (!buffer_) {
+            error_ = "Failed to allocate output buffer";
+            return false;
+        }
+    }
+
+#ifdef O_DIRECT
+    if (allow_direct_io) {
+        fd_ = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+        if (fd_ >= 0) {
+            direct_io_ = true;
+        } else {
+            ENCODE_ORC_LOG_DEBUG("Direct I/O not available for {} ({}), using buffered writes",
+                                 filename, std::strerror(errno));
+        }
+    }
+#else
+    (void)allow_direct_io;
+#endif
+    if (fd_ < 0) {
+        fd_ = ::open(filename.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+        error_ = "Cannot open " + filename + ": " + std::strerror(errno);
+        return false;
+    }
+
+    return true;
+}
+
+bool BufferedTBCFile::preallocate(int64_t bytes) {
+    if (fd_ < 0) {
+        error_ = "TBC file is not open";
+        return false;
+    }
+
+#if defined(__linux__)
+    if (::fallocate(fd_, 0, 0, static_cast<off_t>(bytes)) == 0) {
+        return true;
+    }
+    if (errno == ENOSPC) {
+        std::string message = "Not enough disk space for " + filename_ + " (" +
+                              std::to_string(bytes / 1000000) + " MB needed";
+        struct statvfs fs;
+        if (::fstatvfs(fd_, &fs) == 0) {
+            const uint64_t available = static_cast<uint64_t>(fs.f_bavail) * fs.f_frsize;
+            message += ", " + std::to_string(available / 1000000) + " MB available";
+        }
+        fail(message + ")");
+        return false;
+    }
+    if (errno != EOPNOTSUPP && errno != ENOSYS) {
+        fail("Failed to allocate " + filename_ + ": " + std::strerror(errno));
+        return false;
+    }
+    ENCODE_ORC_LOG_DEBUG("fallocate not supported for {}, extending the file instead", filename_);
+#endif
+
+    if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+        fail("Failed to resize " + filename_ + ": " + std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool BufferedTBCFile::close() {
+    if (fd_ < 0) {
+        return !failed_;
+    }
+
+    // A direct-I/O tail goes out only now, through the page cache, so it is
+    // synced here: once close() returns the whole file is on disk
+    const bool direct_tail = direct_io_ && staged_ > 0;
+    if (flush_staged(true) && direct_tail && sync_data(fd_) != 0) {
+        fail("Failed to sync " + filename_ + ": " + std::strerror(errno));
+    }
+
+    if (::close(fd_) != 0) {
+        fail("Failed to close " + filename_ + ": " + std::strerror(errno));
+    }
+    fd_ = -1;
+
+    if (stats_.bytes_written > 0) {
+        ENCODE_ORC_LOG_DEBUG("Wrote {:.1f} MB to {} in {} write calls ({:.0f} MB/s{})",
+                             static_cast<double>(stats_.bytes_written) / 1.0e6, filename_,
+                             stats_.write_calls, stats_.throughput_mb_per_second(),
+                             direct_io_ ? ", direct I/O" : "");
+    }
+
+    return !failed_;
+}
+
+bool BufferedTBCFile::write_samples(const uint16_t* samples, size_t count) {
+    if (fd_ < 0 || failed_) {
+        if (error_.empty()) {
+            error_ = "TBC file is not open";
+        }
+        return false;
+    }
+
+    const size_t bytes = count * sizeof(uint16_t);
+    position_ += static_cast<int64_t>(bytes);
+
+    // Samples are already in file order, so anything that overflows the
+    // buffer goes out with the staged data in one gathered write
+    if (s_little_endian && !direct_io_ && staged_ + bytes > capacity_) {
+        struct iovec vectors[2];
+        vectors[0].iov_base = buffer_.get();
+        vectors[0].iov_len = staged_;
+        vectors[1].iov_base = const_cast<uint16_t*>(samples);
+        vectors[1].iov_len = bytes;
+        staged_ = 0;
+        return write_vectors(vectors, 2);
+    }
+
+    while (count > 0) {
+        const size_t chunk = std::min(count, (capacity_ - staged_) / sizeof(uint16_t));
+        stage(samples, chunk);
+        samples += chunk;
+        count -= chunk;
+
+        if (staged_ == capacity_ && !flush_staged(false)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BufferedTBCFile::flush() {
+    if (fd_ < 0) {
+        return !failed_;
+    }
+    return flush_staged(false);
+}
+
+bool BufferedTBCFile::sync() {
+    if (!flush()) {
+        return false;
+    }
+    if (fd_ < 0) {
+        return true;
+    }
+
+    if (sync_data(fd_) != 0) {
+        fail("Failed to sync " + filename_ + ": " + std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void BufferedTBCFile::stage(const uint16_t* samples, size_t count) {
+    uint8_t* out = buffer_.get() + staged_;
+    if (s_little_endian) {
+        std::memcpy(out, samples, count * sizeof(uint16_t));
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            out[i * 2] = static_cast<uint8_t>(samples[i] & 0xFF);
+            out[i * 2 + 1] = static_cast<uint8_t>(samples[i] >> 8);
+        }
+    }
+    staged_ += count * sizeof(uint16_t);
+}
+
+bool BufferedTBCFile::flush_staged(bool final) {
+    if (staged_ == 0 || failed_) {
+        return !failed_;
+    }
+
+    size_t to_write = staged_;
+    if (direct_io_) {
+        if (final) {
+#ifdef O_DIRECT
+            // The tail is not a whole block; finish it through the page cache
+            if (staged_ % BLOCK_ALIGNMENT != 0) {
+                int flags = fcntl(fd_, F_GETFL);
+                if (flags == -1 || fcntl(fd_, F_SETFL, flags & ~O_DIRECT) == -1) {
+                    fail("Failed to leave direct I/O mode for " + filename_ + ": " + std::strerror(errno));
+                    return false;
+                }
+            }
+#endif
+        } else {
+            to_write = staged_ / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+            if (to_write == 0) {
+                return true;
+            }
+        }
+    }
+
+    struct iovec vector;
+    vector.iov_base = buffer_.get();
+    vector.iov_len = to_write;
+    if (!write_vectors(&vector, 1)) {
+        return false;
+    }
+
+    // Keep any unaligned remainder at the front of the buffer
+    staged_ -= to_write;
+    if (staged_ > 0) {
+        std::memmove(buffer_.get(), buffer_.get() + to_write, staged_);
+    }
+    return true;
+}
+
+bool BufferedTBCFile::write_vectors(struct iovec* vectors, int count) {
+    auto start = std::chrono::steady_clock::now();
+
+    while (count > 0) {
+        ssize_t written = ::pwritev(fd_, vectors, count, static_cast<off_t>(write_offset_));
+        ++stats_.write_calls;
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fail("Failed to write " + filename_ + ": " + std::strerror(errno));
+            return false;
+        }
+        stats_.bytes_written += static_cast<uint64_t>(written);
+        write_offset_ += written;
+
+        // Skip past whatever was written (writes may be partial)
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= vectors->iov_len) {
+            remaining -= vectors->iov_len;
+            ++vectors;
+            --count;
+        }
+        if (count > 0) {
+            vectors->iov_base = static_cast<uint8_t*>(vectors->iov_base) + remaining;
+            vectors->iov_len -= remaining;
+        }
+    }
+
+    stats_.write_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void BufferedTBCFile::fail(const std::string& message) {
+    if (!failed_) {
+        failed_ = true;
+        error_ = message;
+    }
+}
+
+} // namespace encode_orc
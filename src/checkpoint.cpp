@@ -0,0 +1,185 @@
+/*
+ * File:        checkpoint.cpp
+ * Module:      encode-orc
+ * Purpose:     Resume checkpoint recording how much of each section is on disk
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "checkpoint.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace encode_orc {
+
+namespace {
+
+// First line of every checkpoint file; bump the number if the format changes
+const char* const CHECKPOINT_HEADER = "encode-orc checkpoint 1";
+
+} // namespace
+
+Checkpoint::Checkpoint(const std::string& output_filename, uint64_t fingerprint, size_t section_count)
+    : filename_(filename_for(output_filename)),
+      fingerprint_(fingerprint),
+      section_fields_(section_count, 0) {
+}
+
+std::string Checkpoint::filename_for(const std::string& output_filename) {
+    return output_filename + ".checkpoint";
+}
+
+uint64_t Checkpoint::fingerprint(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool Checkpoint::exists() const {
+    std::error_code error;
+    return std::filesystem::exists(filename_, error);
+}
+
+bool Checkpoint::load(std::string& error_message) {
+    std::ifstream file(filename_);
+    if (!file) {
+        error_message = "Cannot read checkpoint " + filename_;
+        return false;
+    }
+
+    std::string header;
+    std::getline(file, header);
+    if (header != CHECKPOINT_HEADER) {
+        error_message = filename_ + " is not an encode-orc checkpoint";
+        return false;
+    }
+
+    std::string key;
+    uint64_t fingerprint = 0;
+    size_t section_count = 0;
+    if (!(file >> key >> std::hex >> fingerprint >> std::dec) || key != "fingerprint" ||
+        !(file >> key >> section_count) || key != "sections") {
+        error_message = "Checkpoint " + filename_ + " is damaged";
+        return false;
+    }
+    if (fingerprint != fingerprint_ || section_count != section_fields_.size()) {
+        error_message = "Checkpoint " + filename_ +
+                        " was written for a different project, build or settings";
+        return false;
+    }
+
+    std::vector<int64_t> section_fields(section_count, 0);
+    for (auto& fields : section_fields) {
+        if (!(file >> fields) || fields < 0) {
+            error_message = "Checkpoint " + filename_ + " is damaged";
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    section_fields_ = std::move(section_fields);
+    return true;
+}
+
+int64_t Checkpoint::section_fields(size_t section) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return section_fields_[section];
+}
+
+void Checkpoint::set_section_fields(size_t section, int64_t fields) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    section_fields_[section] = fields;
+}
+
+int64_t Checkpoint::total_fields() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t total = 0;
+    for (int64_t fields : section_fields_) {
+        total += fields;
+    }
+    return total;
+}
+
+bool Checkpoint::save(std::string& error_message) {
+    // Sections may save concurrently; one writer at a time keeps the
+    // temporary file intact and the newest progress last
+    std::lock_guard<std::mutex> save_lock(save_mutex_);
+
+    std::ostringstream text;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        text << CHECKPOINT_HEADER << "\n";
+        text << "fingerprint " << std::hex << fingerprint_ << std::dec << "\n";
+        text << "sections " << section_fields_.size() << "\n";
+        for (int64_t fields : section_fields_) {
+            text << fields << "\n";
+        }
+    }
+
+    // The data reaches the disk before the rename and the rename before
+    // save() returns, so after a power cut the checkpoint is either the
+    // old one or the new one, never a short file
+    const std::string temp_filename = filename_ + ".tmp";
+    const std::string contents = text.str();
+    const int fd = ::open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error_message = "Cannot write checkpoint " + temp_filename + ": " + std::strerror(errno);
+        return false;
+    }
+    size_t written = 0;
+    while (written < contents.size()) {
+        const ssize_t result = ::write(fd, contents.data() + written, contents.size() - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            error_message = "Cannot write checkpoint " + temp_filename + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    if (::fsync(fd) != 0) {
+        error_message = "Cannot sync checkpoint " + temp_filename + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    if (std::rename(temp_filename.c_str(), filename_.c_str()) != 0) {
+        error_message = "Cannot replace checkpoint " + filename_ + ": " + std::strerror(errno);
+        return false;
+    }
+
+    // Make the rename itself durable
+    std::string directory = std::filesystem::path(filename_).parent_path().string();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    const int directory_fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory_fd < 0 || ::fsync(directory_fd) != 0) {
+        error_message = "Cannot sync directory " + directory + ": " + std::strerror(errno);
+        if (directory_fd >= 0) {
+            ::close(directory_fd);
+        }
+        return false;
+    }
+    ::close(directory_fd);
+    return true;
+}
+
+void Checkpoint::remove() {
+    std::remove(filename_.c_str());
+}
+
+} // namespace encode_orc
@@ -11,8 +11,9 @@
 
 namespace encode_orc {
 
-ColorBurstGenerator::ColorBurstGenerator(const VideoParameters& params)
-    : params_(params) {
+ColorBurstGenerator::ColorBurstGenerator(const VideoParameters& params, const SubcarrierTable& subcarrier)
+    : params_(params),
+      subcarrier_(subcarrier) {
     
     // Set signal levels
     sync_level_ = 0x0000;  // Sync tip at 0V
@@ -24,52 +25,6 @@ ColorBurstGenerator::ColorBurstGenerator(const VideoParameters& params)
     sample_rate_ = params_.sample_rate;
 }
 
-double ColorBurstGenerator::calculate_ntsc_phase(int32_t field_number, int32_t line_number, int32_t sample) const {
-    // NTSC has 262.5 lines per field. Model absolute line count as a double
-    // to preserve the half-line offset between fields, which produces the
-    // 4-field color framing sequence (±90° per field).
-    const double lines_per_field = 262.5;
-    const double cycles_per_line = 227.5;  // NTSC subcarrier cycles per line
-
-    // Absolute lines elapsed before this line within the full sequence
-    double prev_lines = static_cast<double>(field_number) * lines_per_field + static_cast<double>(line_number);
-
-    // Total subcarrier cycles elapsed before this sample
-    double prev_cycles = prev_lines * cycles_per_line;
-
-    // Time term for this sample position within the line
-    double time_phase = 2.0 * PI * subcarrier_freq_ * static_cast<double>(sample) / sample_rate_;
-    return 2.0 * PI * prev_cycles + time_phase;
-}
-
-double ColorBurstGenerator::calculate_pal_phase(int32_t field_number, int32_t line_number, int32_t sample) const {
-    // Calculate absolute line number in PAL 8-field sequence
-    bool is_first_field = (field_number % 2) == 0;
-    int32_t frame_line = is_first_field ? (line_number * 2 + 1) : (line_number * 2 + 2);
-    
-    int32_t field_id = field_number % 8;
-    int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-    
-    // PAL: 283.7516 subcarrier cycles per line
-    double prev_cycles = prev_lines * 283.7516;
-    
-    // Phase for this sample
-    double time_phase = 2.0 * PI * subcarrier_freq_ * sample / sample_rate_;
-    return 2.0 * PI * prev_cycles + time_phase;
-}
-
-int32_t ColorBurstGenerator::get_pal_v_switch(int32_t field_number, int32_t line_number) const {
-    // Calculate absolute line number
-    bool is_first_field = (field_number % 2) == 0;
-    int32_t frame_line = is_first_field ? (line_number * 2 + 1) : (line_number * 2 + 2);
-    
-    int32_t field_id = field_number % 8;
-    int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-    
-    // V-switch alternates every line
-    return (prev_lines % 2) == 0 ? 1 : -1;
-}
-
 double ColorBurstGenerator::calculate_envelope(int32_t sample, int32_t burst_start, int32_t burst_end,
                                                double rise_time_ns, double fall_time_ns) const {
     // Convert time to samples
@@ -128,7 +83,8 @@ void ColorBurstGenerator::generate_ntsc_burst(uint16_t* line_buffer, int32_t lin
     int32_t burst_end = params_.colour_burst_end;
     
     // NTSC burst phase is fixed at 180°
-    double burst_phase_offset = PI;
+    const SubcarrierTable::LinePhase burst_phase =
+        subcarrier_.line_phase(field_number, line_number).shifted(0.0, -1.0);
     
     // Envelope shaping: 3 cycles rise/fall with cosine S-curve
     double cycle_time_ns = (1.0 / subcarrier_freq_) * 1e9;
@@ -159,8 +115,7 @@ void ColorBurstGenerator::generate_ntsc_burst(uint16_t* line_buffer, int32_t lin
     
     // Generate burst with envelope and write with center offset
     for (int32_t sample = std::max(0, rise_start); sample < std::min(static_cast<int32_t>(params_.field_width), fall_end); ++sample) {
-        double phase = calculate_ntsc_phase(field_number, line_number, sample) + burst_phase_offset;
-        double burst_signal = std::sin(phase);
+        double burst_signal = subcarrier_.sin_at(burst_phase, sample);
         
         // Apply envelope shaping
         double envelope = 0.0;
@@ -195,13 +150,10 @@ void ColorBurstGenerator::generate_pal_burst(uint16_t* line_buffer, int32_t line
     int32_t burst_start = params_.colour_burst_start;
     int32_t burst_end = params_.colour_burst_end;
     
-    // Calculate PAL phase with V-switch
-    bool is_first_field = (field_number % 2) == 0;
-    int32_t frame_line = is_first_field ? (line_number * 2 + 1) : (line_number * 2 + 2);
-    int32_t field_id = field_number % 8;
-    int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-    int32_t v_switch = (prev_lines % 2 == 0) ? 1 : -1;
-    double burst_phase_offset = v_switch * (135.0 * PI / 180.0);
+    // PAL burst swings between +135° and -135° with the V-switch
+    const SubcarrierTable::LinePhase line_phase = subcarrier_.line_phase(field_number, line_number);
+    const double sin_135 = std::sqrt(0.5);
+    const SubcarrierTable::LinePhase burst_phase = line_phase.shifted(line_phase.v_switch * sin_135, -sin_135);
     
     // Envelope shaping: 3 cycles rise/fall with cosine S-curve
     double cycle_time_ns = (1.0 / subcarrier_freq_) * 1e9;
@@ -232,8 +184,7 @@ void ColorBurstGenerator::generate_pal_burst(uint16_t* line_buffer, int32_t line
     
     // Generate burst with envelope and write with center offset
     for (int32_t sample = std::max(0, rise_start); sample < std::min(static_cast<int32_t>(params_.field_width), fall_end); ++sample) {
-        double phase = calculate_pal_phase(field_number, line_number, sample) + burst_phase_offset;
-        double burst_signal = std::sin(phase);
+        double burst_signal = subcarrier_.sin_at(burst_phase, sample);
         
         // Apply envelope shaping
         double envelope = 0.0;
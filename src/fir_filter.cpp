@@ -0,0 +1,710 @@
+/*
+ * File:        fir_filter.cpp
+ * Module:      encode-orc
+ * Purpose:     FIR filter kernels (scalar, SSE4.1, AVX2) with CPU dispatch
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "fir_filter.h"
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// Vector kernels are built with per-function target attributes so the rest of
+// the program still runs on any x86-64 CPU; other targets use the scalar path
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ENCODE_ORC_FIR_X86 1
+#include <immintrin.h>
+#define ENCODE_ORC_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace encode_orc {
+
+namespace {
+
+std::atomic<FIRFilter::Precision> s_default_precision{FIRFilter::Precision::Exact};
+std::atomic<bool> s_verification{false};
+
+enum class InstructionSet {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+InstructionSet detect_instruction_set() {
+#ifdef ENCODE_ORC_FIR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return InstructionSet::SSE41;
+    }
+#endif
+    return InstructionSet::Scalar;
+}
+
+// Highest instruction set the CPU supports
+InstructionSet supported_instruction_set() {
+    static const InstructionSet instruction_set = detect_instruction_set();
+    return instruction_set;
+}
+
+// Set by FIRFilter::set_instruction_set() to hold the kernels below the CPU's best
+std::atomic<InstructionSet> s_instruction_set{supported_instruction_set()};
+
+InstructionSet active_instruction_set() {
+    return s_instruction_set.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Tap views shared by all kernels
+ */
+struct Taps {
+    const double* exact;
+    const float* single;
+    const int32_t* fixed;
+    int32_t count;
+    int32_t fixed_shift;
+    bool symmetric;
+};
+
+// Source index for reflected edge padding. Matches the reference padding:
+// the left edge mirrors sample 0 itself, the right edge starts one sample in.
+inline int32_t reflect(int32_t index, int32_t num_samples) {
+    if (index < 0) {
+        index = -index - 1;
+    } else if (index >= num_samples) {
+        index = 2 * num_samples - 2 - index;
+    }
+    return std::clamp(index, 0, num_samples - 1);
+}
+
+// Out-of-range results saturate (only possible with taps that overshoot)
+inline uint16_t double_to_sample(double value) {
+    return static_cast<uint16_t>(std::min(std::max(value, 0.0), 65535.0));
+}
+
+inline uint16_t float_to_sample(float value) {
+    value = std::min(std::max(value, 0.0f), 65535.0f);
+    return static_cast<uint16_t>(static_cast<int32_t>(value));
+}
+
+inline uint16_t fixed_to_sample(int32_t acc, int32_t shift) {
+    return static_cast<uint16_t>(std::clamp(acc >> shift, 0, 65535));
+}
+
+// Scalar kernels. The vector kernels perform the same operations in the same
+// order per output, so every instruction set produces identical results.
+template <typename Sample>
+uint16_t exact_output(const Taps& taps, Sample sample) {
+    double v = 0.0;
+    for (int32_t j = 0; j < taps.count; ++j) {
+        v += taps.exact[j] * static_cast<double>(sample(j));
+    }
+    return double_to_sample(v);
+}
+
+template <typename Sample>
+uint16_t float_output(const Taps& taps, Sample sample) {
+    const float* c = taps.single;
+    float v = 0.0f;
+    if (taps.symmetric) {
+        const int32_t centre = taps.count / 2;
+        v = c[centre] * static_cast<float>(sample(centre));
+        for (int32_t k = 0; k < centre; ++k) {
+            v += c[k] * (static_cast<float>(sample(k)) + static_cast<float>(sample(taps.count - 1 - k)));
+        }
+    } else {
+        for (int32_t j = 0; j < taps.count; ++j) {
+            v += c[j] * static_cast<float>(sample(j));
+        }
+    }
+    return float_to_sample(v);
+}
+
+template <typename Sample>
+uint16_t fixed_output(const Taps& taps, Sample sample) {
+    const int32_t* q = taps.fixed;
+    int32_t acc = 0;
+    if (taps.symmetric) {
+        const int32_t centre = taps.count / 2;
+        acc = q[centre] * static_cast<int32_t>(sample(centre));
+        for (int32_t k = 0; k < centre; ++k) {
+            acc += q[k] * (static_cast<int32_t>(sample(k)) + static_cast<int32_t>(sample(taps.count - 1 - k)));
+        }
+    } else {
+        for (int32_t j = 0; j < taps.count; ++j) {
+            acc += q[j] * static_cast<int32_t>(sample(j));
+        }
+    }
+    return fixed_to_sample(acc, taps.fixed_shift);
+}
+
+template <typename Sample>
+uint16_t scalar_output(const Taps& taps, FIRFilter::Precision precision, Sample sample) {
+    switch (precision) {
+        case FIRFilter::Precision::Float:
+            return float_output(taps, sample);
+        case FIRFilter::Precision::Fixed:
+            return fixed_output(taps, sample);
+        case FIRFilter::Precision::Exact:
+        default:
+            return exact_output(taps, sample);
+    }
+}
+
+// Compile-time taps for FixedFIRFilter: the fold expands one constant
+// multiply per tap, in the same order as exact_output()
+template <typename Coeffs, typename Sample, size_t... J>
+double fixed_exact_sum(Sample sample, std::index_sequence<J...>) {
+    double v = 0.0;
+    ((v += Coeffs::values[J] * static_cast<double>(sample(static_cast<int32_t>(J)))), ...);
+    return v;
+}
+
+#ifdef ENCODE_ORC_FIR_X86
+
+// Each vector kernel filters outputs [begin, end) whose windows lie entirely
+// inside the input, and returns the first output it did not write.
+
+ENCODE_ORC_TARGET("sse4.1")
+int32_t exact_sse41(const Taps& taps, const uint16_t* input, uint16_t* output,
+                    int32_t begin, int32_t end) {
+    const int32_t overlap = taps.count / 2;
+    int32_t i = begin;
+    for (; i + 2 <= end; i += 2) {
+        const uint16_t* window = input + i - overlap;
+        __m128d acc = _mm_setzero_pd();
+        for (int32_t j = 0; j < taps.count; ++j) {
+            int32_t pair;
+            std::memcpy(&pair, window + j, sizeof(pair));
+            __m128d x = _mm_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_cvtsi32_si128(pair)));
+            acc = _mm_add_pd(acc, _mm_mul_pd(_mm_set1_pd(taps.exact[j]), x));
+        }
+        __m128i r = _mm_cvttpd_epi32(acc);
+        int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi32(r, r));
+        std::memcpy(output + i, &packed, sizeof(packed));
+    }
+    return i;
+}
+
+ENCODE_ORC_TARGET("sse4.1")
+inline __m128 load4_ps(const uint16_t* p) {
+    return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+ENCODE_ORC_TARGET("sse4.1")
+int32_t float_sse41(const Taps& taps, const uint16_t* input, uint16_t* output,
+                    int32_t begin, int32_t end) {
+    const int32_t overlap = taps.count / 2;
+    const __m128 lo = _mm_setzero_ps();
+    const __m128 hi = _mm_set1_ps(65535.0f);
+    int32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const uint16_t* window = input + i - overlap;
+        __m128 acc = _mm_setzero_ps();
+        if (taps.symmetric) {
+            acc = _mm_mul_ps(_mm_set1_ps(taps.single[overlap]), load4_ps(window + overlap));
+            for (int32_t k = 0; k < overlap; ++k) {
+                __m128 pair = _mm_add_ps(load4_ps(window + k), load4_ps(window + taps.count - 1 - k));
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps.single[k]), pair));
+            }
+        } else {
+            for (int32_t j = 0; j < taps.count; ++j) {
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps.single[j]), load4_ps(window + j)));
+            }
+        }
+        __m128i r = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(acc, lo), hi));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi32(r, r));
+    }
+    return i;
+}
+
+ENCODE_ORC_TARGET("sse4.1")
+inline __m128i load4_epi32(const uint16_t* p) {
+    return _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+ENCODE_ORC_TARGET("sse4.1")
+int32_t fixed_sse41(const Taps& taps, const uint16_t* input, uint16_t* output,
+                    int32_t begin, int32_t end) {
+    const int32_t overlap = taps.count / 2;
+    const __m128i shift = _mm_cvtsi32_si128(taps.fixed_shift);
+    int32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const uint16_t* window = input + i - overlap;
+        __m128i acc = _mm_setzero_si128();
+        if (taps.symmetric) {
+            acc = _mm_mullo_epi32(_mm_set1_epi32(taps.fixed[overlap]), load4_epi32(window + overlap));
+            for (int32_t k = 0; k < overlap; ++k) {
+                __m128i pair = _mm_add_epi32(load4_epi32(window + k), load4_epi32(window + taps.count - 1 - k));
+                acc = _mm_add_epi32(acc, _mm_mullo_epi32(_mm_set1_epi32(taps.fixed[k]), pair));
+            }
+        } else {
+            for (int32_t j = 0; j < taps.count; ++j) {
+                acc = _mm_add_epi32(acc, _mm_mullo_epi32(_mm_set1_epi32(taps.fixed[j]), load4_epi32(window + j)));
+            }
+        }
+        __m128i r = _mm_sra_epi32(acc, shift);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi32(r, r));
+    }
+    return i;
+}
+
+ENCODE_ORC_TARGET("avx2")
+int32_t exact_avx2(const Taps& taps, const uint16_t* input, uint16_t* output,
+                   int32_t begin, int32_t end) {
+    const int32_t overlap = taps.count / 2;
+    int32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const uint16_t* window = input + i - overlap;
+        __m256d acc = _mm256_setzero_pd();
+        for (int32_t j = 0; j < taps.count; ++j) {
+            __m128i x16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(window + j));
+            __m256d x = _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(x16));
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_set1_pd(taps.exact[j]), x));
+        }
+        __m128i r = _mm256_cvttpd_epi32(acc);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi32(r, r));
+    }
+    return i;
+}
+
+ENCODE_ORC_TARGET("avx2")
+inline __m256 load8_ps(const uint16_t* p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+}
+
+ENCODE_ORC_TARGET("avx2")
+inline void store8_epi32(uint16_t* p, __m256i r) {
+    __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), packed);
+}
+
+ENCODE_ORC_TARGET("avx2")
+int32_t float_avx2(const Taps& taps, const uint16_t* input, uint16_t* output,
+                   int32_t begin, int32_t end) {
+    const int32_t overlap = taps.count / 2;
+    const __m256 lo = _mm256_setzero_ps();
+    const __m256 hi = _mm256_set1_ps(65535.0f);
+    int32_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const uint16_t* window = input + i - overlap;
+        __m256 acc = _mm256_setzero_ps();
+        if (taps.symmetric) {
+            acc = _mm256_mul_ps(_mm256_set1_ps(taps.single[overlap]), load8_ps(window + overlap));
+            for (int32_t k = 0; k < overlap; ++k) {
+                __m256 pair = _mm256_add_ps(load8_ps(window + k), load8_ps(window + taps.count - 1 - k));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(taps.single[k]), pair));
+            }
+        } else {
+            for (int32_t j = 0; j < taps.count; ++j) {
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(taps.single[j]), load8_ps(window + j)));
+            }
+        }
+        store8_epi32(output + i, _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(acc, lo), hi)));
+    }
+    return i;
+}
+
+ENCODE_ORC_TARGET("avx2")
+inline __m256i load8_epi32(const uint16_t* p) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+ENCODE_ORC_TARGET("avx2")
+int32_t fixed_avx2(const Taps& taps, const uint16_t* input, uint16_t* output,
+                   int32_t begin, int32_t end) {
+    const int32_t overlap = taps.count / 2;
+    const __m128i shift = _mm_cvtsi32_si128(taps.fixed_shift);
+    int32_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const uint16_t* window = input + i - overlap;
+        __m256i acc = _mm256_setzero_si256();
+        if (taps.symmetric) {
+            acc = _mm256_mullo_epi32(_mm256_set1_epi32(taps.fixed[overlap]), load8_epi32(window + overlap));
+            for (int32_t k = 0; k < overlap; ++k) {
+                __m256i pair = _mm256_add_epi32(load8_epi32(window + k), load8_epi32(window + taps.count - 1 - k));
+                acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(_mm256_set1_epi32(taps.fixed[k]), pair));
+            }
+        } else {
+            for (int32_t j = 0; j < taps.count; ++j) {
+                acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(_mm256_set1_epi32(taps.fixed[j]), load8_epi32(window + j)));
+            }
+        }
+        store8_epi32(output + i, _mm256_sra_epi32(acc, shift));
+    }
+    return i;
+}
+
+template <typename Coeffs, size_t... J>
+ENCODE_ORC_TARGET("sse4.1")
+inline __m128d fixed_exact_sse41_sum(const uint16_t* window, std::index_sequence<J...>) {
+    __m128d acc = _mm_setzero_pd();
+    int32_t pair = 0;
+    ((std::memcpy(&pair, window + J, sizeof(pair)),
+      acc = _mm_add_pd(acc, _mm_mul_pd(_mm_set1_pd(Coeffs::values[J]),
+                                       _mm_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_cvtsi32_si128(pair)))))), ...);
+    return acc;
+}
+
+template <typename Coeffs>
+ENCODE_ORC_TARGET("sse4.1")
+int32_t fixed_exact_sse41(const uint16_t* input, uint16_t* output, int32_t begin, int32_t end) {
+    constexpr int32_t overlap = static_cast<int32_t>(Coeffs::values.size() / 2);
+    int32_t i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d acc = fixed_exact_sse41_sum<Coeffs>(input + i - overlap,
+                                                    std::make_index_sequence<Coeffs::values.size()>());
+        __m128i r = _mm_cvttpd_epi32(acc);
+        int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi32(r, r));
+        std::memcpy(output + i, &packed, sizeof(packed));
+    }
+    return i;
+}
+
+template <typename Coeffs, size_t... J>
+ENCODE_ORC_TARGET("avx2")
+inline __m256d fixed_exact_avx2_sum(const uint16_t* window, std::index_sequence<J...>) {
+    __m256d acc = _mm256_setzero_pd();
+    ((acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_set1_pd(Coeffs::values[J]),
+          _mm256_cvtepi32_pd(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(window + J))))))), ...);
+    return acc;
+}
+
+template <typename Coeffs>
+ENCODE_ORC_TARGET("avx2")
+int32_t fixed_exact_avx2(const uint16_t* input, uint16_t* output, int32_t begin, int32_t end) {
+    constexpr int32_t overlap = static_cast<int32_t>(Coeffs::values.size() / 2);
+    int32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d acc = fixed_exact_avx2_sum<Coeffs>(input + i - overlap,
+                                                   std::make_index_sequence<Coeffs::values.size()>());
+        __m128i r = _mm256_cvttpd_epi32(acc);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi32(r, r));
+    }
+    return i;
+}
+
+#endif // ENCODE_ORC_FIR_X86
+
+template <typename Coeffs>
+int32_t fixed_vector_kernel(const uint16_t* input, uint16_t* output, int32_t begin, int32_t end) {
+#ifdef ENCODE_ORC_FIR_X86
+    switch (active_instruction_set()) {
+        case InstructionSet::AVX2: return fixed_exact_avx2<Coeffs>(input, output, begin, end);
+        case InstructionSet::SSE41: return fixed_exact_sse41<Coeffs>(input, output, begin, end);
+        default: break;
+    }
+#else
+    (void)input;
+    (void)output;
+    (void)end;
+#endif
+    return begin;
+}
+
+/**
+ * @brief Run the best vector kernel over the interior outputs
+ * @return First output not written (the scalar path finishes the rest)
+ */
+int32_t vector_kernel(const Taps& taps, FIRFilter::Precision precision,
+                      const uint16_t* input, uint16_t* output, int32_t begin, int32_t end) {
+#ifdef ENCODE_ORC_FIR_X86
+    switch (active_instruction_set()) {
+        case InstructionSet::AVX2:
+            switch (precision) {
+                case FIRFilter::Precision::Float: return float_avx2(taps, input, output, begin, end);
+                case FIRFilter::Precision::Fixed: return fixed_avx2(taps, input, output, begin, end);
+                default: return exact_avx2(taps, input, output, begin, end);
+            }
+        case InstructionSet::SSE41:
+            switch (precision) {
+                case FIRFilter::Precision::Float: return float_sse41(taps, input, output, begin, end);
+                case FIRFilter::Precision::Fixed: return fixed_sse41(taps, input, output, begin, end);
+                default: return exact_sse41(taps, input, output, begin, end);
+            }
+        default:
+            break;
+    }
+#else
+    (void)taps;
+    (void)precision;
+    (void)input;
+    (void)output;
+    (void)end;
+#endif
+    return begin;
+}
+
+const char* precision_name(FIRFilter::Precision precision) {
+    switch (precision) {
+        case FIRFilter::Precision::Float: return "float";
+        case FIRFilter::Precision::Fixed: return "fixed";
+        default: return "exact";
+    }
+}
+
+} // anonymous namespace
+
+FIRFilter::FIRFilter(const std::vector<double>& coefficients)
+    : coeffs_(coefficients),
+      precision_(default_precision())
+{
+    assert((coefficients.size() % 2) == 1);
+
+    const size_t num_taps = coeffs_.size();
+    symmetric_ = true;
+    for (size_t k = 0; k < num_taps / 2; ++k) {
+        if (coeffs_[k] != coeffs_[num_taps - 1 - k]) {
+            symmetric_ = false;
+            break;
+        }
+    }
+
+    double abs_sum = 0.0;
+    for (double c : coeffs_) {
+        abs_sum += std::fabs(c);
+    }
+
+    // Single precision: coefficient rounding plus accumulated rounding,
+    // plus one for truncation landing on the other side of an integer
+    coeffs_float_.resize(num_taps);
+    double float_error = 0.0;
+    for (size_t j = 0; j < num_taps; ++j) {
+        coeffs_float_[j] = static_cast<float>(coeffs_[j]);
+        float_error += std::fabs(static_cast<double>(coeffs_float_[j]) - coeffs_[j]) * 65535.0;
+    }
+    float_error += abs_sum * 65535.0 * static_cast<double>(num_taps + 1) * FLT_EPSILON;
+    float_error_bound_ = static_cast<int32_t>(float_error) + 1;
+
+    // Fixed point: the largest scale (up to Q15) whose worst-case accumulator
+    // still fits in 32 bits
+    coeffs_fixed_.resize(num_taps);
+    for (fixed_shift_ = 15; fixed_shift_ >= 0; --fixed_shift_) {
+        const double scale = std::ldexp(1.0, fixed_shift_);
+        int64_t abs_fixed_sum = 0;
+        for (size_t j = 0; j < num_taps; ++j) {
+            coeffs_fixed_[j] = static_cast<int32_t>(std::lround(coeffs_[j] * scale));
+            abs_fixed_sum += std::abs(static_cast<int64_t>(coeffs_fixed_[j]));
+        }
+        if (fixed_shift_ == 0 || abs_fixed_sum * 65535 <= std::numeric_limits<int32_t>::max()) {
+            break;
+        }
+    }
+    const double scale = std::ldexp(1.0, fixed_shift_);
+    double fixed_error = 0.0;
+    for (size_t j = 0; j < num_taps; ++j) {
+        fixed_error += std::fabs(static_cast<double>(coeffs_fixed_[j]) / scale - coeffs_[j]) * 65535.0;
+    }
+    fixed_error_bound_ = static_cast<int32_t>(fixed_error) + 1;
+}
+
+template <size_t N, typename Coeffs>
+void FixedFIRFilter<N, Coeffs>::apply(const uint16_t* input, uint16_t* output, int32_t num_samples) const {
+    if (num_samples <= 0) return;
+
+    constexpr int32_t overlap = static_cast<int32_t>(N / 2);
+    constexpr auto taps = std::make_index_sequence<N>();
+    const int32_t interior_begin = std::min(overlap, num_samples);
+    const int32_t interior_end = std::max(interior_begin, num_samples - overlap);
+
+    for (int32_t i = 0; i < interior_begin; ++i) {
+        output[i] = double_to_sample(fixed_exact_sum<Coeffs>([&](int32_t j) {
+            return input[reflect(i + j - overlap, num_samples)];
+        }, taps));
+    }
+
+    int32_t i = fixed_vector_kernel<Coeffs>(input, output, interior_begin, interior_end);
+    for (; i < interior_end; ++i) {
+        const uint16_t* window = input + i - overlap;
+        output[i] = double_to_sample(fixed_exact_sum<Coeffs>([window](int32_t j) { return window[j]; }, taps));
+    }
+
+    for (i = interior_end; i < num_samples; ++i) {
+        output[i] = double_to_sample(fixed_exact_sum<Coeffs>([&](int32_t j) {
+            return input[reflect(i + j - overlap, num_samples)];
+        }, taps));
+    }
+}
+
+template class FixedFIRFilter<13, Filters::PalUVCoefficients>;
+template class FixedFIRFilter<9, Filters::NtscUVCoefficients>;
+template class FixedFIRFilter<23, Filters::NtscQCoefficients>;
+
+void FIRFilter::apply(std::vector<double>& samples) const {
+    if (samples.empty()) return;
+
+    thread_local std::vector<double> tmp;
+    tmp.resize(samples.size());
+    apply_internal(samples.data(), tmp.data(), static_cast<int>(samples.size()));
+    std::copy(tmp.begin(), tmp.end(), samples.begin());
+}
+
+void FIRFilter::apply(std::vector<uint16_t>& samples) const {
+    if (samples.empty()) return;
+
+    thread_local std::vector<uint16_t> tmp;
+    tmp.assign(samples.begin(), samples.end());
+    apply(tmp.data(), samples.data(), static_cast<int32_t>(samples.size()));
+}
+
+void FIRFilter::apply(const uint16_t* input, uint16_t* output, int32_t num_samples) const {
+    if (num_samples <= 0) return;
+
+    const Taps taps{coeffs_.data(), coeffs_float_.data(), coeffs_fixed_.data(),
+                    static_cast<int32_t>(coeffs_.size()), fixed_shift_, symmetric_};
+    const int32_t overlap = taps.count / 2;
+
+    // Outputs whose whole window lies inside the input read it directly;
+    // only the few at each edge need reflected indices
+    const int32_t interior_begin = std::min(overlap, num_samples);
+    const int32_t interior_end = std::max(interior_begin, num_samples - overlap);
+
+    for (int32_t i = 0; i < interior_begin; ++i) {
+        output[i] = scalar_output(taps, precision_, [&](int32_t j) {
+            return input[reflect(i + j - overlap, num_samples)];
+        });
+    }
+
+    int32_t i = vector_kernel(taps, precision_, input, output, interior_begin, interior_end);
+    for (; i < interior_end; ++i) {
+        const uint16_t* window = input + i - overlap;
+        output[i] = scalar_output(taps, precision_, [window](int32_t j) { return window[j]; });
+    }
+
+    for (i = interior_end; i < num_samples; ++i) {
+        output[i] = scalar_output(taps, precision_, [&](int32_t j) {
+            return input[reflect(i + j - overlap, num_samples)];
+        });
+    }
+
+    if (s_verification.load(std::memory_order_relaxed)) {
+        thread_local std::vector<uint16_t> reference;
+        reference.resize(static_cast<size_t>(num_samples));
+        apply_reference(input, reference.data(), num_samples);
+
+        const int32_t bound = error_bound();
+        for (int32_t n = 0; n < num_samples; ++n) {
+            const int32_t error = std::abs(static_cast<int32_t>(output[n]) - static_cast<int32_t>(reference[n]));
+            if (error > bound) {
+                throw std::runtime_error(std::string("FIR filter verification failed (") +
+                                         precision_name(precision_) + ", " + instruction_set() +
+                                         "): sample " + std::to_string(n) + " differs by " +
+                                         std::to_string(error) + ", bound is " + std::to_string(bound));
+            }
+        }
+    }
+}
+
+void FIRFilter::apply_reference(const uint16_t* input, uint16_t* output, int32_t num_samples) const {
+    if (num_samples <= 0) return;
+
+    thread_local std::vector<double> tmp_double;
+    tmp_double.resize(static_cast<size_t>(num_samples));
+    for (int32_t i = 0; i < num_samples; ++i) {
+        tmp_double[i] = static_cast<double>(input[i]);
+    }
+
+    thread_local std::vector<double> filtered;
+    filtered.resize(static_cast<size_t>(num_samples));
+    apply_internal(tmp_double.data(), filtered.data(), num_samples);
+
+    for (int32_t i = 0; i < num_samples; ++i) {
+        output[i] = double_to_sample(filtered[i]);
+    }
+}
+
+int32_t FIRFilter::error_bound() const {
+    switch (precision_) {
+        case Precision::Float: return float_error_bound_;
+        case Precision::Fixed: return fixed_error_bound_;
+        default: return 0;
+    }
+}
+
+void FIRFilter::set_default_precision(Precision precision) {
+    s_default_precision.store(precision);
+}
+
+FIRFilter::Precision FIRFilter::default_precision() {
+    return s_default_precision.load();
+}
+
+void FIRFilter::set_verification(bool enabled) {
+    s_verification.store(enabled);
+}
+
+bool FIRFilter::verification_enabled() {
+    return s_verification.load();
+}
+
+bool FIRFilter::set_instruction_set(const std::string& name) {
+    InstructionSet requested;
+    if (name == "avx2") {
+        requested = InstructionSet::AVX2;
+    } else if (name == "sse4.1") {
+        requested = InstructionSet::SSE41;
+    } else if (name == "scalar") {
+        requested = InstructionSet::Scalar;
+    } else {
+        return false;
+    }
+    if (requested > supported_instruction_set()) {
+        return false;
+    }
+    s_instruction_set.store(requested);
+    return true;
+}
+
+const char* FIRFilter::instruction_set() {
+    switch (active_instruction_set()) {
+        case InstructionSet::AVX2: return "avx2";
+        case InstructionSet::SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+void FIRFilter::apply_internal(const double* input_data, double* output_data, int num_samples) const {
+    const int num_taps = static_cast<int>(coeffs_.size());
+    const int overlap = num_taps / 2;
+
+    // Create padded version with reflection at edges to avoid artifacts
+    thread_local std::vector<double> padded;
+    padded.resize(num_samples + 2 * overlap);
+
+    // Reflect at left edge
+    for (int i = 0; i < overlap; ++i) {
+        padded[overlap - 1 - i] = input_data[reflect(-1 - i, num_samples)];
+    }
+
+    // Copy center
+    for (int i = 0; i < num_samples; ++i) {
+        padded[overlap + i] = input_data[i];
+    }
+
+    // Reflect at right edge
+    for (int i = 0; i < overlap; ++i) {
+        padded[overlap + num_samples + i] = input_data[reflect(num_samples + i, num_samples)];
+    }
+
+    // Apply filter to entire padded signal
+    for (int i = 0; i < num_samples; ++i) {
+        double v = 0.0;
+        for (int j = 0; j < num_taps; ++j) {
+            v += coeffs_[j] * padded[i + j];
+        }
+        output_data[i] = v;
+    }
+}
+
+} // namespace encode_orc
@@ -0,0 +1,348 @@
+/*
+ * File:        frame_encode_pipeline.cpp
+ * Module:      encode-orc
+ * Purpose:     Multi-threaded frame encoding pipeline implementation
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "frame_encode_pipeline.h"
+#include "pal_encoder.h"
+#include "ntsc_encoder.h"
+#include "logging.h"
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <optional>
+
+namespace encode_orc {
+
+/**
+ * @brief Per-thread encoder state
+ *
+ * Encoders are not thread-safe, so every worker owns one for the lifetime
+ * of the pipeline.
+ */
+class FrameEncodePipeline::Worker {
+public:
+    /**
+     * @brief Apply settings, reusing the existing encoder when the system matches
+     */
+    void configure(const VideoParameters& params, SourceVideoStandard source_standard,
+                   bool enable_chroma_filter, bool enable_luma_filter, bool separate_yc,
+                   int32_t line_threads) {
+        separate_yc_ = separate_yc;
+        sequence_.clear();
+        if (params.system == VideoSystem::PAL) {
+            ntsc_encoder_.reset();
+            if (pal_encoder_) {
+                pal_encoder_->reconfigure(params, enable_chroma_filter, enable_luma_filter);
+            } else {
+                pal_encoder_ = std::make_unique<PALEncoder>(params, enable_chroma_filter, enable_luma_filter);
+            }
+            pal_encoder_->set_source_video_standard(source_standard);
+            pal_encoder_->set_line_threads(line_threads);
+        } else {
+            pal_encoder_.reset();
+            if (ntsc_encoder_) {
+                ntsc_encoder_->reconfigure(params, enable_chroma_filter, enable_luma_filter);
+            } else {
+                ntsc_encoder_ = std::make_unique<NTSCEncoder>(params, enable_chroma_filter, enable_luma_filter);
+            }
+            ntsc_encoder_->set_source_video_standard(source_standard);
+            ntsc_encoder_->set_line_threads(line_threads);
+        }
+    }
+
+    void encode(const Job& job, EncodedFrame& out) {
+        if (pal_encoder_) {
+            encode_with(*pal_encoder_, job, out);
+        } else {
+            encode_with(*ntsc_encoder_, job, out);
+        }
+    }
+
+private:
+    bool separate_yc_ = false;
+    std::unique_ptr<PALEncoder> pal_encoder_;
+    std::unique_ptr<NTSCEncoder> ntsc_encoder_;
+
+    // Still-image frames by colour sequence position (cleared per run)
+    std::vector<std::optional<EncodedFrame>> sequence_;
+
+    template <typename Encoder>
+    void encode_with(Encoder& encoder, const Job& job, EncodedFrame& out) {
+        if (!job.repeated_frame) {
+            encode_full(encoder, job, out);
+            return;
+        }
+
+        // Cached frames are always encoded at the first pass through the
+        // sequence, so the output does not depend on which worker saw which
+        // frame first
+        const int32_t sequence_field = job.field_number % Encoder::COLOUR_SEQUENCE_FIELDS;
+        const size_t position = static_cast<size_t>(sequence_field / 2);
+        if (sequence_.size() <= position) {
+            sequence_.resize(Encoder::COLOUR_SEQUENCE_FIELDS / 2);
+        }
+
+        std::optional<EncodedFrame>& cached = sequence_[position];
+        if (!cached) {
+            Job first_pass = job;
+            first_pass.field_number = sequence_field;
+            cached.emplace();
+            encode_full(encoder, first_pass, *cached);
+        }
+
+        out = *cached;
+        if (separate_yc_) {
+            encoder.refresh_data_lines_yc(job.field_number,
+                                          out.y_field1, out.c_field1, out.y_field2, out.c_field2,
+                                          job.frame_vbi());
+        } else {
+            encoder.refresh_data_lines(out.composite, job.field_number, job.frame_vbi());
+        }
+    }
+
+    template <typename Encoder>
+    void encode_full(Encoder& encoder, const Job& job, EncodedFrame& out) {
+        if (separate_yc_) {
+            encoder.encode_frame_yc(*job.frame_buffer, job.field_number,
+                                    out.y_field1, out.c_field1, out.y_field2, out.c_field2,
+                                    job.frame_vbi());
+        } else {
+            encoder.encode_frame(*job.frame_buffer, job.field_number, out.composite, job.frame_vbi());
+        }
+    }
+};
+
+FrameEncodePipeline::FrameEncodePipeline(const VideoParameters& params,
+                                         SourceVideoStandard source_standard,
+                                         bool enable_chroma_filter,
+                                         bool enable_luma_filter,
+                                         bool separate_yc,
+                                         int32_t num_threads)
+    : params_(params),
+      source_standard_(source_standard),
+      enable_chroma_filter_(enable_chroma_filter),
+      enable_luma_filter_(enable_luma_filter),
+      separate_yc_(separate_yc),
+      num_threads_(resolve_thread_count(num_threads)) {
+    // Two frames per worker keeps every thread busy while the writer catches
+    // up, without letting the reorder buffer grow unbounded
+    max_in_flight_ = static_cast<size_t>(num_threads_) * 2;
+}
+
+FrameEncodePipeline::~FrameEncodePipeline() {
+    stop_workers();
+}
+
+int32_t FrameEncodePipeline::resolve_thread_count(int32_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned int hardware_threads = std::thread::hardware_concurrency();
+    return hardware_threads > 0 ? static_cast<int32_t>(hardware_threads) : 1;
+}
+
+void FrameEncodePipeline::configure(const VideoParameters& params,
+                                    SourceVideoStandard source_standard,
+                                    bool enable_chroma_filter,
+                                    bool enable_luma_filter,
+                                    bool separate_yc) {
+    params_ = params;
+    source_standard_ = source_standard;
+    enable_chroma_filter_ = enable_chroma_filter;
+    enable_luma_filter_ = enable_luma_filter;
+    separate_yc_ = separate_yc;
+}
+
+void FrameEncodePipeline::start(FrameSink sink) {
+    stop_workers();
+
+    sink_ = std::move(sink);
+    error_message_.clear();
+    jobs_.assign(max_in_flight_, Job{});
+    jobs_head_ = 0;
+    jobs_count_ = 0;
+    results_.clear();
+    results_.resize(max_in_flight_);
+    next_sequence_ = 0;
+    next_write_ = 0;
+    stopping_ = false;
+    failed_ = false;
+
+    // Encoders are (re)configured here on the calling thread; after the first
+    // run this is only a reconfigure, not a rebuild
+    while (static_cast<int32_t>(workers_.size()) < num_threads_) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (auto& worker : workers_) {
+        worker->configure(params_, source_standard_, enable_chroma_filter_,
+                          enable_luma_filter_, separate_yc_, line_threads_);
+    }
+
+    inline_ = (num_threads_ <= 1);
+    if (inline_) {
+        return;
+    }
+
+    ENCODE_ORC_LOG_DEBUG("Starting {} encoder threads", num_threads_);
+    threads_.reserve(num_threads_);
+    for (auto& worker : workers_) {
+        threads_.emplace_back(&FrameEncodePipeline::worker_loop, this, std::ref(*worker));
+    }
+}
+
+bool FrameEncodePipeline::submit(const FrameBuffer& frame_buffer, int32_t field_number,
+                                 const FrameVBI* frame_vbi, bool repeated_frame) {
+    std::optional<FrameVBI> vbi;
+    if (frame_vbi) {
+        vbi = *frame_vbi;
+    }
+    
+    if (inline_) {
+        if (!error_message_.empty()) {
+            return false;
+        }
+        FrameHandle encoded = frame_pool_.acquire();
+        try {
+            workers_.front()->encode(Job{next_sequence_++, &frame_buffer, field_number, vbi, repeated_frame},
+                                   *encoded);
+        } catch (const std::exception& e) {
+            error_message_ = std::string("Exception: ") + e.what();
+            return false;
+        }
+        if (!sink_(*encoded)) {
+            error_message_ = "Failed to write encoded frame";
+            return false;
+        }
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!failed_ && static_cast<size_t>(next_sequence_ - next_write_) >= max_in_flight_) {
+        write_ready(lock, true);
+    }
+    if (failed_) {
+        return false;
+    }
+
+    // In-flight frames never exceed max_in_flight_, so neither do queued jobs
+    jobs_[(jobs_head_ + jobs_count_) % jobs_.size()] =
+        Job{next_sequence_++, &frame_buffer, field_number, vbi, repeated_frame};
+    ++jobs_count_;
+    job_ready_.notify_one();
+
+    return write_ready(lock, false);
+}
+
+bool FrameEncodePipeline::finish() {
+    const BufferPoolStats stats = frame_pool_.stats();
+    ENCODE_ORC_LOG_DEBUG("Encoded frame pool: {} allocated, {} reused, peak {} in use",
+                         stats.allocated, stats.reused, stats.peak);
+
+    if (inline_) {
+        return error_message_.empty();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!failed_ && next_write_ < next_sequence_) {
+            write_ready(lock, true);
+        }
+    }
+
+    stop_workers();
+    return !failed_;
+}
+
+void FrameEncodePipeline::worker_loop(Worker& worker) {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_ready_.wait(lock, [this] { return stopping_ || failed_ || jobs_count_ > 0; });
+            if (stopping_ || failed_) {
+                return;
+            }
+            job = jobs_[jobs_head_];
+            jobs_head_ = (jobs_head_ + 1) % jobs_.size();
+            --jobs_count_;
+        }
+
+        FrameHandle encoded = frame_pool_.acquire();
+        try {
+            worker.encode(job, *encoded);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fail_locked(std::string("Exception: ") + e.what());
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            results_[static_cast<size_t>(job.sequence) % results_.size()] = std::move(encoded);
+        }
+        result_ready_.notify_one();
+    }
+}
+
+bool FrameEncodePipeline::write_ready(std::unique_lock<std::mutex>& lock, bool block) {
+    if (block) {
+        result_ready_.wait(lock, [this] {
+            return failed_ || results_[static_cast<size_t>(next_write_) % results_.size()] != nullptr;
+        });
+    }
+
+    while (!failed_) {
+        FrameHandle& slot = results_[static_cast<size_t>(next_write_) % results_.size()];
+        if (!slot) {
+            break;
+        }
+        FrameHandle encoded = std::move(slot);
+
+        // Run the sink without holding the lock so workers keep going; the
+        // frame goes back to the pool afterwards
+        lock.unlock();
+        bool ok = sink_(*encoded);
+        encoded.reset();
+        lock.lock();
+
+        if (!ok) {
+            fail_locked("Failed to write encoded frame");
+            break;
+        }
+        ++next_write_;
+    }
+
+    return !failed_;
+}
+
+void FrameEncodePipeline::fail_locked(const std::string& message) {
+    if (!failed_) {
+        failed_ = true;
+        error_message_ = message;
+    }
+    job_ready_.notify_all();
+    result_ready_.notify_all();
+}
+
+void FrameEncodePipeline::stop_workers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        jobs_count_ = 0;
+    }
+    job_ready_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+} // namespace encode_orc
@@ -0,0 +1,199 @@
+/*
+ * File:        horizontal_resampler.cpp
+ * Module:      encode-orc
+ * Purpose:     Maps source pixels onto the 4fSC active line
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "horizontal_resampler.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+// As with the FIR kernels, the vector loop is built with a per-function
+// target attribute and picked at runtime
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ENCODE_ORC_RESAMPLER_X86 1
+#include <immintrin.h>
+#define ENCODE_ORC_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace encode_orc {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Samples of edge padding on each side of a polyphase line
+constexpr int32_t PADDING = HorizontalResampler::POLYPHASE_TAPS;
+
+std::atomic<HorizontalResampler::Mode> s_default_mode{HorizontalResampler::Mode::Nearest};
+
+double sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    return std::sin(PI * x) / (PI * x);
+}
+
+double lanczos(double x) {
+    constexpr double a = HorizontalResampler::POLYPHASE_TAPS / 2;
+    return (std::abs(x) < a) ? sinc(x) * sinc(x / a) : 0.0;
+}
+
+int64_t floor_div(int64_t num, int64_t den) {
+    return (num >= 0) ? num / den : -((-num + den - 1) / den);
+}
+
+#ifdef ENCODE_ORC_RESAMPLER_X86
+
+bool cpu_has_avx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool use_avx2() {
+    static const bool avx2 = cpu_has_avx2();
+    return avx2;
+}
+
+// Resamples eight outputs per step and returns the first output not
+// written. Accumulates in the same order as the scalar loop, so results
+// are identical.
+ENCODE_ORC_TARGET("avx2")
+int32_t polyphase_avx2(const float* line, const int32_t* index, const float* weights,
+                       int32_t width, uint16_t* output) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 lo = _mm256_setzero_ps();
+    const __m256 hi = _mm256_set1_ps(65535.0f);
+    int32_t n = 0;
+    for (; n + 8 <= width; n += 8) {
+        const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + n));
+        __m256 acc = _mm256_setzero_ps();
+        for (int32_t k = 0; k < HorizontalResampler::POLYPHASE_TAPS; ++k) {
+            __m256 x = _mm256_i32gather_ps(line + k, first, 4);
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(weights + k * width + n), x));
+        }
+        __m256i r = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_add_ps(acc, half), lo), hi));
+        __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + n), packed);
+    }
+    return n;
+}
+
+#endif // ENCODE_ORC_RESAMPLER_X86
+
+} // namespace
+
+HorizontalResampler::HorizontalResampler(int32_t source_width, int32_t output_width, Mode mode)
+    : source_width_(source_width),
+      output_width_(output_width),
+      mode_(mode) {
+    if (source_width <= 0 || output_width <= 0) {
+        throw std::invalid_argument("Resampler widths must be positive");
+    }
+
+    index_.resize(output_width_);
+
+    if (mode_ == Mode::Nearest) {
+        // Exact integer form of pixel = floor(sample * source_width / output_width)
+        for (int32_t n = 0; n < output_width_; ++n) {
+            int64_t pixel = static_cast<int64_t>(n) * source_width_ / output_width_;
+            index_[n] = static_cast<int32_t>(std::min<int64_t>(pixel, source_width_ - 1));
+        }
+        return;
+    }
+
+    // Output n sits at source position ((2n + 1) * W - A) / 2A (pixel centres
+    // aligned); the fractional part repeats every A / gcd(W, A) outputs
+    const int32_t g = std::gcd(source_width_, output_width_);
+    num_phases_ = output_width_ / g;
+    const int64_t den = 2 * static_cast<int64_t>(output_width_);
+    const int32_t centre_tap = POLYPHASE_TAPS / 2 - 1;
+
+    std::vector<float> phases(static_cast<size_t>(num_phases_) * POLYPHASE_TAPS);
+    for (int32_t p = 0; p < num_phases_; ++p) {
+        int64_t num = (2 * static_cast<int64_t>(p) + 1) * source_width_ - output_width_;
+        double frac = static_cast<double>(num - floor_div(num, den) * den) / static_cast<double>(den);
+
+        double taps[POLYPHASE_TAPS];
+        double sum = 0.0;
+        for (int32_t k = 0; k < POLYPHASE_TAPS; ++k) {
+            taps[k] = lanczos(frac - static_cast<double>(k - centre_tap));
+            sum += taps[k];
+        }
+        // Normalise so flat areas keep their level exactly
+        for (int32_t k = 0; k < POLYPHASE_TAPS; ++k) {
+            phases[p * POLYPHASE_TAPS + k] = static_cast<float>(taps[k] / sum);
+        }
+    }
+
+    weights_.resize(static_cast<size_t>(output_width_) * POLYPHASE_TAPS);
+    for (int32_t n = 0; n < output_width_; ++n) {
+        int64_t num = (2 * static_cast<int64_t>(n) + 1) * source_width_ - output_width_;
+        index_[n] = static_cast<int32_t>(floor_div(num, den)) - centre_tap + PADDING;
+
+        const float* kernel = &phases[(n % num_phases_) * POLYPHASE_TAPS];
+        for (int32_t k = 0; k < POLYPHASE_TAPS; ++k) {
+            weights_[k * output_width_ + n] = kernel[k];
+        }
+    }
+}
+
+void HorizontalResampler::set_default_mode(Mode mode) {
+    s_default_mode.store(mode);
+}
+
+HorizontalResampler::Mode HorizontalResampler::default_mode() {
+    return s_default_mode.load();
+}
+
+void HorizontalResampler::apply(const uint16_t* input, uint16_t* output) const {
+    if (mode_ == Mode::Polyphase) {
+        apply_polyphase(input, output);
+        return;
+    }
+
+    const int32_t* index = index_.data();
+    for (int32_t n = 0; n < output_width_; ++n) {
+        output[n] = input[index[n]];
+    }
+}
+
+void HorizontalResampler::apply_polyphase(const uint16_t* input, uint16_t* output) const {
+    // Float copy of the line with the edge pixels repeated into the padding
+    thread_local std::vector<float> line;
+    line.resize(source_width_ + 2 * PADDING);
+    std::fill_n(line.begin(), PADDING, static_cast<float>(input[0]));
+    for (int32_t i = 0; i < source_width_; ++i) {
+        line[PADDING + i] = static_cast<float>(input[i]);
+    }
+    std::fill_n(line.begin() + PADDING + source_width_, PADDING, static_cast<float>(input[source_width_ - 1]));
+
+    const float* samples = line.data();
+    const int32_t* index = index_.data();
+    const float* weights = weights_.data();
+
+    int32_t n = 0;
+#ifdef ENCODE_ORC_RESAMPLER_X86
+    if (use_avx2()) {
+        n = polyphase_avx2(samples, index, weights, output_width_, output);
+    }
+#endif
+
+    for (; n < output_width_; ++n) {
+        const float* window = samples + index[n];
+        float acc = 0.0f;
+        for (int32_t k = 0; k < POLYPHASE_TAPS; ++k) {
+            acc += weights[k * output_width_ + n] * window[k];
+        }
+        acc = std::min(std::max(acc + 0.5f, 0.0f), 65535.0f);
+        output[n] = static_cast<uint16_t>(acc);
+    }
+}
+
+} // namespace encode_orc
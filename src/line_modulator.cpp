@@ -0,0 +1,423 @@
+/*
+ * File:        line_modulator.cpp
+ * Module:      encode-orc
+ * Purpose:     Converts resampled Y/U/V (Y/I/Q) lines into luma and chroma levels
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "line_modulator.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+// As with the FIR kernels, the vector loops are built with per-function
+// target attributes and picked at runtime
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ENCODE_ORC_MODULATOR_X86 1
+#include <immintrin.h>
+#define ENCODE_ORC_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace encode_orc {
+
+namespace {
+
+std::atomic<LineModulator::Precision> s_default_precision{LineModulator::Precision::Exact};
+std::atomic<bool> s_verification{false};
+
+// Q15: 1.0 is 32768, the largest stored value 32767
+constexpr int32_t Q15_SHIFT = 15;
+constexpr int32_t Q15_ONE = 1 << Q15_SHIFT;
+constexpr int32_t Q15_ROUND = 1 << (Q15_SHIFT - 1);
+
+// Largest chroma amplitude the fixed-point path accepts. U·sin + V·cos is
+// at most sqrt(U² + V²) times the subcarrier amplitude, so with both
+// amplitudes below this the Q15 products stay inside 32 bits.
+constexpr int32_t MAX_AMPLITUDE = 46000;
+
+// Studio codes are 10-bit
+constexpr int32_t STUDIO_CODES = 1024;
+
+enum class InstructionSet {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+InstructionSet detect_instruction_set() {
+#ifdef ENCODE_ORC_MODULATOR_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return InstructionSet::SSE41;
+    }
+#endif
+    return InstructionSet::Scalar;
+}
+
+// Highest instruction set the CPU supports
+InstructionSet supported_instruction_set() {
+    static const InstructionSet instruction_set = detect_instruction_set();
+    return instruction_set;
+}
+
+// Set by LineModulator::set_instruction_set() to hold the kernel below the CPU's best
+std::atomic<InstructionSet> s_instruction_set{supported_instruction_set()};
+
+InstructionSet active_instruction_set() {
+    return s_instruction_set.load(std::memory_order_relaxed);
+}
+
+int32_t to_q15(double value) {
+    return static_cast<int32_t>(std::clamp<long>(std::lround(value * Q15_ONE), -(Q15_ONE - 1), Q15_ONE - 1));
+}
+
+/**
+ * @brief Line phase in Q15, with the V-switch folded into the cos terms
+ */
+struct FixedLinePhase {
+    int32_t sin;
+    int32_t cos;
+    int32_t v_sin;
+    int32_t v_cos;
+};
+
+/**
+ * @brief Modulate one sample: chroma = U·sin + V·cos, all Q15
+ *
+ * Every sum here is bounded by a sin/cos identity, so 64-bit intermediates
+ * give the same result as the vector kernels' wrapping 32-bit arithmetic.
+ */
+inline int32_t modulate_sample(const FixedLinePhase& line, int32_t sample_sin, int32_t sample_cos,
+                               int32_t u_amplitude, int32_t v_amplitude) {
+    const int32_t s = static_cast<int32_t>((static_cast<int64_t>(line.sin) * sample_cos +
+                                            static_cast<int64_t>(line.cos) * sample_sin + Q15_ROUND) >> Q15_SHIFT);
+    const int32_t c = static_cast<int32_t>((static_cast<int64_t>(line.v_cos) * sample_cos -
+                                            static_cast<int64_t>(line.v_sin) * sample_sin + Q15_ROUND) >> Q15_SHIFT);
+    return static_cast<int32_t>((static_cast<int64_t>(u_amplitude) * s +
+                                 static_cast<int64_t>(v_amplitude) * c + Q15_ROUND) >> Q15_SHIFT);
+}
+
+#ifdef ENCODE_ORC_MODULATOR_X86
+
+// Each vector kernel modulates samples [0, width) in place (chroma holds
+// the U amplitudes on entry) and returns the first sample it did not write.
+
+ENCODE_ORC_TARGET("sse4.1")
+int32_t modulate_sse41(const FixedLinePhase& line, const int32_t* sample_sin, const int32_t* sample_cos,
+                       const int32_t* v_amplitude, int32_t* chroma, int32_t width) {
+    const __m128i line_sin = _mm_set1_epi32(line.sin);
+    const __m128i line_cos = _mm_set1_epi32(line.cos);
+    const __m128i line_v_sin = _mm_set1_epi32(line.v_sin);
+    const __m128i line_v_cos = _mm_set1_epi32(line.v_cos);
+    const __m128i round = _mm_set1_epi32(Q15_ROUND);
+    int32_t n = 0;
+    for (; n + 4 <= width; n += 4) {
+        const __m128i ss = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sample_sin + n));
+        const __m128i cs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sample_cos + n));
+        __m128i s = _mm_add_epi32(_mm_mullo_epi32(line_sin, cs), _mm_mullo_epi32(line_cos, ss));
+        s = _mm_srai_epi32(_mm_add_epi32(s, round), Q15_SHIFT);
+        __m128i c = _mm_sub_epi32(_mm_mullo_epi32(line_v_cos, cs), _mm_mullo_epi32(line_v_sin, ss));
+        c = _mm_srai_epi32(_mm_add_epi32(c, round), Q15_SHIFT);
+        const __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chroma + n));
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v_amplitude + n));
+        __m128i r = _mm_add_epi32(_mm_mullo_epi32(u, s), _mm_mullo_epi32(v, c));
+        r = _mm_srai_epi32(_mm_add_epi32(r, round), Q15_SHIFT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(chroma + n), r);
+    }
+    return n;
+}
+
+ENCODE_ORC_TARGET("avx2")
+int32_t modulate_avx2(const FixedLinePhase& line, const int32_t* sample_sin, const int32_t* sample_cos,
+                      const int32_t* v_amplitude, int32_t* chroma, int32_t width) {
+    const __m256i line_sin = _mm256_set1_epi32(line.sin);
+    const __m256i line_cos = _mm256_set1_epi32(line.cos);
+    const __m256i line_v_sin = _mm256_set1_epi32(line.v_sin);
+    const __m256i line_v_cos = _mm256_set1_epi32(line.v_cos);
+    const __m256i round = _mm256_set1_epi32(Q15_ROUND);
+    int32_t n = 0;
+    for (; n + 8 <= width; n += 8) {
+        const __m256i ss = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sample_sin + n));
+        const __m256i cs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sample_cos + n));
+        __m256i s = _mm256_add_epi32(_mm256_mullo_epi32(line_sin, cs), _mm256_mullo_epi32(line_cos, ss));
+        s = _mm256_srai_epi32(_mm256_add_epi32(s, round), Q15_SHIFT);
+        __m256i c = _mm256_sub_epi32(_mm256_mullo_epi32(line_v_cos, cs), _mm256_mullo_epi32(line_v_sin, ss));
+        c = _mm256_srai_epi32(_mm256_add_epi32(c, round), Q15_SHIFT);
+        const __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chroma + n));
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v_amplitude + n));
+        __m256i r = _mm256_add_epi32(_mm256_mullo_epi32(u, s), _mm256_mullo_epi32(v, c));
+        r = _mm256_srai_epi32(_mm256_add_epi32(r, round), Q15_SHIFT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(chroma + n), r);
+    }
+    return n;
+}
+
+#endif // ENCODE_ORC_MODULATOR_X86
+
+int32_t vector_kernel(const FixedLinePhase& line, const int32_t* sample_sin, const int32_t* sample_cos,
+                      const int32_t* v_amplitude, int32_t* chroma, int32_t width) {
+#ifdef ENCODE_ORC_MODULATOR_X86
+    switch (active_instruction_set()) {
+        case InstructionSet::AVX2: return modulate_avx2(line, sample_sin, sample_cos, v_amplitude, chroma, width);
+        case InstructionSet::SSE41: return modulate_sse41(line, sample_sin, sample_cos, v_amplitude, chroma, width);
+        default: break;
+    }
+#else
+    (void)line;
+    (void)sample_sin;
+    (void)sample_cos;
+    (void)v_amplitude;
+    (void)chroma;
+    (void)width;
+#endif
+    return 0;
+}
+
+const char* precision_name(LineModulator::Precision precision) {
+    return precision == LineModulator::Precision::Fixed ? "fixed" : "exact";
+}
+
+} // anonymous namespace
+
+LineModulator::LineModulator(const VideoParameters& params,
+                             std::shared_ptr<const SubcarrierTable> subcarrier,
+                             double u_max, double v_max)
+    : params_(params),
+      subcarrier_(std::move(subcarrier)),
+      u_max_(u_max),
+      v_max_(v_max),
+      active_start_(params.active_video_start),
+      active_width_(params.active_video_end - params.active_video_start),
+      black_level_(params.black_16b_ire),
+      luma_range_(params.white_16b_ire - params.black_16b_ire) {
+    if (default_precision() == Precision::Fixed && build_fixed_tables()) {
+        precision_ = Precision::Fixed;
+    }
+}
+
+bool LineModulator::build_fixed_tables() {
+    if (luma_range_ <= 0 || luma_range_ > 65535 || active_width_ <= 0) {
+        return false;
+    }
+    const double range = static_cast<double>(luma_range_);
+
+    // Studio codes: the luma level is the reference's own integer formula,
+    // the chroma amplitudes its normalised value times the luma range
+    int32_t largest = 0;
+    studio_luma_.resize(STUDIO_CODES);
+    studio_u_.resize(STUDIO_CODES);
+    studio_v_.resize(STUDIO_CODES);
+    for (int32_t code = 0; code < STUDIO_CODES; ++code) {
+        studio_luma_[code] = black_level_ + ((code - 64) * luma_range_) / 876;
+        const double norm = (static_cast<double>(code) / 896.0) - 0.5;
+        studio_u_[code] = static_cast<int32_t>(std::lround(norm * 2.0 * u_max_ * range));
+        studio_v_[code] = static_cast<int32_t>(std::lround(norm * 2.0 * v_max_ * range));
+        largest = std::max({largest, std::abs(studio_u_[code]), std::abs(studio_v_[code])});
+    }
+
+    // Full range: amplitude = (x - 32767.5) * 2 * max * range / 65535
+    full_luma_scale_ = static_cast<uint32_t>(std::lround(range * 65536.0 / 65535.0));
+    const double u_step = 2.0 * u_max_ * range / 65535.0;
+    const double v_step = 2.0 * v_max_ * range / 65535.0;
+    full_u_scale_ = static_cast<int32_t>(std::lround(u_step * Q15_ONE));
+    full_v_scale_ = static_cast<int32_t>(std::lround(v_step * Q15_ONE));
+    full_u_offset_ = static_cast<int32_t>(std::lround(0.5 * u_step * Q15_ONE)) + Q15_ROUND;
+    full_v_offset_ = static_cast<int32_t>(std::lround(0.5 * v_step * Q15_ONE)) + Q15_ROUND;
+    largest = std::max({largest, static_cast<int32_t>(std::ceil(32768.0 * u_step)),
+                        static_cast<int32_t>(std::ceil(32768.0 * v_step))});
+    if (largest > MAX_AMPLITUDE) {
+        return false;
+    }
+
+    const SubcarrierTable::LinePhase origin;
+    sample_sin_.resize(active_width_);
+    sample_cos_.resize(active_width_);
+    for (int32_t n = 0; n < active_width_; ++n) {
+        sample_sin_[n] = to_q15(subcarrier_->sin_at(origin, active_start_ + n));
+        sample_cos_[n] = to_q15(subcarrier_->cos_at(origin, active_start_ + n));
+    }
+
+    // Luma: at most one level from the full-range scale factor. Chroma: the
+    // Q15 line and sample phases and the rotation between them put each of
+    // sin and cos within 2 Q15 units, plus half a level from rounding each
+    // amplitude and from the final shift, plus one for the reference's
+    // truncation
+    const double chroma_error = 2.0 * largest * 2.0 / Q15_ONE + 0.5 * std::sqrt(2.0) + 0.5 + 1.0;
+    fixed_error_bound_ = std::max(1, static_cast<int32_t>(chroma_error) + 1);
+    return true;
+}
+
+void LineModulator::modulate(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                             bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                             int32_t* luma, int32_t* chroma) const {
+    if (precision_ == Precision::Exact) {
+        modulate_reference(y, u, v, studio_range_input, line_phase, luma, chroma);
+        return;
+    }
+
+    modulate_fixed(y, u, v, studio_range_input, line_phase, luma, chroma);
+    if (s_verification.load(std::memory_order_relaxed)) {
+        verify(y, u, v, studio_range_input, line_phase, luma, chroma);
+    }
+}
+
+void LineModulator::modulate_reference(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                                       bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                                       int32_t* luma, int32_t* chroma) const {
+    // The range test is hoisted out of the sample loops so they stay
+    // branch-free and vectorise
+    if (studio_range_input) {
+        // Preserve sub-black: don't clamp, allow negative values
+        for (int32_t n = 0; n < active_width_; ++n) {
+            luma[n] = black_level_ + ((static_cast<int32_t>(y[n]) - 64) * luma_range_) / 876;
+        }
+    } else {
+        for (int32_t n = 0; n < active_width_; ++n) {
+            double y_norm = static_cast<double>(y[n]) / 65535.0;
+            luma[n] = black_level_ + static_cast<int32_t>(y_norm * luma_range_);
+        }
+    }
+
+    // Studio chroma is 0-896 (64-960 studio codes), full-range 0-65535
+    const SubcarrierTable& subcarrier = *subcarrier_;
+    const double v_switch = line_phase.v_switch;
+    const double chroma_scale = studio_range_input ? 896.0 : 65535.0;
+    for (int32_t n = 0; n < active_width_; ++n) {
+        double u_norm = ((static_cast<double>(u[n]) / chroma_scale) - 0.5) * 2.0 * u_max_;
+        double v_norm = ((static_cast<double>(v[n]) / chroma_scale) - 0.5) * 2.0 * v_max_;
+        double value = (u_norm * subcarrier.sin_at(line_phase, active_start_ + n)) +
+                       (v_norm * v_switch * subcarrier.cos_at(line_phase, active_start_ + n));
+        chroma[n] = static_cast<int32_t>(value * luma_range_);
+    }
+}
+
+void LineModulator::modulate_fixed(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                                   bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                                   int32_t* luma, int32_t* chroma) const {
+    // Levels first: luma straight to its output, the U amplitudes into
+    // chroma (modulated in place below) and the V amplitudes aside
+    thread_local std::vector<int32_t> v_amplitude;
+    v_amplitude.resize(active_width_);
+    int32_t* v_amp = v_amplitude.data();
+
+    if (studio_range_input) {
+        const int32_t* luma_table = studio_luma_.data();
+        const int32_t* u_table = studio_u_.data();
+        const int32_t* v_table = studio_v_.data();
+        for (int32_t n = 0; n < active_width_; ++n) {
+            if (y[n] < STUDIO_CODES && u[n] < STUDIO_CODES && v[n] < STUDIO_CODES) {
+                luma[n] = luma_table[y[n]];
+                chroma[n] = u_table[u[n]];
+                v_amp[n] = v_table[v[n]];
+                continue;
+            }
+            // Overshoot past the 10-bit codes (interpolated edges) is
+            // worked out directly and kept inside the fixed-point range
+            const double range = static_cast<double>(luma_range_);
+            const double u_norm = (static_cast<double>(u[n]) / 896.0) - 0.5;
+            const double v_norm = (static_cast<double>(v[n]) / 896.0) - 0.5;
+            luma[n] = black_level_ + ((static_cast<int32_t>(y[n]) - 64) * luma_range_) / 876;
+            chroma[n] = static_cast<int32_t>(std::clamp<long>(std::lround(u_norm * 2.0 * u_max_ * range),
+                                                              -MAX_AMPLITUDE, MAX_AMPLITUDE));
+            v_amp[n] = static_cast<int32_t>(std::clamp<long>(std::lround(v_norm * 2.0 * v_max_ * range),
+                                                             -MAX_AMPLITUDE, MAX_AMPLITUDE));
+        }
+    } else {
+        for (int32_t n = 0; n < active_width_; ++n) {
+            luma[n] = black_level_ + static_cast<int32_t>((static_cast<uint32_t>(y[n]) * full_luma_scale_) >> 16);
+            chroma[n] = ((static_cast<int32_t>(u[n]) - 32768) * full_u_scale_ + full_u_offset_) >> Q15_SHIFT;
+            v_amp[n] = ((static_cast<int32_t>(v[n]) - 32768) * full_v_scale_ + full_v_offset_) >> Q15_SHIFT;
+        }
+    }
+
+    FixedLinePhase line;
+    line.sin = to_q15(line_phase.sin);
+    line.cos = to_q15(line_phase.cos);
+    line.v_sin = line.sin * line_phase.v_switch;
+    line.v_cos = line.cos * line_phase.v_switch;
+
+    const int32_t* sample_sin = sample_sin_.data();
+    const int32_t* sample_cos = sample_cos_.data();
+    int32_t n = vector_kernel(line, sample_sin, sample_cos, v_amp, chroma, active_width_);
+    for (; n < active_width_; ++n) {
+        chroma[n] = modulate_sample(line, sample_sin[n], sample_cos[n], chroma[n], v_amp[n]);
+    }
+}
+
+void LineModulator::verify(const uint16_t* y, const uint16_t* u, const uint16_t* v,
+                           bool studio_range_input, const SubcarrierTable::LinePhase& line_phase,
+                           const int32_t* luma, const int32_t* chroma) const {
+    thread_local std::vector<int32_t> reference_luma;
+    thread_local std::vector<int32_t> reference_chroma;
+    reference_luma.resize(active_width_);
+    reference_chroma.resize(active_width_);
+    modulate_reference(y, u, v, studio_range_input, line_phase, reference_luma.data(), reference_chroma.data());
+
+    const int32_t bound = error_bound();
+    for (int32_t n = 0; n < active_width_; ++n) {
+        const int32_t error = std::max(std::abs(luma[n] - reference_luma[n]),
+                                       std::abs(chroma[n] - reference_chroma[n]));
+        if (error > bound) {
+            throw std::runtime_error(std::string("Line modulator verification failed (") +
+                                     precision_name(precision_) + ", " + instruction_set() +
+                                     "): sample " + std::to_string(n) + " differs by " +
+                                     std::to_string(error) + ", bound is " + std::to_string(bound));
+        }
+    }
+}
+
+int32_t LineModulator::error_bound() const {
+    return precision_ == Precision::Fixed ? fixed_error_bound_ : 0;
+}
+
+void LineModulator::set_default_precision(Precision precision) {
+    s_default_precision.store(precision);
+}
+
+LineModulator::Precision LineModulator::default_precision() {
+    return s_default_precision.load();
+}
+
+void LineModulator::set_verification(bool enabled) {
+    s_verification.store(enabled);
+}
+
+bool LineModulator::verification_enabled() {
+    return s_verification.load();
+}
+
+bool LineModulator::set_instruction_set(const std::string& name) {
+    InstructionSet requested;
+    if (name == "avx2") {
+        requested = InstructionSet::AVX2;
+    } else if (name == "sse4.1") {
+        requested = InstructionSet::SSE41;
+    } else if (name == "scalar") {
+        requested = InstructionSet::Scalar;
+    } else {
+        return false;
+    }
+    if (requested > supported_instruction_set()) {
+        return false;
+    }
+    s_instruction_set.store(requested);
+    return true;
+}
+
+const char* LineModulator::instruction_set() {
+    switch (active_instruction_set()) {
+        case InstructionSet::AVX2: return "avx2";
+        case InstructionSet::SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+} // namespace encode_orc
@@ -0,0 +1,72 @@
+/*
+ * File:        line_template_cache.cpp
+ * Module:      encode-orc
+ * Purpose:     Cache of the fixed sync, blanking and burst lines of a field
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "line_template_cache.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace encode_orc {
+
+LineTemplateCache::LineTemplateCache(int32_t line_width, int32_t num_lines, int32_t sequence_fields,
+                                     Generator generator)
+    : line_width_(line_width),
+      num_lines_(num_lines),
+      sequence_fields_(std::max(1, sequence_fields)),
+      generator_(std::move(generator)),
+      templates_(static_cast<size_t>(sequence_fields_) * num_lines_),
+      scratch_(line_width_) {
+}
+
+void LineTemplateCache::copy(uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
+    const int32_t sequence_field = field_number % sequence_fields_;
+
+    // Lines outside the cached range are generated every time
+    if (line_number < 0 || line_number >= num_lines_) {
+        std::fill_n(line_buffer, line_width_, static_cast<uint16_t>(0));
+        generator_(line_buffer, line_number, sequence_field);
+        return;
+    }
+
+    Template& entry = templates_[static_cast<size_t>(sequence_field) * num_lines_ + line_number];
+    if (!entry.built) {
+        build(entry, line_number, sequence_field);
+    }
+    
+    const size_t head_length = entry.head.size();
+    std::memcpy(line_buffer, entry.head.data(), head_length * sizeof(uint16_t));
+    std::fill(line_buffer + head_length, line_buffer + line_width_, entry.tail);
+}
+
+void LineTemplateCache::prepare(int32_t field_number) {
+    const int32_t sequence_field = field_number % sequence_fields_;
+    for (int32_t line_number = 0; line_number < num_lines_; ++line_number) {
+        Template& entry = templates_[static_cast<size_t>(sequence_field) * num_lines_ + line_number];
+        if (!entry.built) {
+            build(entry, line_number, sequence_field);
+        }
+    }
+}
+
+void LineTemplateCache::build(Template& entry, int32_t line_number, int32_t sequence_field) {
+    std::fill(scratch_.begin(), scratch_.end(), static_cast<uint16_t>(0));
+    generator_(scratch_.data(), line_number, sequence_field);
+
+    int32_t head_length = line_width_;
+    if (line_width_ > 0) {
+        entry.tail = scratch_[line_width_ - 1];
+        while (head_length > 0 && scratch_[head_length - 1] == entry.tail) {
+            --head_length;
+        }
+    }
+    entry.head.assign(scratch_.begin(), scratch_.begin() + head_length);
+    entry.built = true;
+}
+
+} // namespace encode_orc
@@ -0,0 +1,106 @@
+/*
+ * File:        line_thread_pool.cpp
+ * Module:      encode-orc
+ * Purpose:     Threads that share out the lines of a single field
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "line_thread_pool.h"
+#include <algorithm>
+
+namespace encode_orc {
+
+LineThreadPool::LineThreadPool(int32_t num_threads) {
+    const int32_t pool_threads = std::max(1, num_threads - 1);
+    threads_.reserve(pool_threads);
+    for (int32_t i = 0; i < pool_threads; ++i) {
+        threads_.emplace_back(&LineThreadPool::thread_loop, this);
+    }
+}
+
+LineThreadPool::~LineThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void LineThreadPool::run(int32_t begin, int32_t end, const std::function<void(int32_t line)>& line_function) {
+    if (begin >= end) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        line_function_ = &line_function;
+        next_line_.store(begin);
+        end_line_ = end;
+        busy_ = static_cast<int32_t>(threads_.size());
+        error_ = nullptr;
+        ++generation_;
+    }
+    work_ready_.notify_all();
+
+    work();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_done_.wait(lock, [this] { return busy_ == 0; });
+        line_function_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void LineThreadPool::thread_loop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        work();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busy_;
+        }
+        work_done_.notify_one();
+    }
+}
+
+void LineThreadPool::work() {
+    for (;;) {
+        const int32_t line = next_line_.fetch_add(1);
+        if (line >= end_line_) {
+            return;
+        }
+        try {
+            (*line_function_)(line);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            // Skip the rest of the range
+            next_line_.store(end_line_);
+        }
+    }
+}
+
+} // namespace encode_orc
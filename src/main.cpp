@@ -9,15 +9,192 @@
 
 #include "yaml_config.h"
 #include "video_encoder.h"
-#include "metadata_generator.h"
+#include "metadata_builder.h"
 #include "video_parameters.h"
 #include "logging.h"
 #include "mov_loader.h"
 #include "mp4_loader.h"
 #include "version.h"
-#include <iostream>
+#include "fir_filter.h"
+#include "horizontal_resampler.h"
+#include "line_modulator.h"
+#include "buffered_tbc_file.h"
+#include "tbc_output_sink.h"
+#include "output_plan.h"
+#include "buffer_pool.h"
+#include "checkpoint.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
 #include <fstream>
+#include <iostream>
 #include <cstdio>
+#include <sstream>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Options followed by a value, which is never the project file
+const std::set<std::string> OPTIONS_WITH_VALUE = {
+    "--log-level", "--log-file", "--threads", "--line-threads", "--parallel-sections",
+    "--filter-precision", "--resampler", "--modulator"
+};
+
+/**
+ * @brief Parse a whole command line argument as an integer
+ * @param text Argument text
+ * @param value Set to the number on success
+ * @return true if @p text is a number and nothing else, false otherwise
+ */
+bool parse_int_option(const std::string& text, int32_t& value) {
+    try {
+        size_t used = 0;
+        const int32_t parsed = std::stoi(text, &used);
+        if (used != text.size()) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// Longest stretch of encoding an interrupted run can lose
+constexpr double CHECKPOINT_INTERVAL_SECONDS = 10.0;
+
+/**
+ * @brief Encode one section into an output sink
+ * @param encoder Encoder to use (kept between sections)
+ * @param output Sink the section's fields are written to
+ * @param section Section to encode
+ * @param system Video system
+ * @param source_standard Project source video standard
+ * @param first_frame First frame to encode; earlier frames are already in the output (resume)
+ * @param section_frames Set to the number of frames in the section
+ * @return true on success (or nothing to encode), false on error (see encoder.get_error())
+ */
+bool encode_section(encode_orc::VideoEncoder& encoder, encode_orc::TBCOutputSink& output,
+                    const encode_orc::VideoSection& section, encode_orc::VideoSystem system,
+                    encode_orc::SourceVideoStandard source_standard, int32_t first_frame,
+                    int32_t& section_frames) {
+    section_frames = 0;
+    if (!section.yuv422_image_source && !section.png_image_source &&
+        !section.mov_file_source && !section.mp4_file_source) {
+        return true;
+    }
+    
+    // Get filter settings (use defaults if not specified)
+    bool enable_chroma_filter = true;  // Default: enabled
+    bool enable_luma_filter = false;   // Default: disabled
+    
+    if (section.filters) {
+        enable_chroma_filter = section.filters->chroma.enabled;
+        enable_luma_filter = section.filters->luma.enabled;
+    }
+    
+    bool ok = false;
+    if (section.yuv422_image_source) {
+        std::string yuv422_file = section.yuv422_image_source->file;
+        section_frames = section.duration.value();
+        ok = encoder.encode_yuv422_image(output,
+                                        system, source_standard, yuv422_file,
+                                        section_frames,
+                                        enable_chroma_filter, enable_luma_filter, first_frame);
+    } else if (section.png_image_source) {
+        std::string png_file = section.png_image_source->file;
+        section_frames = section.duration.value();
+        ok = encoder.encode_png_image(output,
+                                      system, source_standard, png_file,
+                                      section_frames,
+                                      enable_chroma_filter, enable_luma_filter, first_frame);
+    } else if (section.mov_file_source) {
+        std::string mov_file = section.mov_file_source->file;
+        int32_t start_frame = section.mov_file_source->start_frame.value_or(0);
+        section_frames = section.duration.value();  // Already populated in preprocessing
+        
+        ok = encoder.encode_mov_file(output,
+                                    system, source_standard, mov_file,
+                                    section_frames, start_frame,
+                                    enable_chroma_filter, enable_luma_filter, first_frame);
+    } else if (section.mp4_file_source) {
+        std::string mp4_file = section.mp4_file_source->file;
+        int32_t start_frame = section.mp4_file_source->start_frame.value_or(0);
+        section_frames = section.duration.value();  // Already populated in preprocessing
+        
+        ok = encoder.encode_mp4_file(output,
+                                    system, source_standard, mp4_file,
+                                    section_frames, start_frame,
+                                    enable_chroma_filter, enable_luma_filter, first_frame);
+    }
+    return ok;
+}
+
+/**
+ * @brief Fingerprint of everything that decides the output, for the resume checkpoint
+ * @param yaml_file Project file
+ * @param config Parsed project (for its source files)
+ * @param settings Output-affecting command line settings, as text
+ */
+uint64_t project_fingerprint(const std::string& yaml_file, const encode_orc::YAMLProjectConfig& config,
+                             const std::string& settings) {
+    std::ostringstream text;
+    std::ifstream project(yaml_file, std::ios::binary);
+    text << project.rdbuf() << "\n" << ENCODE_ORC_GIT_COMMIT << "\n" << settings << "\n";
+    
+    // A replaced source file changes the output even if the project does not
+    for (const auto& section : config.sections) {
+        std::string source;
+        if (section.yuv422_image_source) {
+            source = section.yuv422_image_source->file;
+        } else if (section.png_image_source) {
+            source = section.png_image_source->file;
+        } else if (section.mov_file_source) {
+            source = section.mov_file_source->file;
+        } else if (section.mp4_file_source) {
+            source = section.mp4_file_source->file;
+        } else {
+            continue;
+        }
+        std::error_code error;
+        const auto size = std::filesystem::file_size(source, error);
+        const auto modified = std::filesystem::last_write_time(source, error);
+        text << source << " " << size << " " << modified.time_since_epoch().count() << "\n";
+    }
+    return encode_orc::Checkpoint::fingerprint(text.str());
+}
+
+/**
+ * @brief Record that the fields from @p from_field up to @p synced_field are on disk
+ * 
+ * Updates every section overlapping that range and saves the checkpoint.
+ * Progress never goes backwards, and a failed save only costs the chance
+ * to resume from here, so it is a warning.
+ */
+void record_progress(encode_orc::Checkpoint& checkpoint, const encode_orc::OutputPlan& plan,
+                     size_t section_count, int64_t from_field, int64_t synced_field) {
+    for (size_t i = 0; i < section_count; ++i) {
+        const encode_orc::OutputPlan::Extent& extent = plan.section(i);
+        if (extent.first_field + extent.field_count <= from_field || extent.first_field >= synced_field) {
+            continue;
+        }
+        const int64_t fields = std::min(extent.field_count, synced_field - extent.first_field);
+        if (fields > checkpoint.section_fields(i)) {
+            checkpoint.set_section_fields(i, fields);
+        }
+    }
+    
+    std::string error;
+    if (!checkpoint.save(error)) {
+        ENCODE_ORC_LOG_WARN("{}", error);
+    }
+}
+
+} // namespace
 
 int main(int argc, char* argv[]) {
     using namespace encode_orc;
@@ -42,11 +219,36 @@ int main(int argc, char* argv[]) {
             std::cout << "                          (trace, debug, info, warn, error, critical, off)\n";
             std::cout << "                          Default: info\n";
             std::cout << "  --log-file FILE         Write logs to specified file\n";
+            std::cout << "  --threads N             Number of encoding threads (0 = one per CPU)\n";
+            std::cout << "                          Overrides output.threads in the project file\n";
+            std::cout << "  --line-threads N        Threads sharing the lines of each field (default: 1)\n";
+            std::cout << "                          For low-latency previews; use with --threads 1\n";
+            std::cout << "  --parallel-sections N   Encode up to N sections at once, each written to its\n";
+            std::cout << "                          own region of the output (default: 1)\n";
+            std::cout << "  --filter-precision MODE Arithmetic for the chroma/luma FIR filters\n";
+            std::cout << "                          (exact, float, fixed) Default: exact\n";
+            std::cout << "  --verify-filters        Check every filtered line against the reference\n";
+            std::cout << "                          double-precision filter (slow)\n";
+            std::cout << "  --resampler MODE        Mapping of source pixels onto the active line\n";
+            std::cout << "                          (nearest, polyphase) Default: nearest\n";
+            std::cout << "  --modulator MODE        Arithmetic for the luma levels and chroma modulation\n";
+            std::cout << "                          (exact, fixed) Default: exact\n";
+            std::cout << "  --verify-modulator      Check every modulated line against the reference\n";
+            std::cout << "                          double-precision kernel (slow)\n";
+            std::cout << "  --direct-io             Write output with O_DIRECT (bypass the page cache)\n";
+            std::cout << "  --huge-pages            Back large frame buffers with transparent huge pages\n";
+            std::cout << "  --resume                Continue an interrupted encode from its checkpoint\n";
+            std::cout << "                          (<output>.checkpoint, kept until the encode completes)\n";
             std::cout << "\n";
             std::cout << "Examples:\n";
             std::cout << "  " << argv[0] << " project.yaml\n";
             std::cout << "  " << argv[0] << " project.yaml --log-level debug\n";
             std::cout << "  " << argv[0] << " project.yaml --log-level debug --log-file debug.log\n";
+            std::cout << "  " << argv[0] << " project.yaml --threads 8\n";
+            std::cout << "  " << argv[0] << " project.yaml --parallel-sections 4\n";
+            std::cout << "  " << argv[0] << " project.yaml --resume\n";
+            std::cout << "  " << argv[0] << " project.yaml --filter-precision float --verify-filters\n";
+            std::cout << "  " << argv[0] << " project.yaml --modulator fixed --verify-modulator\n";
             return 0;
         }
     }
@@ -54,12 +256,94 @@ int main(int argc, char* argv[]) {
     // Parse command-line arguments to extract logging options
     std::string log_level = "info";
     std::string log_file = "";
+    std::optional<int32_t> cli_threads;
+    int32_t line_threads = 1;
+    int32_t parallel_sections = 1;
+    FIRFilter::Precision filter_precision = FIRFilter::Precision::Exact;
+    bool verify_filters = false;
+    HorizontalResampler::Mode resampler_mode = HorizontalResampler::Mode::Nearest;
+    LineModulator::Precision modulator_precision = LineModulator::Precision::Exact;
+    bool verify_modulator = false;
+    bool direct_io = false;
+    bool huge_pages = false;
+    bool resume = false;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--log-level" && i + 1 < argc) {
             log_level = argv[++i];
         } else if (arg == "--log-file" && i + 1 < argc) {
             log_file = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            int32_t value = 0;
+            if (!parse_int_option(argv[++i], value)) {
+                std::cerr << "Invalid value for --threads: " << argv[i] << "\n";
+                return 1;
+            }
+            cli_threads = value;
+            if (cli_threads.value() < 0) {
+                std::cerr << "--threads must be 0 (auto) or a positive number\n";
+                return 1;
+            }
+        } else if (arg == "--line-threads" && i + 1 < argc) {
+            if (!parse_int_option(argv[++i], line_threads)) {
+                std::cerr << "Invalid value for --line-threads: " << argv[i] << "\n";
+                return 1;
+            }
+            if (line_threads < 1) {
+                std::cerr << "--line-threads must be a positive number\n";
+                return 1;
+            }
+        } else if (arg == "--parallel-sections" && i + 1 < argc) {
+            if (!parse_int_option(argv[++i], parallel_sections)) {
+                std::cerr << "Invalid value for --parallel-sections: " << argv[i] << "\n";
+                return 1;
+            }
+            if (parallel_sections < 1) {
+                std::cerr << "--parallel-sections must be a positive number\n";
+                return 1;
+            }
+        } else if (arg == "--filter-precision" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "exact") {
+                filter_precision = FIRFilter::Precision::Exact;
+            } else if (mode == "float") {
+                filter_precision = FIRFilter::Precision::Float;
+            } else if (mode == "fixed") {
+                filter_precision = FIRFilter::Precision::Fixed;
+            } else {
+                std::cerr << "Invalid value for --filter-precision: " << mode << " (exact, float or fixed)\n";
+                return 1;
+            }
+        } else if (arg == "--verify-filters") {
+            verify_filters = true;
+        } else if (arg == "--resampler" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "nearest") {
+                resampler_mode = HorizontalResampler::Mode::Nearest;
+            } else if (mode == "polyphase") {
+                resampler_mode = HorizontalResampler::Mode::Polyphase;
+            } else {
+                std::cerr << "Invalid value for --resampler: " << mode << " (nearest or polyphase)\n";
+                return 1;
+            }
+        } else if (arg == "--modulator" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "exact") {
+                modulator_precision = LineModulator::Precision::Exact;
+            } else if (mode == "fixed") {
+                modulator_precision = LineModulator::Precision::Fixed;
+            } else {
+                std::cerr << "Invalid value for --modulator: " << mode << " (exact or fixed)\n";
+                return 1;
+            }
+        } else if (arg == "--verify-modulator") {
+            verify_modulator = true;
+        } else if (arg == "--direct-io") {
+            direct_io = true;
+        } else if (arg == "--huge-pages") {
+            huge_pages = true;
+        } else if (arg == "--resume") {
+            resume = true;
         }
     }
     
@@ -78,16 +362,7 @@ int main(int argc, char* argv[]) {
     std::string yaml_file;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
-        if (arg[0] != '-' && (i + 1 >= argc || argv[i + 1][0] == '-' || 
-            (i > 0 && (std::string(argv[i - 1]) == "--log-level" || 
-                       std::string(argv[i - 1]) == "--log-file")))) {
-            // Check if this is a value for an option
-            if (i > 0) {
-                std::string prev_arg = argv[i - 1];
-                if (prev_arg == "--log-level" || prev_arg == "--log-file") {
-                    continue;
-                }
-            }
+        if (arg[0] != '-' && !OPTIONS_WITH_VALUE.count(argv[i - 1])) {
             yaml_file = arg;
             break;
         }
@@ -257,33 +532,9 @@ int main(int argc, char* argv[]) {
     ENCODE_ORC_LOG_INFO("Total frames to encode: {}", total_frames);
     
     // Encode video for each section
-    std::ofstream tbc_file;
     bool is_separate_yc = (config.output.mode == "separate-yc" || config.output.mode == "separate-yc-legacy");
     bool is_yc_legacy = (config.output.mode == "separate-yc-legacy");
     
-    // For combined mode, open the single output file
-    if (!is_separate_yc) {
-        tbc_file.open(config.output.filename, std::ios::binary);
-        if (!tbc_file) {
-            ENCODE_ORC_LOG_ERROR("Could not open output file: {}", config.output.filename);
-            return 1;
-        }
-    } else {
-        // For Y/C mode, delete any pre-existing output files to ensure clean start
-        std::string base_out = config.output.filename;
-        if (base_out.length() > 4 && base_out.substr(base_out.length() - 4) == ".tbc") {
-            base_out = base_out.substr(0, base_out.length() - 4);
-        }
-        
-        if (is_yc_legacy) {
-            std::remove((base_out + ".tbc").c_str());
-            std::remove((base_out + "_chroma.tbc").c_str());
-        } else {
-            std::remove((base_out + ".tbcy").c_str());
-            std::remove((base_out + ".tbcc").c_str());
-        }
-    }
-    
     // Set video level overrides if specified in YAML
     if (has_video_level_overrides) {
         VideoEncoder::set_video_level_overrides(
@@ -293,204 +544,290 @@ int main(int argc, char* argv[]) {
         );
     }
     
-    int32_t frame_offset = 0;
-    for (const auto& section : config.sections) {
-        ENCODE_ORC_LOG_INFO("Encoding section: {}", section.name);
+    // Command line takes precedence over the project file
+    int32_t num_threads = cli_threads.value_or(config.output.threads.value_or(0));
+    ENCODE_ORC_LOG_INFO("Encoding threads: {}", num_threads > 0 ? std::to_string(num_threads) : "auto");
+    if (line_threads > 1) {
+        ENCODE_ORC_LOG_INFO("Line threads per field: {}", line_threads);
+    }
+    
+    // Filters pick these up when the encoders create them
+    FIRFilter::set_default_precision(filter_precision);
+    FIRFilter::set_verification(verify_filters);
+    ENCODE_ORC_LOG_DEBUG("FIR filter kernels: {}{}", FIRFilter::instruction_set(),
+                         verify_filters ? " (verified against reference)" : "");
+    
+    HorizontalResampler::set_default_mode(resampler_mode);
+    ENCODE_ORC_LOG_DEBUG("Horizontal resampler: {}",
+                         resampler_mode == HorizontalResampler::Mode::Polyphase ? "polyphase" : "nearest");
+    
+    LineModulator::set_default_precision(modulator_precision);
+    LineModulator::set_verification(verify_modulator);
+    ENCODE_ORC_LOG_DEBUG("Line modulator: {} ({}){}",
+                         modulator_precision == LineModulator::Precision::Fixed ? "fixed" : "exact",
+                         LineModulator::instruction_set(),
+                         verify_modulator ? " (verified against reference)" : "");
+    
+    BufferedTBCFile::set_default_direct_io(direct_io);
+    SampleStorage::set_huge_pages(huge_pages);
+    
+    // Every field is the same size and every duration is known by now, so
+    // the output size and each section's place in it are fixed up front
+    const VideoParameters layout = (system == VideoSystem::PAL)
+                                   ? VideoParameters::create_pal_composite()
+                                   : VideoParameters::create_ntsc_composite();
+    const OutputPlan plan(config.sections, layout, is_separate_yc);
+    ENCODE_ORC_LOG_DEBUG("Output plan: {} fields, {} bytes per file ({} file(s))",
+                         plan.total_fields(), plan.file_bytes(), plan.file_count());
+    
+    // Metadata is built once from the plan; its VBI schedule is what the
+    // encoders render and what is written out after encoding
+    MetadataBuilder metadata;
+    std::string meta_error;
+    if (!metadata.build(config, system, plan, meta_error)) {
+        ENCODE_ORC_LOG_ERROR("Metadata generation error: {}", meta_error);
+        return 1;
+    }
+    
+    // Progress is checkpointed as the output reaches the disk, so an
+    // interrupted encode can carry on with --resume. The checkpoint is only
+    // accepted for the same project, sources, build and settings.
+    const size_t section_count = config.sections.size();
+    std::ostringstream settings;
+    settings << static_cast<int>(filter_precision) << " " << static_cast<int>(resampler_mode) << " "
+             << static_cast<int>(modulator_precision) << " " << plan.total_fields() << " " << plan.file_bytes();
+    Checkpoint checkpoint(config.output.filename, project_fingerprint(yaml_file, config, settings.str()),
+                          section_count);
+    
+    bool resuming = false;
+    if (resume && checkpoint.exists()) {
+        std::string checkpoint_error;
+        if (!checkpoint.load(checkpoint_error)) {
+            ENCODE_ORC_LOG_ERROR("Cannot resume: {}", checkpoint_error);
+            return 1;
+        }
+        for (const auto& filename : TBCOutputSink::filenames_for(config.output.filename, is_separate_yc,
+                                                                 is_yc_legacy)) {
+            std::error_code size_error;
+            const auto size = std::filesystem::file_size(filename, size_error);
+            if (size_error || static_cast<int64_t>(size) != plan.file_bytes()) {
+                ENCODE_ORC_LOG_ERROR("Cannot resume: {} is missing or not the planned size", filename);
+                return 1;
+            }
+        }
+        resuming = true;
+        ENCODE_ORC_LOG_INFO("Resuming from {}: {} of {} fields already encoded",
+                            checkpoint.filename(), checkpoint.total_fields(), plan.total_fields());
+    } else if (resume) {
+        ENCODE_ORC_LOG_INFO("No checkpoint {}, encoding from the start", checkpoint.filename());
+    }
+    
+    // Every section is written straight into the final output file(s), with
+    // the space reserved before anything is encoded so a full disk fails now.
+    // A resumed encode keeps the existing files and fills in what is missing.
+    TBCOutputSink output;
+    if (!resuming) {
+        if (!output.open(config.output.filename, is_separate_yc, is_yc_legacy)) {
+            ENCODE_ORC_LOG_ERROR("{}", output.error());
+            return 1;
+        }
+        if (!output.reserve(plan.file_bytes())) {
+            ENCODE_ORC_LOG_ERROR("Output error: {}", output.error());
+            return 1;
+        }
+        record_progress(checkpoint, plan, section_count, 0, 0);
+    }
+    
+    if (parallel_sections <= 1 || section_count <= 1) {
+        // One encoder for the whole project so its per-thread encoders are
+        // reconfigured between sections rather than rebuilt
+        VideoEncoder encoder;
+        encoder.set_num_threads(num_threads);
+        encoder.set_line_threads(line_threads);
+        encoder.set_vbi_schedule(&metadata.vbi_schedule());
         
-        // Track actual number of frames encoded in this section
-        int32_t section_frames = 0;
+        // Fields from here on are written in one run, without gaps
+        int64_t run_start = output.field_offset();
+        output.set_sync_interval(CHECKPOINT_INTERVAL_SECONDS, [&](int64_t synced_field) {
+            record_progress(checkpoint, plan, section_count, run_start, synced_field);
+        });
         
-        if (section.yuv422_image_source || section.png_image_source || section.mov_file_source || section.mp4_file_source) {
-            int32_t picture_start = 0;
-            int32_t chapter = 0;
-            std::string timecode_start = "";
+        for (size_t i = 0; i < section_count; ++i) {
+            const VideoSection& section = config.sections[i];
+            const OutputPlan::Extent& extent = plan.section(i);
             
-            if (section.laserdisc) {
-                if (section.laserdisc->picture_start) {
-                    picture_start = section.laserdisc->picture_start.value();
-                } else if (section.laserdisc->chapter) {
-                    chapter = section.laserdisc->chapter.value();
-                } else if (section.laserdisc->timecode_start) {
-                    timecode_start = section.laserdisc->timecode_start.value();
-                }
+            if (extent.field_count == 0) {
+                ENCODE_ORC_LOG_INFO("Encoding section: {}", section.name);
+                continue;
             }
             
-            // Get filter settings (use defaults if not specified)
-            bool enable_chroma_filter = true;  // Default: enabled
-            bool enable_luma_filter = false;   // Default: disabled
-            
-            if (section.filters) {
-                enable_chroma_filter = section.filters->chroma.enabled;
-                enable_luma_filter = section.filters->luma.enabled;
+            // Resume at a frame boundary so the colour sequence carries on
+            const int64_t done = checkpoint.section_fields(i) & ~static_cast<int64_t>(1);
+            if (done >= extent.field_count) {
+                ENCODE_ORC_LOG_INFO("Section already encoded: {}", section.name);
+                continue;
             }
+            ENCODE_ORC_LOG_INFO("Encoding section: {}", section.name);
             
-            VideoEncoder encoder;
-            bool ok = false;
-            if (section.yuv422_image_source) {
-                std::string yuv422_file = section.yuv422_image_source->file;
-                section_frames = section.duration.value();
-                ok = encoder.encode_yuv422_image(config.output.filename + ".temp",
-                                                system, config.laserdisc.standard, yuv422_file,
-                                                section_frames,
-                                                picture_start, chapter, timecode_start,
-                                                enable_chroma_filter, enable_luma_filter,
-                                                is_separate_yc, is_yc_legacy);
-            } else if (section.png_image_source) {
-                std::string png_file = section.png_image_source->file;
-                section_frames = section.duration.value();
-                ok = encoder.encode_png_image(config.output.filename + ".temp",
-                                              system, config.laserdisc.standard, png_file,
-                                              section_frames,
-                                              picture_start, chapter, timecode_start,
-                                              enable_chroma_filter, enable_luma_filter,
-                                              is_separate_yc, is_yc_legacy);
-            } else if (section.mov_file_source) {
-                std::string mov_file = section.mov_file_source->file;
-                int32_t start_frame = section.mov_file_source->start_frame.value_or(0);
-                section_frames = section.duration.value();  // Already populated in preprocessing
-                
-                ok = encoder.encode_mov_file(config.output.filename + ".temp",
-                                            system, config.laserdisc.standard, mov_file,
-                                            section_frames, start_frame,
-                                            picture_start, chapter, timecode_start,
-                                            enable_chroma_filter, enable_luma_filter,
-                                            is_separate_yc, is_yc_legacy);
-            } else if (section.mp4_file_source) {
-                std::string mp4_file = section.mp4_file_source->file;
-                int32_t start_frame = section.mp4_file_source->start_frame.value_or(0);
-                section_frames = section.duration.value();  // Already populated in preprocessing
-                
-                ok = encoder.encode_mp4_file(config.output.filename + ".temp",
-                                            system, config.laserdisc.standard, mp4_file,
-                                            section_frames, start_frame,
-                                            picture_start, chapter, timecode_start,
-                                            enable_chroma_filter, enable_luma_filter,
-                                            is_separate_yc, is_yc_legacy);
+            if (!output.is_open() || output.field_offset() != extent.first_field + done) {
+                if (!output.close() ||
+                    !output.open_section(config.output.filename, is_separate_yc, is_yc_legacy,
+                                         extent.first_field + done, plan.field_bytes())) {
+                    ENCODE_ORC_LOG_ERROR("Output error: {}", output.error());
+                    return 1;
+                }
+                run_start = extent.first_field + done;
+            }
+            if (done > 0) {
+                ENCODE_ORC_LOG_INFO("  Resuming at frame {}", done / 2);
             }
-            if (!ok) {
+            
+            int32_t section_frames = 0;
+            if (!encode_section(encoder, output, section, system, config.laserdisc.standard,
+                                static_cast<int32_t>(done / 2), section_frames)) {
                 ENCODE_ORC_LOG_ERROR("Encoding error: {}", encoder.get_error());
                 return 1;
             }
+            if (output.field_offset() != extent.first_field + extent.field_count) {
+                ENCODE_ORC_LOG_ERROR("Output error: wrote {} fields of section '{}', planned {}",
+                                     output.field_offset() - extent.first_field, section.name,
+                                     extent.field_count);
+                return 1;
+            }
+            if (!output.sync()) {
+                ENCODE_ORC_LOG_ERROR("Output error: {}", output.error());
+                return 1;
+            }
             
-            // Append temp file(s) to main output
-            if (is_separate_yc) {
-                // For separate Y/C mode, append both luma and chroma files
-                // Calculate base filename by removing .tbc extension if present
-                std::string base_out = config.output.filename;
-                if (base_out.length() > 4 && base_out.substr(base_out.length() - 4) == ".tbc") {
-                    base_out = base_out.substr(0, base_out.length() - 4);
+            ENCODE_ORC_LOG_DEBUG("  Fields {} - {}", extent.first_field, output.field_offset() - 1);
+            ENCODE_ORC_LOG_INFO("  ✓ Encoded {} frames", section_frames);
+        }
+        
+        // Direct I/O leaves a partial block buffered until the file is closed
+        const int64_t written = output.field_offset();
+        if (!output.close()) {
+            ENCODE_ORC_LOG_ERROR("Output error: {}", output.error());
+            return 1;
+        }
+        record_progress(checkpoint, plan, section_count, run_start, written);
+    } else {
+        // Sections open the reserved file(s) at their planned offsets
+        if (!output.close()) {
+            ENCODE_ORC_LOG_ERROR("Output error: {}", output.error());
+            return 1;
+        }
+        
+        // Share the encoding threads out between the sections in flight
+        const int32_t section_workers = std::min(parallel_sections, static_cast<int32_t>(section_count));
+        const int32_t threads_per_section =
+            std::max(1, FrameEncodePipeline::resolve_thread_count(num_threads) / section_workers);
+        ENCODE_ORC_LOG_INFO("Encoding {} sections at a time, {} thread(s) each",
+                            section_workers, threads_per_section);
+        
+        std::atomic<size_t> next_section{0};
+        std::atomic<bool> failed{false};
+        std::vector<std::string> section_errors(section_count);
+        
+        auto section_worker = [&]() {
+            // Each worker reuses its encoder for the sections it picks up
+            VideoEncoder encoder;
+            encoder.set_num_threads(threads_per_section);
+            encoder.set_line_threads(line_threads);
+            encoder.set_vbi_schedule(&metadata.vbi_schedule());
+            TBCOutputSink section_output;
+            
+            for (size_t i = next_section++; i < section_count && !failed; i = next_section++) {
+                const VideoSection& section = config.sections[i];
+                const OutputPlan::Extent& extent = plan.section(i);
+                if (extent.field_count == 0) {
+                    continue;
                 }
+                const int64_t done = checkpoint.section_fields(i) & ~static_cast<int64_t>(1);
+                if (done >= extent.field_count) {
+                    ENCODE_ORC_LOG_INFO("Section already encoded: {}", section.name);
+                    continue;
+                }
+                ENCODE_ORC_LOG_INFO("Encoding section: {}", section.name);
                 
-                if (is_yc_legacy) {
-                    // Legacy mode: base.tbc (luma) and base_chroma.tbc (chroma)
-                    // Temp files are named: config.output.filename + ".temp.tbc" and ".temp_chroma.tbc"
-                    // Final files are named: base_out + ".tbc" and base_out + "_chroma.tbc"
-                    
-                    // Append Y file (luma)
-                    std::ifstream temp_y_file(config.output.filename + ".temp.tbc", std::ios::binary);
-                    if (temp_y_file) {
-                        std::ios::openmode mode = (frame_offset == 0) ? std::ios::binary : (std::ios::binary | std::ios::app);
-                        std::ofstream out_y_file(base_out + ".tbc", mode);
-                        out_y_file << temp_y_file.rdbuf();
-                        temp_y_file.close();
-                        out_y_file.close();
-                        std::remove((config.output.filename + ".temp.tbc").c_str());
-                    } else {
-                        ENCODE_ORC_LOG_WARN("Could not open temp Y file: {}.temp.tbc", config.output.filename);
-                    }
-                    
-                    // Append C file (chroma)
-                    std::ifstream temp_c_file(config.output.filename + ".temp_chroma.tbc", std::ios::binary);
-                    if (temp_c_file) {
-                        std::ios::openmode mode = (frame_offset == 0) ? std::ios::binary : (std::ios::binary | std::ios::app);
-                        std::ofstream out_c_file(base_out + "_chroma.tbc", mode);
-                        out_c_file << temp_c_file.rdbuf();
-                        temp_c_file.close();
-                        out_c_file.close();
-                        std::remove((config.output.filename + ".temp_chroma.tbc").c_str());
-                    } else {
-                        ENCODE_ORC_LOG_WARN("Could not open temp C file: {}.temp_chroma.tbc", config.output.filename);
-                    }
-                } else {
-                    // Modern mode: base.tbcy (luma) and base.tbcc (chroma)
-                    // Temp files are named: config.output.filename + ".temp.tbcy" and ".temp.tbcc"
-                    // Final files are named: base_out + ".tbcy" and base_out + ".tbcc"
-                    
-                    // Append Y file
-                    std::ifstream temp_y_file(config.output.filename + ".temp.tbcy", std::ios::binary);
-                    if (temp_y_file) {
-                        std::ios::openmode mode = (frame_offset == 0) ? std::ios::binary : (std::ios::binary | std::ios::app);
-                        std::ofstream out_y_file(base_out + ".tbcy", mode);
-                        out_y_file << temp_y_file.rdbuf();
-                        temp_y_file.close();
-                        out_y_file.close();
-                        std::remove((config.output.filename + ".temp.tbcy").c_str());
-                    } else {
-                        ENCODE_ORC_LOG_WARN("Could not open temp Y file: {}.temp.tbcy", config.output.filename);
-                    }
-                    
-                    // Append C file
-                    std::ifstream temp_c_file(config.output.filename + ".temp.tbcc", std::ios::binary);
-                    if (temp_c_file) {
-                        std::ios::openmode mode = (frame_offset == 0) ? std::ios::binary : (std::ios::binary | std::ios::app);
-                        std::ofstream out_c_file(base_out + ".tbcc", mode);
-                        out_c_file << temp_c_file.rdbuf();
-                        temp_c_file.close();
-                        out_c_file.close();
-                        std::remove((config.output.filename + ".temp.tbcc").c_str());
-                    } else {
-                        ENCODE_ORC_LOG_WARN("Could not open temp C file: {}.temp.tbcc", config.output.filename);
-                    }
+                const int64_t run_start = extent.first_field + done;
+                section_output.set_sync_interval(CHECKPOINT_INTERVAL_SECONDS,
+                                                 [&, run_start](int64_t synced_field) {
+                    record_progress(checkpoint, plan, section_count, run_start, synced_field);
+                });
+                if (!section_output.open_section(config.output.filename, is_separate_yc, is_yc_legacy,
+                                                 run_start, plan.field_bytes())) {
+                    section_errors[i] = section_output.error();
+                    failed = true;
+                    break;
                 }
-            } else {
-                // For combined mode, append single .tbc file
-                std::ifstream temp_file(config.output.filename + ".temp", std::ios::binary);
-                if (temp_file) {
-                    tbc_file << temp_file.rdbuf();
-                    tbc_file.flush();  // Ensure data is written to disk
-                    temp_file.close();
-                    std::remove((config.output.filename + ".temp").c_str());
-                } else {
-                    ENCODE_ORC_LOG_WARN("Could not open temp file: {}.temp", config.output.filename);
+                if (done > 0) {
+                    ENCODE_ORC_LOG_INFO("  Resuming {} at frame {}", section.name, done / 2);
                 }
+                
+                int32_t section_frames = 0;
+                if (!encode_section(encoder, section_output, section, system, config.laserdisc.standard,
+                                    static_cast<int32_t>(done / 2), section_frames)) {
+                    section_errors[i] = encoder.get_error();
+                    failed = true;
+                    break;
+                }
+                if (!section_output.sync() || !section_output.close()) {
+                    section_errors[i] = section_output.error();
+                    failed = true;
+                    break;
+                }
+                
+                if (section_output.field_offset() != extent.first_field + extent.field_count) {
+                    const int64_t written = section_output.field_offset() - extent.first_field;
+                    section_errors[i] = "wrote " + std::to_string(written) + " fields, planned " +
+                                        std::to_string(extent.field_count);
+                    failed = true;
+                    break;
+                }
+                record_progress(checkpoint, plan, section_count, run_start, section_output.field_offset());
+                
+                ENCODE_ORC_LOG_DEBUG("  {}: fields {} - {}", section.name, extent.first_field,
+                                     section_output.field_offset() - 1);
+                ENCODE_ORC_LOG_INFO("  ✓ Encoded {} frames ({})", section_frames, section.name);
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        for (int32_t i = 1; i < section_workers; ++i) {
+            workers.emplace_back(section_worker);
+        }
+        section_worker();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        
+        // Report the first section (in project order) that failed
+        for (size_t i = 0; i < section_count; ++i) {
+            if (!section_errors[i].empty()) {
+                ENCODE_ORC_LOG_ERROR("Encoding error in section '{}': {}",
+                                     config.sections[i].name, section_errors[i]);
+                return 1;
             }
-            
-            std::remove((config.output.filename + ".temp.db").c_str());
-            std::remove((config.output.filename + ".temp.json").c_str());
-            
-            frame_offset += section_frames;
-            ENCODE_ORC_LOG_INFO("  ✓ Encoded {} frames", section_frames);
         }
     }
     
-    if (!is_separate_yc) {
-        tbc_file.close();
-    }
-    
-    // Generate metadata for entire file
-    std::string meta_error;
+    // Write metadata for entire file
     std::string metadata_filename = config.output.filename + ".db";
     
-    if (!generate_metadata(config, system, total_frames, metadata_filename, meta_error)) {
+    if (!metadata.write(metadata_filename, meta_error)) {
         ENCODE_ORC_LOG_ERROR("Metadata generation error: {}", meta_error);
         return 1;
     }
     
+    // The encode is complete, so there is nothing left to resume
+    checkpoint.remove();
+    
     ENCODE_ORC_LOG_INFO("Successfully generated {} frames", total_frames);
     if (is_separate_yc) {
-        std::string base_out = config.output.filename;
-        if (base_out.length() > 4 && base_out.substr(base_out.length() - 4) == ".tbc") {
-            base_out = base_out.substr(0, base_out.length() - 4);
-        }
-        if (is_yc_legacy) {
-            ENCODE_ORC_LOG_INFO("Output files:");
-            ENCODE_ORC_LOG_INFO("  {} (luma)", base_out + ".tbc");
-            ENCODE_ORC_LOG_INFO("  {} (chroma)", base_out + "_chroma.tbc");
-        } else {
-            ENCODE_ORC_LOG_INFO("Output files:");
-            ENCODE_ORC_LOG_INFO("  {} (luma)", base_out + ".tbcy");
-            ENCODE_ORC_LOG_INFO("  {} (chroma)", base_out + ".tbcc");
-        }
+        const auto output_filenames = TBCOutputSink::filenames_for(config.output.filename, true, is_yc_legacy);
+        ENCODE_ORC_LOG_INFO("Output files:");
+        ENCODE_ORC_LOG_INFO("  {} (luma)", output_filenames[0]);
+        ENCODE_ORC_LOG_INFO("  {} (chroma)", output_filenames[1]);
     } else {
         ENCODE_ORC_LOG_INFO("Output file: {}", config.output.filename);
     }
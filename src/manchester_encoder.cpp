@@ -10,6 +10,7 @@
 #include "manchester_encoder.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace encode_orc {
 
@@ -119,4 +120,53 @@ void ManchesterEncoder::render_bits(const std::vector<uint8_t>& bits,
     }
 }
 
+ManchesterBitCells::ManchesterBitCells(int32_t samples_per_bit,
+                                       uint16_t low_level,
+                                       uint16_t high_level,
+                                       int32_t rise_fall_samples)
+    : samples_per_bit_(samples_per_bit),
+      low_level_(low_level),
+      high_level_(high_level),
+      rise_fall_samples_(rise_fall_samples) {
+    // A ramp wider than the cell spills into its neighbours, which only
+    // render_bit() itself can reproduce
+    const int32_t ramp_before = std::max(rise_fall_samples_, 0) / 2;
+    const int32_t ramp_after = std::max(rise_fall_samples_, 0) - ramp_before;
+    self_contained_ = samples_per_bit_ > 0 &&
+                      ramp_before <= samples_per_bit_ / 2 &&
+                      ramp_after <= samples_per_bit_ - samples_per_bit_ / 2;
+    if (!self_contained_) {
+        return;
+    }
+
+    cells_.resize(static_cast<size_t>(samples_per_bit_) * 2);
+    for (int32_t bit = 0; bit < 2; ++bit) {
+        ManchesterEncoder::render_bit(bit != 0, 0, samples_per_bit_, low_level_, high_level_,
+                                      rise_fall_samples_, cells_.data() + bit * samples_per_bit_,
+                                      samples_per_bit_);
+    }
+}
+
+void ManchesterBitCells::render(uint32_t value,
+                                int32_t num_bits,
+                                int32_t bit_start_pos,
+                                uint16_t* line_buffer,
+                                int32_t buffer_size) const {
+    for (int32_t i = 0; i < num_bits; ++i) {
+        int32_t bit_pos = bit_start_pos + i * samples_per_bit_;
+        if (bit_pos >= buffer_size) break;
+
+        bool bit_value = ((value >> (num_bits - 1 - i)) & 1) != 0;
+        if (!self_contained_) {
+            ManchesterEncoder::render_bit(bit_value, bit_pos, samples_per_bit_, low_level_, high_level_,
+                                          rise_fall_samples_, line_buffer, buffer_size);
+            continue;
+        }
+
+        int32_t count = std::min(samples_per_bit_, buffer_size - bit_pos);
+        std::memcpy(line_buffer + bit_pos, cells_.data() + (bit_value ? samples_per_bit_ : 0),
+                    static_cast<size_t>(count) * sizeof(uint16_t));
+    }
+}
+
 } // namespace encode_orc
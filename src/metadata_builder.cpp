@@ -0,0 +1,86 @@
+/*
+ * File:        metadata_builder.cpp
+ * Module:      encode-orc
+ * Purpose:     Project metadata with support for CAV, CLV chapter, and CLV timecode modes
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "metadata_builder.h"
+#include "metadata_writer.h"
+#include <cstdio>
+
+namespace encode_orc {
+
+bool MetadataBuilder::build(const YAMLProjectConfig& config,
+                            VideoSystem system,
+                            const OutputPlan& plan,
+                            std::string& error_message) {
+    try {
+        const int32_t total_fields = static_cast<int32_t>(plan.total_fields());
+        
+        VideoParameters params = (system == VideoSystem::PAL)
+            ? VideoParameters::create_pal_composite()
+            : VideoParameters::create_ntsc_composite();
+        
+        // Apply video level overrides if specified in config
+        if (config.output.video_levels.has_value()) {
+            const auto& vl = config.output.video_levels.value();
+            VideoParameters::apply_video_level_overrides(params,
+                                                        vl.blanking_16b_ire,
+                                                        vl.black_16b_ire,
+                                                        vl.white_16b_ire);
+        }
+        
+        // Set decoder string from config
+        params.decoder = config.output.metadata_decoder;
+        
+        metadata_ = CaptureMetadata();
+        metadata_.capture_id = 1;
+        metadata_.git_branch = "main";
+        metadata_.git_commit = "v0.1.0-dev";
+        metadata_.capture_notes = config.description;
+        metadata_.initialize(system, total_fields);
+        metadata_.video_params = params;
+        metadata_.video_params.number_of_sequential_fields = total_fields;
+        
+        // VBI is not stored per field: the schedule works it out on demand,
+        // for the encoders while rendering and for write()
+        vbi_schedule_ = VBISchedule(config, system, plan);
+        
+        return true;
+
+    } catch (const std::exception& e) {
+        error_message = std::string("Exception generating metadata: ") + e.what();
+        return false;
+    }
+}
+
+bool MetadataBuilder::write(const std::string& output_db, std::string& error_message) const {
+    try {
+        MetadataWriter writer;
+        std::remove(output_db.c_str());
+        
+        // Synced on commit: once this returns the encode's checkpoint is removed
+        MetadataWriter::Options options;
+        options.synchronous = true;
+        if (!writer.open(output_db, options)) {
+            error_message = "Failed to create metadata database: " + writer.get_error();
+            return false;
+        }
+        if (!writer.write_metadata(metadata_, vbi_schedule_)) {
+            error_message = "Failed to write metadata: " + writer.get_error();
+            return false;
+        }
+        writer.close();
+        
+        return true;
+
+    } catch (const std::exception& e) {
+        error_message = std::string("Exception writing metadata: ") + e.what();
+        return false;
+    }
+}
+
+} // namespace encode_orc
@@ -8,13 +8,16 @@
  */
 
 #include "metadata_writer.h"
-#include <sstream>
 #include <cstring>
-#include <iostream>
+#include <string>
 
 namespace encode_orc {
 
 bool MetadataWriter::open(const std::string& filename) {
+    return open(filename, Options());
+}
+
+bool MetadataWriter::open(const std::string& filename, const Options& options) {
     close();
     
     int rc = sqlite3_open(filename.c_str(), &db_);
@@ -24,6 +27,20 @@ bool MetadataWriter::open(const std::string& filename) {
         return false;
     }
     
+    // Connection settings (before any table is touched)
+    const char* journal_mode = "OFF";
+    if (options.journal_mode == JournalMode::WAL) {
+        journal_mode = "WAL";
+    } else if (options.journal_mode == JournalMode::DELETE) {
+        journal_mode = "DELETE";
+    }
+    const std::string pragmas = std::string("PRAGMA journal_mode = ") + journal_mode + ";" +
+                                "PRAGMA synchronous = " + (options.synchronous ? "FULL" : "OFF") + ";" +
+                                "PRAGMA cache_size = -" + std::to_string(options.cache_size_kib) + ";";
+    if (!execute_sql(pragmas.c_str())) {
+        return false;
+    }
+    
     // Create the schema
     if (!create_schema()) {
         return false;
@@ -54,6 +71,26 @@ bool MetadataWriter::execute_sql(const char* sql) {
     return true;
 }
 
+MetadataWriter::Statement MetadataWriter::prepare(const char* sql) {
+    sqlite3_stmt* statement = nullptr;
+    if (sqlite3_prepare_v2(db_, sql, -1, &statement, nullptr) != SQLITE_OK) {
+        error_message_ = std::string("SQL error: ") + sqlite3_errmsg(db_);
+        sqlite3_finalize(statement);
+        return Statement();
+    }
+    return Statement(statement);
+}
+
+bool MetadataWriter::step(sqlite3_stmt* statement) {
+    const int rc = sqlite3_step(statement);
+    sqlite3_reset(statement);
+    if (rc != SQLITE_DONE) {
+        error_message_ = std::string("SQL error: ") + sqlite3_errmsg(db_);
+        return false;
+    }
+    return true;
+}
+
 bool MetadataWriter::create_schema() {
     // Drop existing tables to ensure a clean start
     // This prevents UNIQUE constraint errors when overwriting existing metadata
@@ -129,158 +166,162 @@ bool MetadataWriter::create_schema() {
 }
 
 bool MetadataWriter::write_capture(const CaptureMetadata& metadata) {
-    std::ostringstream sql;
-    sql.precision(17);  // Use full double precision for sample rate
-    sql << "INSERT INTO capture ("
-        << "capture_id, system, decoder, git_branch, git_commit, "
-        << "video_sample_rate, active_video_start, active_video_end, "
-        << "field_width, field_height, number_of_sequential_fields, "
-        << "colour_burst_start, colour_burst_end, "
-        << "is_mapped, is_subcarrier_locked, is_widescreen, "
-        << "white_16b_ire, black_16b_ire, blanking_16b_ire, capture_notes"
-        << ") VALUES ("
-        << metadata.capture_id << ", "
-        << "'" << video_system_to_string(metadata.video_params.system) << "', "
-        << "'" << metadata.video_params.decoder << "', "
-        << "'" << metadata.git_branch << "', "
-        << "'" << metadata.git_commit << "', "
-        << metadata.video_params.sample_rate << ", "
-        << metadata.video_params.active_video_start << ", "
-        << metadata.video_params.active_video_end << ", "
-        << metadata.video_params.field_width << ", "
-        << metadata.video_params.field_height << ", "
-        << metadata.video_params.number_of_sequential_fields << ", "
-        << metadata.video_params.colour_burst_start << ", "
-        << metadata.video_params.colour_burst_end << ", "
-        << (metadata.video_params.is_mapped ? 1 : 0) << ", "
-        << (metadata.video_params.is_subcarrier_locked ? 1 : 0) << ", "
-        << (metadata.video_params.is_widescreen ? 1 : 0) << ", "
-        << metadata.video_params.white_16b_ire << ", "
-        << metadata.video_params.black_16b_ire << ", "
-        << metadata.video_params.blanking_16b_ire << ", "
-        << "'" << metadata.capture_notes << "'"
-        << ");";
+    Statement insert = prepare(
+        "INSERT INTO capture ("
+        "capture_id, system, decoder, git_branch, git_commit, "
+        "video_sample_rate, active_video_start, active_video_end, "
+        "field_width, field_height, number_of_sequential_fields, "
+        "colour_burst_start, colour_burst_end, "
+        "is_mapped, is_subcarrier_locked, is_widescreen, "
+        "white_16b_ire, black_16b_ire, blanking_16b_ire, capture_notes"
+        ") VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18, ?19, ?20);");
+    if (!insert) {
+        return false;
+    }
     
-    return execute_sql(sql.str().c_str());
+    const VideoParameters& params = metadata.video_params;
+    sqlite3_stmt* statement = insert.get();
+    sqlite3_bind_int(statement, 1, metadata.capture_id);
+    sqlite3_bind_text(statement, 2, video_system_to_string(params.system).c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(statement, 3, params.decoder.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(statement, 4, metadata.git_branch.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(statement, 5, metadata.git_commit.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(statement, 6, params.sample_rate);
+    sqlite3_bind_int(statement, 7, params.active_video_start);
+    sqlite3_bind_int(statement, 8, params.active_video_end);
+    sqlite3_bind_int(statement, 9, params.field_width);
+    sqlite3_bind_int(statement, 10, params.field_height);
+    sqlite3_bind_int(statement, 11, params.number_of_sequential_fields);
+    sqlite3_bind_int(statement, 12, params.colour_burst_start);
+    sqlite3_bind_int(statement, 13, params.colour_burst_end);
+    sqlite3_bind_int(statement, 14, params.is_mapped ? 1 : 0);
+    sqlite3_bind_int(statement, 15, params.is_subcarrier_locked ? 1 : 0);
+    sqlite3_bind_int(statement, 16, params.is_widescreen ? 1 : 0);
+    sqlite3_bind_int(statement, 17, params.white_16b_ire);
+    sqlite3_bind_int(statement, 18, params.black_16b_ire);
+    sqlite3_bind_int(statement, 19, params.blanking_16b_ire);
+    sqlite3_bind_text(statement, 20, metadata.capture_notes.c_str(), -1, SQLITE_TRANSIENT);
+    
+    return step(statement);
 }
 
 bool MetadataWriter::write_fields(const CaptureMetadata& metadata) {
-    // Use a transaction for better performance
-    if (!execute_sql("BEGIN TRANSACTION;")) {
+    // NTSC-only columns are bound as NULL for PAL fields
+    Statement insert = prepare(
+        "INSERT INTO field_record ("
+        "capture_id, field_id, audio_samples, decode_faults, disk_loc, "
+        "efm_t_values, field_phase_id, file_loc, is_first_field, "
+        "median_burst_ire, pad, sync_conf, "
+        "ntsc_is_fm_code_data_valid, ntsc_fm_code_data, "
+        "ntsc_field_flag, ntsc_is_video_id_data_valid, "
+        "ntsc_video_id_data, ntsc_white_flag"
+        ") VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18);");
+    if (!insert) {
         return false;
     }
     
+    sqlite3_stmt* statement = insert.get();
+    sqlite3_bind_int(statement, 1, metadata.capture_id);
     for (const auto& field : metadata.fields) {
-        std::ostringstream sql;
-        sql << "INSERT INTO field_record ("
-            << "capture_id, field_id, audio_samples, decode_faults, disk_loc, "
-            << "efm_t_values, field_phase_id, file_loc, is_first_field, "
-            << "median_burst_ire, pad, sync_conf";
-        
-        // Add NTSC-specific fields if present
-        bool has_ntsc = field.ntsc_field_flag.has_value();
-        if (has_ntsc) {
-            sql << ", ntsc_is_fm_code_data_valid, ntsc_fm_code_data, "
-                << "ntsc_field_flag, ntsc_is_video_id_data_valid, "
-                << "ntsc_video_id_data, ntsc_white_flag";
-        }
-        
-        sql << ") VALUES ("
-            << metadata.capture_id << ", "
-            << field.field_id << ", "
-            << field.audio_samples << ", "
-            << field.decode_faults << ", "
-            << field.disk_loc << ", "
-            << field.efm_t_values << ", "
-            << field.field_phase_id << ", "
-            << field.file_loc << ", "
-            << (field.is_first_field ? 1 : 0) << ", "
-            << field.median_burst_ire << ", "
-            << (field.pad ? 1 : 0) << ", "
-            << field.sync_conf;
+        sqlite3_bind_int(statement, 2, field.field_id);
+        sqlite3_bind_int(statement, 3, field.audio_samples);
+        sqlite3_bind_int(statement, 4, field.decode_faults);
+        sqlite3_bind_double(statement, 5, field.disk_loc);
+        sqlite3_bind_int(statement, 6, field.efm_t_values);
+        sqlite3_bind_int(statement, 7, field.field_phase_id);
+        sqlite3_bind_int64(statement, 8, field.file_loc);
+        sqlite3_bind_int(statement, 9, field.is_first_field ? 1 : 0);
+        sqlite3_bind_double(statement, 10, field.median_burst_ire);
+        sqlite3_bind_int(statement, 11, field.pad ? 1 : 0);
+        sqlite3_bind_int(statement, 12, field.sync_conf);
         
-        if (has_ntsc) {
-            sql << ", "
-                << (field.ntsc_is_fm_code_data_valid.value() ? 1 : 0) << ", "
-                << field.ntsc_fm_code_data.value_or(0) << ", "
-                << (field.ntsc_field_flag.value() ? 1 : 0) << ", "
-                << (field.ntsc_is_video_id_data_valid.value() ? 1 : 0) << ", "
-                << field.ntsc_video_id_data.value_or(0) << ", "
-                << (field.ntsc_white_flag.value() ? 1 : 0);
+        if (field.ntsc_field_flag.has_value()) {
+            sqlite3_bind_int(statement, 13, field.ntsc_is_fm_code_data_valid.value() ? 1 : 0);
+            sqlite3_bind_int(statement, 14, field.ntsc_fm_code_data.value_or(0));
+            sqlite3_bind_int(statement, 15, field.ntsc_field_flag.value() ? 1 : 0);
+            sqlite3_bind_int(statement, 16, field.ntsc_is_video_id_data_valid.value() ? 1 : 0);
+            sqlite3_bind_int(statement, 17, field.ntsc_video_id_data.value_or(0));
+            sqlite3_bind_int(statement, 18, field.ntsc_white_flag.value() ? 1 : 0);
+        } else {
+            for (int column = 13; column <= 18; ++column) {
+                sqlite3_bind_null(statement, column);
+            }
         }
         
-        sql << ");";
-        
-        if (!execute_sql(sql.str().c_str())) {
-            execute_sql("ROLLBACK;");
+        if (!step(statement)) {
             return false;
         }
     }
     
-    return execute_sql("COMMIT;");
+    return true;
 }
 
-bool MetadataWriter::write_vbi(const CaptureMetadata& metadata) {
-    // Only write VBI data if it exists
-    if (metadata.vbi_data.empty()) {
-        return true;  // No VBI data, but not an error
-    }
-    
-    // Use a transaction for better performance
-    if (!execute_sql("BEGIN TRANSACTION;")) {
+bool MetadataWriter::write_vbi(const CaptureMetadata& metadata, const FieldVBISource& field_vbi) {
+    Statement insert = prepare(
+        "INSERT INTO vbi (capture_id, field_id, vbi0, vbi1, vbi2) VALUES (?1, ?2, ?3, ?4, ?5);");
+    if (!insert) {
         return false;
     }
     
-    for (size_t field_id = 0; field_id < metadata.vbi_data.size(); ++field_id) {
-        const auto& vbi = metadata.vbi_data[field_id];
-        
+    sqlite3_stmt* statement = insert.get();
+    sqlite3_bind_int(statement, 1, metadata.capture_id);
+    const int64_t num_fields = static_cast<int64_t>(metadata.fields.size());
+    for (int64_t field_id = 0; field_id < num_fields; ++field_id) {
         // Skip fields without VBI data
-        if (!vbi.has_value()) {
+        VBIData vbi;
+        if (!field_vbi(field_id, vbi)) {
             continue;
         }
         
-        std::ostringstream sql;
-        sql << "INSERT INTO vbi ("
-            << "capture_id, field_id, vbi0, vbi1, vbi2"
-            << ") VALUES ("
-            << metadata.capture_id << ", "
-            << field_id << ", "
-            << vbi->vbi0 << ", "
-            << vbi->vbi1 << ", "
-            << vbi->vbi2
-            << ");";
+        sqlite3_bind_int64(statement, 2, static_cast<sqlite3_int64>(field_id));
+        sqlite3_bind_int(statement, 3, vbi.vbi0);
+        sqlite3_bind_int(statement, 4, vbi.vbi1);
+        sqlite3_bind_int(statement, 5, vbi.vbi2);
         
-        if (!execute_sql(sql.str().c_str())) {
-            execute_sql("ROLLBACK;");
+        if (!step(statement)) {
             return false;
         }
     }
     
-    return execute_sql("COMMIT;");
+    return true;
 }
 
 bool MetadataWriter::write_metadata(const CaptureMetadata& metadata) {
+    return write_all(metadata, [&metadata](int64_t field_id, VBIData& vbi) {
+        if (field_id >= static_cast<int64_t>(metadata.vbi_data.size()) ||
+            !metadata.vbi_data[static_cast<size_t>(field_id)]) {
+            return false;
+        }
+        vbi = *metadata.vbi_data[static_cast<size_t>(field_id)];
+        return true;
+    });
+}
+
+bool MetadataWriter::write_metadata(const CaptureMetadata& metadata, const VBISchedule& vbi_schedule) {
+    return write_all(metadata, [&vbi_schedule](int64_t field_id, VBIData& vbi) {
+        return vbi_schedule.field_vbi(field_id, vbi);
+    });
+}
+
+bool MetadataWriter::write_all(const CaptureMetadata& metadata, const FieldVBISource& field_vbi) {
     if (!db_) {
         error_message_ = "Database not open";
         return false;
     }
     
-    // Write capture record
-    if (!write_capture(metadata)) {
-        return false;
-    }
-    
-    // Write field records
-    if (!write_fields(metadata)) {
+    // Every table in one transaction
+    if (!execute_sql("BEGIN TRANSACTION;")) {
         return false;
     }
     
-    // Write VBI records if present
-    if (!write_vbi(metadata)) {
+    if (!write_capture(metadata) || !write_fields(metadata) || !write_vbi(metadata, field_vbi)) {
+        const std::string error = error_message_;
+        execute_sql("ROLLBACK;");
+        error_message_ = error;
         return false;
     }
     
-    return true;
+    return execute_sql("COMMIT;");
 }
 
 } // namespace encode_orc
@@ -10,7 +10,6 @@
 #include "mov_loader.h"
 #include "video_loader_base.h"
 #include "logging.h"
-#include <fstream>
 #include <sstream>
 #include <iostream>
 #include <cstring>
@@ -19,7 +18,6 @@
 #include <array>
 #include <memory>
 #include <filesystem>
-#include <unistd.h>
 
 namespace encode_orc {
 
@@ -138,16 +136,13 @@ bool MOVLoader::probe_video_info(std::string& error_message) {
     return true;
 }
 
-bool MOVLoader::extract_frames_to_yuv(int32_t start_frame,
-                                      int32_t num_frames,
-                                      const std::string& temp_yuv_file,
-                                      std::string& error_message) {
+std::string MOVLoader::build_ffmpeg_command(int32_t start_frame, int32_t num_frames) const {
     // Build ffmpeg command to extract frames at native resolution
     // We will pad to target width later to preserve original video quality
     // Strategy: extract starting frame with proper frame counting
     
     std::ostringstream cmd;
-    cmd << "ffmpeg -v error ";
+    cmd << "ffmpeg -v error -nostdin ";
     
     // Input file
     cmd << "-i \"" << filename_ << "\" ";
@@ -162,15 +157,20 @@ bool MOVLoader::extract_frames_to_yuv(int32_t start_frame,
     cmd << "-pix_fmt yuv422p10le ";
     cmd << "-f rawvideo ";
     cmd << "-an ";
-    cmd << "-y ";  // Overwrite output file
-    cmd << "\"" << temp_yuv_file << "\" 2>&1";
+    cmd << "pipe:1";  // Frames are read straight from stdout
     
-    std::string cmd_str = cmd.str();
-    ENCODE_ORC_LOG_DEBUG("FFmpeg command: {}", cmd_str);
-    
-    // Execute ffmpeg command
-    std::array<char, 256> buffer;
-    std::string ffmpeg_output;
+    return cmd.str();
+}
+
+size_t MOVLoader::yuv_frame_size(int32_t width) const {
+    // Y plane plus two half-width chroma planes, 16-bit words
+    return static_cast<size_t>(width) * height_ * 2 +
+           static_cast<size_t>(width / 2) * height_ * 2 * 2;
+}
+
+bool MOVLoader::probe_output_width(std::string& error_message) {
+    std::string cmd_str = build_ffmpeg_command(0, 1);
+    ENCODE_ORC_LOG_DEBUG("FFmpeg width probe: {}", cmd_str);
     
     FILE* pipe = popen(cmd_str.c_str(), "r");
     if (!pipe) {
@@ -178,27 +178,82 @@ bool MOVLoader::extract_frames_to_yuv(int32_t start_frame,
         return false;
     }
     
-    // Capture any error output
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-        ffmpeg_output += buffer.data();
+    std::array<char, 65536> buffer;
+    size_t total_bytes = 0;
+    size_t bytes_read;
+    while ((bytes_read = fread(buffer.data(), 1, buffer.size(), pipe)) > 0) {
+        total_bytes += bytes_read;
     }
     
     int return_code = pclose(pipe);
-    
     if (return_code != 0) {
         error_message = "ffmpeg extraction failed with code " + std::to_string(return_code);
-        if (!ffmpeg_output.empty()) {
-            error_message += ": " + ffmpeg_output;
-        }
         return false;
     }
     
-    // Verify output file exists
-    if (!std::filesystem::exists(temp_yuv_file)) {
-        error_message = "ffmpeg did not create output file: " + temp_yuv_file;
+    // One YUV422P10LE frame is width * height * 4 bytes
+    int32_t actual_width = (height_ > 0) ? static_cast<int32_t>(total_bytes / (static_cast<size_t>(height_) * 4)) : 0;
+    if (actual_width <= 0 || actual_width > 2000) {
+        error_message = "Calculated invalid actual width: " + std::to_string(actual_width);
+        return false;
+    }
+    
+    if (actual_width != width_) {
+        ENCODE_ORC_LOG_DEBUG("ffmpeg outputs {} pixels per line (ffprobe reported {})", actual_width, width_);
+    }
+    output_width_ = actual_width;
+    return true;
+}
+
+bool MOVLoader::open_frame_stream(int32_t start_frame, int32_t num_frames,
+                                  std::string& error_message) {
+    if (output_width_ == 0 && !probe_output_width(error_message)) {
+        return false;
+    }
+    
+    std::string cmd_str = build_ffmpeg_command(start_frame, num_frames);
+    ENCODE_ORC_LOG_DEBUG("FFmpeg command: {}", cmd_str);
+    
+    stream_pipe_ = popen(cmd_str.c_str(), "r");
+    if (!stream_pipe_) {
+        error_message = "Failed to run ffmpeg command";
         return false;
     }
     
+    stream_data_.resize(yuv_frame_size(output_width_));
+    return true;
+}
+
+bool MOVLoader::read_stream_frame(FrameBuffer& frame, bool& end_of_stream,
+                                  std::string& error_message) {
+    size_t bytes_read = fread(stream_data_.data(), 1, stream_data_.size(), stream_pipe_);
+    if (bytes_read < stream_data_.size()) {
+        if (ferror(stream_pipe_)) {
+            error_message = "Failed to read frame data from ffmpeg";
+            return false;
+        }
+        // ffmpeg may deliver fewer frames than requested; a partial frame is dropped
+        end_of_stream = true;
+        return true;
+    }
+    
+    convert_yuv422p10le_to_frame(stream_data_, output_width_, height_, frame);
+    return true;
+}
+
+bool MOVLoader::close_frame_stream(bool complete, std::string& error_message) {
+    if (!stream_pipe_) {
+        return true;
+    }
+    
+    // Closing early makes ffmpeg exit on a broken pipe, so its status only
+    // matters when the whole range was read
+    int return_code = pclose(stream_pipe_);
+    stream_pipe_ = nullptr;
+    if (complete && return_code != 0) {
+        error_message = "ffmpeg extraction failed with code " + std::to_string(return_code);
+        return false;
+    }
     return true;
 }
 
@@ -290,128 +345,44 @@ bool MOVLoader::load_frames(int32_t start_frame,
         return false;
     }
     
-    // Validate dimensions
-    std::string dim_error;
-    if (!validate_dimensions(expected_width, expected_height, dim_error)) {
-        error_message = dim_error;
-        return false;
-    }
-    
-    // Validate frame rate matches video system
-    std::string format_error;
-    if (!validate_format(params.system, format_error)) {
-        error_message = format_error;
-        return false;
-    }
-    
-    // Validate frame range
-    std::string range_error;
-    if (!validate_frame_range(start_frame, num_frames, range_error)) {
-        error_message = range_error;
+    // Same ffmpeg pipe as streaming, just collected into memory
+    if (!start_stream(start_frame, num_frames, expected_width, expected_height,
+                      params, error_message)) {
         return false;
     }
     
-    // Create temporary file for YUV data
-    std::string temp_yuv_file = "/tmp/encode_orc_mov_" + std::to_string(getpid()) + ".yuv";
-    
-    // Extract frames to temporary YUV file
-    if (!extract_frames_to_yuv(start_frame, num_frames, temp_yuv_file, error_message)) {
-        // Clean up temp file if it exists
-        std::filesystem::remove(temp_yuv_file);
-        return false;
-    }
+    frames.clear();
+    frames.reserve(num_frames);
     
-    // Read YUV data
-    std::ifstream file(temp_yuv_file, std::ios::binary);
-    if (!file) {
-        error_message = "Cannot open temporary YUV file: " + temp_yuv_file;
-        std::filesystem::remove(temp_yuv_file);
-        return false;
+    FrameBuffer frame;
+    std::string stream_error;
+    while (next_frame(frame, stream_error)) {
+        frames.push_back(std::move(frame));
     }
+    stop_stream();
     
-    // Get file size
-    file.seekg(0, std::ios::end);
-    size_t file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    // ffmpeg may apply crop metadata and extract at a different width than reported by ffprobe
-    // Calculate actual width from file size
-    // For YUV422P10LE per frame:
-    //   Y plane: width * height * 2 bytes (10-bit in 16-bit words)
-    //   U plane: (width/2) * height * 2 bytes
-    //   V plane: (width/2) * height * 2 bytes
-    // Total = width*height*2 + width*height*2 = width*height*4
-    // file_size = num_frames * width * height * 4
-    // So: width = file_size / (num_frames * height * 4)
-    int32_t actual_width = static_cast<int32_t>(file_size / (num_frames * height_ * 4));
-    
-    if (actual_width <= 0 || actual_width > 2000) {
-        error_message = "Calculated invalid actual width: " + std::to_string(actual_width);
-        file.close();
-        std::filesystem::remove(temp_yuv_file);
+    if (!stream_error.empty()) {
+        error_message = stream_error;
         return false;
     }
     
-    // Recalculate frame size with actual extracted width
-    size_t frame_size = actual_width * height_ * 2 +  // Y plane
-                        (actual_width / 2) * height_ * 2 +  // U plane
-                        (actual_width / 2) * height_ * 2;    // V plane
-    
-    // Check if we have at least one complete frame
-    if (file_size < frame_size) {
-        error_message = "YUV file too small: expected at least " + 
-                       std::to_string(frame_size) + " bytes (one frame), got " + 
-                       std::to_string(file_size) + " bytes";
-        file.close();
-        std::filesystem::remove(temp_yuv_file);
+    // ffmpeg may extract fewer frames than requested; use what we got
+    if (frames.empty()) {
+        error_message = "No complete frames extracted from MOV file";
         return false;
     }
     
-    // Calculate actual number of frames available
-    int32_t actual_num_frames = static_cast<int32_t>(file_size / frame_size);
-    if (actual_num_frames < num_frames) {
-        // ffmpeg may extract fewer frames than requested - adjust
-        int32_t adjusted_num_frames = actual_num_frames;
-        if (adjusted_num_frames <= 0) {
-            error_message = "No complete frames extracted from MOV file";
-            file.close();
-            std::filesystem::remove(temp_yuv_file);
-            return false;
-        }
-        // Silently use what we got (common with frame extraction)
-        num_frames = adjusted_num_frames;
-    }
-    
-    // Read all frames
-    frames.clear();
-    frames.reserve(num_frames);
-    
-    std::vector<uint8_t> frame_data(frame_size);
-    
-    for (int32_t i = 0; i < num_frames; ++i) {
-        file.read(reinterpret_cast<char*>(frame_data.data()), frame_size);
-        
-        if (!file) {
-            error_message = "Failed to read frame " + std::to_string(i) + " from YUV file";
-            file.close();
-            std::filesystem::remove(temp_yuv_file);
-            return false;
-        }
-        
-        FrameBuffer frame;
-        convert_yuv422p10le_to_frame(frame_data, actual_width, height_, frame);
-        frames.push_back(std::move(frame));
-    }
-    
-    file.close();
-    
-    // Clean up temporary file
-    std::filesystem::remove(temp_yuv_file);
-    
     return true;
 }
 
+MOVLoader::~MOVLoader() {
+    close();
+}
+
 void MOVLoader::close() {
+    stop_stream();
+    stream_data_.clear();
+    output_width_ = 0;
     is_open_ = false;
     filename_.clear();
     width_ = 0;
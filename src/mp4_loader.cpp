@@ -10,7 +10,6 @@
 #include "mp4_loader.h"
 #include "video_loader_base.h"
 #include "logging.h"
-#include <fstream>
 #include <sstream>
 #include <iostream>
 #include <cstring>
@@ -19,7 +18,6 @@
 #include <array>
 #include <memory>
 #include <filesystem>
-#include <unistd.h>
 
 namespace encode_orc {
 
@@ -145,74 +143,87 @@ bool MP4Loader::probe_video_info(std::string& error_message) {
     return true;
 }
 
-bool MP4Loader::extract_frames_to_yuv(int32_t start_frame,
-                                      int32_t num_frames,
-                                      const std::string& temp_yuv_file,
-                                      std::string& error_message) {
+std::string MP4Loader::build_ffmpeg_command(int32_t start_frame, int32_t num_frames) const {
     // Build ffmpeg command to extract frames at native resolution
     // For MP4 files, we typically don't need to deinterlace as they're usually progressive
     
     std::ostringstream cmd;
-    cmd << "ffmpeg -v error ";
+    cmd << "ffmpeg -v error -nostdin ";
     
     // Input file
     cmd << "-i \"" << filename_ << "\" ";
     
-    // Frame selection - use different approach based on whether we're selecting a range
+    // ffmpeg only honours the last -vf, so range selection and the range
+    // conversion go in a single filter chain
+    cmd << "-vf \"";
     if (start_frame > 0 || num_frames < frame_count_) {
         // Select specific frame range
-        cmd << "-vf \"select='between(n\\," << start_frame << "\\," << (start_frame + num_frames - 1) << ")',setpts=PTS-STARTPTS\" ";
-        cmd << "-vsync 0 ";  // Don't drop or duplicate frames
+        cmd << "select='between(n\\," << start_frame << "\\," << (start_frame + num_frames - 1) << ")',setpts=PTS-STARTPTS,";
     }
     
-    // Limit output frames
-    cmd << "-frames:v " << num_frames << " ";
-    
     // Explicitly convert to full range first, then to TV range to normalize
     // This ensures we get proper studio range output
-    cmd << "-vf \"scale=in_range=auto:out_range=tv\" ";
+    cmd << "scale=in_range=auto:out_range=tv\" ";
+    cmd << "-vsync 0 ";  // Don't drop or duplicate frames
+    
+    // Limit output frames
+    cmd << "-frames:v " << num_frames << " ";
     
     // Output format: YUV420P 8-bit
     cmd << "-pix_fmt yuv420p ";
     cmd << "-f rawvideo ";
     cmd << "-an ";
-    cmd << "-y ";  // Overwrite output file
-    cmd << "\"" << temp_yuv_file << "\" 2>&1";
+    cmd << "pipe:1";  // Frames are read straight from stdout
     
-    std::string cmd_str = cmd.str();
+    return cmd.str();
+}
+
+bool MP4Loader::open_frame_stream(int32_t start_frame, int32_t num_frames,
+                                  std::string& error_message) {
+    std::string cmd_str = build_ffmpeg_command(start_frame, num_frames);
     ENCODE_ORC_LOG_DEBUG("FFmpeg command: {}", cmd_str);
     
-    // Execute ffmpeg command
-    std::array<char, 256> buffer;
-    std::string ffmpeg_output;
-    
-    FILE* pipe = popen(cmd_str.c_str(), "r");
-    if (!pipe) {
+    stream_pipe_ = popen(cmd_str.c_str(), "r");
+    if (!stream_pipe_) {
         error_message = "Failed to run ffmpeg command";
         return false;
     }
     
-    // Capture any error output
-    while (fgets(buffer.data(), buffer.size(), pipe) != nullptr) {
-        ffmpeg_output += buffer.data();
+    // Y plane plus two quarter-size chroma planes
+    stream_data_.resize(static_cast<size_t>(width_) * height_ * 3 / 2);
+    return true;
+}
+
+bool MP4Loader::read_stream_frame(FrameBuffer& frame, bool& end_of_stream,
+                                  std::string& error_message) {
+    size_t bytes_read = fread(stream_data_.data(), 1, stream_data_.size(), stream_pipe_);
+    if (bytes_read < stream_data_.size()) {
+        if (ferror(stream_pipe_)) {
+            error_message = "Failed to read frame data from ffmpeg";
+            return false;
+        }
+        // ffmpeg may deliver fewer frames than requested; a partial frame is dropped
+        end_of_stream = true;
+        return true;
     }
     
-    int return_code = pclose(pipe);
-    
-    if (return_code != 0) {
-        error_message = "ffmpeg extraction failed with code " + std::to_string(return_code);
-        if (!ffmpeg_output.empty()) {
-            error_message += ": " + ffmpeg_output;
-        }
-        return false;
+    convert_yuv420p_to_frame(stream_data_, width_, height_, frame);
+    return true;
+}
+
+bool MP4Loader::close_frame_stream(bool complete, std::string& error_message) {
+    if (!stream_pipe_) {
+        return true;
     }
     
-    // Verify output file exists
-    if (!std::filesystem::exists(temp_yuv_file)) {
-        error_message = "ffmpeg did not create output file: " + temp_yuv_file;
+    // Closing early makes ffmpeg exit on a broken pipe, so its status only
+    // matters when the whole range was read
+    int return_code = pclose(stream_pipe_);
+    stream_pipe_ = nullptr;
+    if (complete && return_code != 0) {
+        error_message = "ffmpeg extraction failed with code " + std::to_string(return_code);
         return false;
     }
-    
     return true;
 }
 
@@ -285,112 +296,43 @@ bool MP4Loader::load_frames(int32_t start_frame,
         return false;
     }
     
-    // Validate dimensions
-    std::string dim_error;
-    if (!validate_dimensions(expected_width, expected_height, dim_error)) {
-        error_message = dim_error;
-        return false;
-    }
-    
-    // Validate frame rate matches video system
-    std::string format_error;
-    if (!validate_format(params.system, format_error)) {
-        error_message = format_error;
-        return false;
-    }
-    
-    // Validate frame range
-    std::string range_error;
-    if (!validate_frame_range(start_frame, num_frames, range_error)) {
-        error_message = range_error;
+    // Same ffmpeg pipe as streaming, just collected into memory
+    if (!start_stream(start_frame, num_frames, expected_width, expected_height,
+                      params, error_message)) {
         return false;
     }
     
-    // Create temporary file for YUV data
-    std::string temp_yuv_file = "/tmp/encode_orc_mp4_" + std::to_string(getpid()) + ".yuv";
+    frames.clear();
+    frames.reserve(num_frames);
     
-    // Extract frames to temporary YUV file
-    if (!extract_frames_to_yuv(start_frame, num_frames, temp_yuv_file, error_message)) {
-        // Clean up temp file if it exists
-        std::filesystem::remove(temp_yuv_file);
-        return false;
+    FrameBuffer frame;
+    std::string stream_error;
+    while (next_frame(frame, stream_error)) {
+        frames.push_back(std::move(frame));
     }
+    stop_stream();
     
-    // Read YUV data
-    std::ifstream file(temp_yuv_file, std::ios::binary);
-    if (!file) {
-        error_message = "Cannot open temporary YUV file: " + temp_yuv_file;
-        std::filesystem::remove(temp_yuv_file);
+    if (!stream_error.empty()) {
+        error_message = stream_error;
         return false;
     }
     
-    // Get file size
-    file.seekg(0, std::ios::end);
-    size_t file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    // For YUV420P per frame:
-    //   Y plane: width * height bytes
-    //   U plane: (width/2) * (height/2) bytes
-    //   V plane: (width/2) * (height/2) bytes
-    // Total = width*height + width*height/4 + width*height/4 = width*height*1.5
-    size_t frame_size = width_ * height_ * 3 / 2;
-    
-    // Check if we have at least one complete frame
-    if (file_size < frame_size) {
-        error_message = "YUV file too small: expected at least " + 
-                       std::to_string(frame_size) + " bytes (one frame), got " + 
-                       std::to_string(file_size) + " bytes";
-        file.close();
-        std::filesystem::remove(temp_yuv_file);
+    // ffmpeg may extract fewer frames than requested; use what we got
+    if (frames.empty()) {
+        error_message = "No complete frames extracted from MP4 file";
         return false;
     }
     
-    // Calculate actual number of frames available
-    int32_t actual_num_frames = static_cast<int32_t>(file_size / frame_size);
-    if (actual_num_frames < num_frames) {
-        // ffmpeg may extract fewer frames than requested - adjust
-        int32_t adjusted_num_frames = actual_num_frames;
-        if (adjusted_num_frames <= 0) {
-            error_message = "No complete frames extracted from MP4 file";
-            file.close();
-            std::filesystem::remove(temp_yuv_file);
-            return false;
-        }
-        // Silently use what we got (common with frame extraction)
-        num_frames = adjusted_num_frames;
-    }
-    
-    // Read all frames
-    frames.clear();
-    frames.reserve(num_frames);
-    
-    std::vector<uint8_t> frame_data(frame_size);
-    
-    for (int32_t i = 0; i < num_frames; ++i) {
-        file.read(reinterpret_cast<char*>(frame_data.data()), frame_size);
-        
-        if (!file) {
-            error_message = "Failed to read frame " + std::to_string(i) + " from YUV file";
-            file.close();
-            std::filesystem::remove(temp_yuv_file);
-            return false;
-        }
-        
-        FrameBuffer frame;
-        convert_yuv420p_to_frame(frame_data, width_, height_, frame);
-        frames.push_back(std::move(frame));
-    }
-    
-    file.close();
-    
-    // Clean up temporary file
-    std::filesystem::remove(temp_yuv_file);
-    
     return true;
 }
 
+MP4Loader::~MP4Loader() {
+    close();
+}
+
 void MP4Loader::close() {
+    stop_stream();
+    stream_data_.clear();
     is_open_ = false;
     filename_.clear();
     width_ = 0;
@@ -15,10 +15,34 @@
 
 namespace encode_orc {
 
-NTSCEncoder::NTSCEncoder(const VideoParameters& params,
-                        bool enable_chroma_filter,
-                        bool enable_luma_filter) 
+NTSCEncoder::NTSCEncoder(const VideoParameters& params, 
+                         bool enable_chroma_filter,
+                         bool enable_luma_filter) 
     : params_(params), vits_enabled_(false) {
+    reconfigure(params, enable_chroma_filter, enable_luma_filter);
+}
+
+void NTSCEncoder::reconfigure(const VideoParameters& params,
+                              bool enable_chroma_filter,
+                              bool enable_luma_filter) {
+    // Generators cache levels and timing derived from the parameters, so
+    // they are only kept if the signal format is unchanged
+    if (!params_.has_same_signal_format(params)) {
+        vits_generator_.reset();
+        vitc_generator_.reset();
+        subcarrier_.reset();
+        modulator_.reset();
+        line_templates_.reset();
+        chroma_templates_.reset();
+        biphase_.reset();
+    }
+    params_ = params;
+    if (!subcarrier_) {
+        subcarrier_ = SubcarrierTable::for_parameters(params_);
+    }
+    if (!modulator_) {
+        modulator_ = std::make_unique<LineModulator>(params_, subcarrier_, I_MAX, Q_MAX);
+    }
     
     // Set signal levels
     sync_level_ = 0x0000;  // Sync tip at 0 IRE (0V)
@@ -31,165 +55,241 @@ NTSCEncoder::NTSCEncoder(const VideoParameters& params,
     sample_rate_ = params_.sample_rate;
     samples_per_cycle_ = sample_rate_ / subcarrier_freq_;
     
-    // Initialize filters if requested
-    if (enable_chroma_filter) {
-        chroma_filter_ = Filters::create_ntsc_uv_filter();
+    // Template lines are generated on first use, after the levels above are set
+    if (!line_templates_) {
+        line_templates_ = std::make_unique<LineTemplateCache>(
+            params_.field_width, params_.field_height, subcarrier_->sequence_fields(),
+            [this](uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
+                if (line_number < VSYNC_LINES) {
+                    generate_vsync_line(line_buffer, line_number);
+                    return;
+                }
+                generate_blanking_line(line_buffer);
+                generate_sync_pulse(line_buffer, line_number);
+                generate_color_burst(line_buffer, line_number, field_number);
+            });
+    }
+    if (!chroma_templates_) {
+        chroma_templates_ = std::make_unique<LineTemplateCache>(
+            params_.field_width, params_.field_height, subcarrier_->sequence_fields(),
+            [this](uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
+                generate_color_burst_chroma(line_buffer, line_number, field_number);
+            });
+    }
+    if (!biphase_) {
+        // Biphase codes run from white (high) to black (low), ~63.56 µs line period
+        biphase_ = std::make_unique<BiphaseEncoder>(sample_rate_, 63.556e-6,
+                                                    static_cast<uint16_t>(white_level_),
+                                                    static_cast<uint16_t>(black_level_));
+    }
+    
+    // Initialize filters if requested (coefficients are fixed, so an
+    // existing filter is kept as-is)
+    if (!enable_chroma_filter) {
+        chroma_filter_.reset();
+    } else if (!chroma_filter_) {
+        chroma_filter_ = Filters::make_ntsc_uv_filter();
+    }
+    if (!enable_luma_filter) {
+        luma_filter_.reset();
+    } else if (!luma_filter_) {
+        luma_filter_ = Filters::make_ntsc_uv_filter();  // Reuse same filter for luma
+    }
+    
+    reset();
+}
+
+const HorizontalResampler& NTSCEncoder::resampler_for(int32_t source_width) {
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    const HorizontalResampler::Mode mode = HorizontalResampler::default_mode();
+    if (!resampler_ || !resampler_->matches(source_width, active_width, mode)) {
+        resampler_ = std::make_unique<HorizontalResampler>(source_width, active_width, mode);
     }
-    if (enable_luma_filter) {
-        luma_filter_ = Filters::create_ntsc_uv_filter();  // Reuse same filter for luma
+    return *resampler_;
+}
+
+void NTSCEncoder::encode_active_lines(int32_t field_number, int32_t source_width,
+                                     const std::function<void(int32_t line)>& encode_line) {
+    if (!line_pool_) {
+        for (int32_t line = ACTIVE_LINES_START; line < ACTIVE_LINES_END; ++line) {
+            encode_line(line);
+        }
+        return;
     }
+    
+    // Build everything the lines share before the threads read it
+    line_templates_->prepare(field_number);
+    chroma_templates_->prepare(field_number);
+    resampler_for(source_width);
+    line_pool_->run(ACTIVE_LINES_START, ACTIVE_LINES_END, encode_line);
+}
+
+void NTSCEncoder::set_line_threads(int32_t num_threads) {
+    if (num_threads <= 1) {
+        line_pool_.reset();
+    } else if (!line_pool_ || line_pool_->num_threads() != num_threads) {
+        line_pool_ = std::make_unique<LineThreadPool>(num_threads);
+    }
+}
+
+void NTSCEncoder::reset() {
+    vits_enabled_ = false;
+    vitc_enabled_ = false;
+    vitc_start_frame_offset_ = 0;
 }
 
 Frame NTSCEncoder::encode_frame(const FrameBuffer& frame_buffer, int32_t field_number,
-                               const VBIData* vbi_data) {
-    Frame frame(params_.field_width, params_.field_height);
+                                const FrameVBI* frame_vbi) {
+    Frame frame;
+    encode_frame(frame_buffer, field_number, frame, frame_vbi);
+    return frame;
+}
+
+void NTSCEncoder::encode_frame(const FrameBuffer& frame_buffer, int32_t field_number, Frame& frame,
+                               const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
     
     // Encode first field (even lines: 0, 2, 4, ...)
-    frame.field1() = encode_field(frame_buffer, field_number, true, vbi_data);
+    encode_field(frame_buffer, field_number, true, frame.field1(), vbi_field1);
     
     // Encode second field (odd lines: 1, 3, 5, ...)
-    frame.field2() = encode_field(frame_buffer, field_number + 1, false, vbi_data);
-    
-    return frame;
+    encode_field(frame_buffer, field_number + 1, false, frame.field2(), vbi_field2);
 }
 
 Field NTSCEncoder::encode_field(const FrameBuffer& frame_buffer, 
                                 int32_t field_number, 
                                 bool is_first_field,
                                 const VBIData* vbi_data) {
-    Field field(params_.field_width, params_.field_height);
+    Field field;
+    encode_field(frame_buffer, field_number, is_first_field, field, vbi_data);
+    return field;
+}
+
+void NTSCEncoder::encode_field(const FrameBuffer& frame_buffer, 
+                               int32_t field_number, 
+                               bool is_first_field,
+                               Field& field,
+                               const VBIData* vbi_data) {
+    field.resize(params_.field_width, params_.field_height);
     
     // Verify input format
     if (frame_buffer.format() != FrameBuffer::Format::YUV444P16) {
         // For now, just create a blanking field if wrong format
         field.fill(static_cast<uint16_t>(blanking_level_));
-        return field;
+        return;
     }
     
-    // Detect if source is in studio code space (≤1023) to preserve sub-black
-    const uint16_t* y_plane_all = frame_buffer.data().data();
-    const int32_t total_pixels = frame_buffer.width() * frame_buffer.height();
-    uint16_t y_max = 0;
-    for (int32_t i = 0; i < total_pixels; ++i) {
-        if (y_plane_all[i] > y_max) y_max = y_plane_all[i];
-    }
-    const bool studio_range_input = (y_max <= 1023);
+    // Studio code space (≤1023) preserves sub-black; range is classified by the loader
+    const bool studio_range_input = frame_buffer.is_studio_range();
     
     // Get frame dimensions
     int32_t frame_width = frame_buffer.width();
     int32_t frame_height = frame_buffer.height();
     
-    // NTSC has 263 lines per field
+    // NTSC has 263 lines per field; sync, VBI and post-video blanking first
     for (int32_t line = 0; line < LINES_PER_FIELD; ++line) {
         uint16_t* line_buffer = field.line_data(line);
         
         // Lines 1-3: Vertical sync (field sync)
         if (line < VSYNC_LINES) {
-            generate_vsync_line(line_buffer, line);
+            line_templates_->copy(line_buffer, line, field_number);
         }
         // Lines 4-20: VBI (Vertical Blanking Interval)
         else if (line < ACTIVE_LINES_START) {
-            // Lines 15, 16, 17 (0-indexed) = field lines 16, 17, 18 contain biphase data
-            if (vbi_data != nullptr && (line == 15 || line == 16 || line == 17)) {
-                int32_t vbi_value = 0;
-                if (line == 15) vbi_value = vbi_data->vbi0;
-                else if (line == 16) vbi_value = vbi_data->vbi1;
-                else if (line == 17) vbi_value = vbi_data->vbi2;
-                generate_biphase_vbi_line(line_buffer, line, field_number, vbi_value);
-            }
-            // VITS lines (if enabled)
-            else if (is_vits_enabled()) {
-                // First field VITS lines (0-indexed in field)
-                if (is_first_field && line == 18) { // Line 19 - first field
-                    generate_blanking_line(line_buffer);
-                    generate_sync_pulse(line_buffer, line);
-                    generate_color_burst(line_buffer, line, field_number);
-                    vits_generator_->generate_vir(line_buffer, field_number);
-                }
-                else if (is_first_field && line == 12) { // Line 13 - first field
-                    generate_blanking_line(line_buffer);
-                    generate_sync_pulse(line_buffer, line);
-                    generate_color_burst(line_buffer, line, field_number);
-                    vits_generator_->generate_ntc7_composite(line_buffer, field_number);
-                }
-                // Second field VITS lines (0-indexed in field)
-                else if (!is_first_field && line == 18) { // Line 19 - second field
-                    generate_blanking_line(line_buffer);
-                    generate_sync_pulse(line_buffer, line);
-                    generate_color_burst(line_buffer, line, field_number);
-                    vits_generator_->generate_vir(line_buffer, field_number);
-                }
-                else if (!is_first_field && line == 12) { // Line 13 - second field
-                    generate_blanking_line(line_buffer);
-                    generate_sync_pulse(line_buffer, line);
-                    generate_color_burst(line_buffer, line, field_number);
-                    vits_generator_->generate_ntc7_combination(line_buffer, field_number);
-                }
-                else {
-                    generate_blanking_line(line_buffer);
-                    generate_sync_pulse(line_buffer, line);
-                    generate_color_burst(line_buffer, line, field_number);
-                }
-            }
-            else if (is_vitc_enabled()) {
-                // Consumer tape VITC placement: lines 14 and 16 (0-indexed 13,15)
-                generate_blanking_line(line_buffer);
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-                if (line == 13 || line == 15) {
-                    int32_t total_frame = vitc_start_frame_offset_ + (field_number / 2);
-                    vitc_generator_->generate_line(VideoSystem::NTSC, total_frame, line_buffer, line, !is_first_field);
-                }
-            }
-            else {
-                generate_blanking_line(line_buffer);
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-            }
+            encode_vbi_line(line_buffer, line, field_number, is_first_field, vbi_data);
+        }
+        // Lines beyond active video: Post-video blanking
+        else if (line >= ACTIVE_LINES_END) {
+            line_templates_->copy(line_buffer, line, field_number);
         }
-        // Lines 21-263: Active video
-        else if (line < ACTIVE_LINES_END) {
-            // Calculate which line in the source frame to use
-            int32_t line_in_field = line - ACTIVE_LINES_START;
-            int32_t line_in_frame = is_first_field ? (line_in_field * 2) : (line_in_field * 2 + 1);
+    }
+    
+    // Lines 21-260: Active video
+    encode_active_lines(field_number, frame_width, [&](int32_t line) {
+        uint16_t* line_buffer = field.line_data(line);
+        
+        // Calculate which line in the source frame to use
+        int32_t line_in_field = line - ACTIVE_LINES_START;
+        int32_t line_in_frame = is_first_field ? (line_in_field * 2) : (line_in_field * 2 + 1);
+        
+        // Blanking with sync and color burst, from the template cache
+        line_templates_->copy(line_buffer, line, field_number);
+        
+        // Check if line is within source frame (beyond it stays blanking)
+        if (line_in_frame < frame_height) {
+            // Get pointers to YIQ data
+            const uint16_t* frame_data = frame_buffer.data().data();
+            int32_t pixel_count = frame_width * frame_height;
+            const uint16_t* y_plane = frame_data;
+            const uint16_t* i_plane = frame_data + pixel_count;
+            const uint16_t* q_plane = frame_data + pixel_count * 2;
             
-            // Check if line is within source frame
-            if (line_in_frame < frame_height) {
-                // Get pointers to YIQ data
-                const uint16_t* frame_data = frame_buffer.data().data();
-                int32_t pixel_count = frame_width * frame_height;
-                const uint16_t* y_plane = frame_data;
-                const uint16_t* i_plane = frame_data + pixel_count;
-                const uint16_t* q_plane = frame_data + pixel_count * 2;
-                
-                const uint16_t* y_line = y_plane + (line_in_frame * frame_width);
-                const uint16_t* i_line = i_plane + (line_in_frame * frame_width);
-                const uint16_t* q_line = q_plane + (line_in_frame * frame_width);
-                
-                // Initialize line with blanking level, then add sync and color burst
-                generate_blanking_line(line_buffer);
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-                
-                // Encode active video portion
-                encode_active_line(line_buffer, y_line, i_line, q_line, 
-                                 line, field_number, frame_width, studio_range_input);
-            } else {
-                // Beyond source frame - use blanking
-                generate_blanking_line(line_buffer);
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-            }
+            const uint16_t* y_line = y_plane + (line_in_frame * frame_width);
+            const uint16_t* i_line = i_plane + (line_in_frame * frame_width);
+            const uint16_t* q_line = q_plane + (line_in_frame * frame_width);
+            
+            // Encode active video portion
+            encode_active_line(line_buffer, y_line, i_line, q_line, 
+                             line, field_number, frame_width, studio_range_input);
+        }
+    });
+    
+    encode_data_lines(field, field_number, is_first_field, vbi_data, 15);
+}
+
+void NTSCEncoder::encode_vbi_line(uint16_t* line_buffer, int32_t line, int32_t field_number,
+                                  bool is_first_field, const VBIData* vbi_data) {
+    // Lines 15, 16, 17 (0-indexed) = field lines 16, 17, 18 contain biphase data
+    if (vbi_data != nullptr && (line == 15 || line == 16 || line == 17)) {
+        // Codes are drawn by encode_data_lines()
+        line_templates_->copy(line_buffer, line, field_number);
+    }
+    // VITS lines (if enabled)
+    else if (is_vits_enabled()) {
+        // First field VITS lines (0-indexed in field)
+        if (is_first_field && line == 18) { // Line 19 - first field
+            line_templates_->copy(line_buffer, line, field_number);
+            vits_generator_->generate_vir(line_buffer, field_number);
+        }
+        else if (is_first_field && line == 12) { // Line 13 - first field
+            line_templates_->copy(line_buffer, line, field_number);
+            vits_generator_->generate_ntc7_composite(line_buffer, field_number);
+        }
+        // Second field VITS lines (0-indexed in field)
+        else if (!is_first_field && line == 18) { // Line 19 - second field
+            line_templates_->copy(line_buffer, line, field_number);
+            vits_generator_->generate_vir(line_buffer, field_number);
+        }
+        else if (!is_first_field && line == 12) { // Line 13 - second field
+            line_templates_->copy(line_buffer, line, field_number);
+            vits_generator_->generate_ntc7_combination(line_buffer, field_number);
         }
-        // Lines beyond active video: Post-video blanking
         else {
-            generate_blanking_line(line_buffer);
-            generate_sync_pulse(line_buffer, line);
-            generate_color_burst(line_buffer, line, field_number);
+            line_templates_->copy(line_buffer, line, field_number);
         }
     }
+    else if (is_vitc_enabled()) {
+        // Consumer tape VITC placement: lines 14 and 16 (0-indexed 13,15)
+        // Timecode is drawn by encode_data_lines()
+        line_templates_->copy(line_buffer, line, field_number);
+    }
+    else {
+        line_templates_->copy(line_buffer, line, field_number);
+    }
+}
+
+void NTSCEncoder::refresh_data_lines(Frame& frame, int32_t field_number, const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
     
-    return field;
+    // Biphase VBI (15-17) and VITC (13, 15) are the only per-frame lines
+    for (int32_t line : {13, 15, 16, 17}) {
+        encode_vbi_line(frame.field1().line_data(line), line, field_number, true, vbi_field1);
+        encode_vbi_line(frame.field2().line_data(line), line, field_number + 1, false, vbi_field2);
+    }
+    encode_data_lines(frame.field1(), field_number, true, vbi_field1, 15);
+    encode_data_lines(frame.field2(), field_number + 1, false, vbi_field2, 15);
 }
 
 void NTSCEncoder::generate_sync_pulse(uint16_t* line_buffer, int32_t /* line_number */) {
@@ -209,7 +309,7 @@ void NTSCEncoder::generate_sync_pulse(uint16_t* line_buffer, int32_t /* line_num
 
 void NTSCEncoder::generate_color_burst(uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
     // Delegate to shared color burst generator
-    ColorBurstGenerator burst_gen(params_);
+    ColorBurstGenerator burst_gen(params_, *subcarrier_);
     int32_t luma_range = white_level_ - blanking_level_;
     int32_t burst_amplitude = static_cast<int32_t>((20.0 / 100.0) * luma_range);
     burst_gen.generate_ntsc_burst(line_buffer, line_number, field_number, blanking_level_, burst_amplitude);
@@ -217,7 +317,7 @@ void NTSCEncoder::generate_color_burst(uint16_t* line_buffer, int32_t line_numbe
 
 void NTSCEncoder::generate_color_burst_chroma(uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
     // Generate color burst on chroma channel (centered at 32768)
-    ColorBurstGenerator burst_gen(params_);
+    ColorBurstGenerator burst_gen(params_, *subcarrier_);
     
     // Calculate burst amplitude: ±20 IRE (same as composite mode)
     int32_t luma_range = white_level_ - blanking_level_;
@@ -227,19 +327,6 @@ void NTSCEncoder::generate_color_burst_chroma(uint16_t* line_buffer, int32_t lin
     burst_gen.generate_ntsc_burst(line_buffer, line_number, field_number, 32768, burst_amplitude);
 }
 
-void NTSCEncoder::generate_color_burst_chroma_line(uint16_t* line_buffer, int32_t line_number, 
-                                                    int32_t field_number, int32_t /* burst_end */) {
-    // Generate color burst on chroma for the portion before active video
-    ColorBurstGenerator burst_gen(params_);
-    
-    // Calculate burst amplitude: ±20 IRE (same as composite mode)
-    int32_t luma_range = white_level_ - blanking_level_;
-    int32_t burst_amplitude = static_cast<int32_t>((20.0 / 100.0) * luma_range);
-    
-    // Generate burst centered at 32768
-    burst_gen.generate_ntsc_burst(line_buffer, line_number, field_number, 32768, burst_amplitude);
-}
-
 void NTSCEncoder::generate_vsync_line(uint16_t* line_buffer, int32_t line_number) {
     // NTSC vertical sync pattern
     // Lines 1-3: broad pulses followed by narrow pulses
@@ -273,14 +360,15 @@ void NTSCEncoder::generate_blanking_line(uint16_t* line_buffer) {
     std::fill_n(line_buffer, params_.field_width, static_cast<uint16_t>(blanking_level_));
 }
 
-void NTSCEncoder::encode_active_line(uint16_t* line_buffer,
-                                    const uint16_t* y_line,
-                                    const uint16_t* i_line,
-                                    const uint16_t* q_line,
-                                    int32_t line_number,
-                                    int32_t field_number,
-                                    int32_t width,
-                                    bool studio_range_input) {
+void NTSCEncoder::encode_active_levels(const uint16_t* y_line,
+                                      const uint16_t* i_line,
+                                      const uint16_t* q_line,
+                                      int32_t line_number,
+                                      int32_t field_number,
+                                      int32_t width,
+                                      bool studio_range_input,
+                                      int32_t* luma,
+                                      int32_t* chroma) {
     // Resolve source pointers; only allocate filtered buffers when filters are enabled.
     const uint16_t* y_data = y_line;
     const uint16_t* i_data = i_line;
@@ -289,8 +377,7 @@ void NTSCEncoder::encode_active_line(uint16_t* line_buffer,
     if (luma_filter_) {
         thread_local std::vector<uint16_t> y_filtered;
         y_filtered.resize(width);
-        std::copy(y_line, y_line + width, y_filtered.begin());
-        luma_filter_->apply(y_filtered);
+        luma_filter_->apply(y_line, y_filtered.data(), width);
         y_data = y_filtered.data();
     }
 
@@ -299,96 +386,84 @@ void NTSCEncoder::encode_active_line(uint16_t* line_buffer,
         thread_local std::vector<uint16_t> q_filtered;
         i_filtered.resize(width);
         q_filtered.resize(width);
-        std::copy(i_line, i_line + width, i_filtered.begin());
-        std::copy(q_line, q_line + width, q_filtered.begin());
-        chroma_filter_->apply(i_filtered);
-        chroma_filter_->apply(q_filtered);
+        chroma_filter_->apply(i_line, i_filtered.data(), width);
+        chroma_filter_->apply(q_line, q_filtered.data(), width);
         i_data = i_filtered.data();
         q_data = q_filtered.data();
     }
     
-    // Encode the active video portion of the line
-    int32_t active_start = params_.active_video_start;
-    int32_t active_end = params_.active_video_end;
-    int32_t active_width = active_end - active_start;
-    
-    // Calculate absolute line number in NTSC sequence
-    // Keep local variables minimal; phase calculation now uses absolute lines
-    // with half-line offset modeled via 262.5 lines per field.
-    
-    // Note: previous integer-based calculation used 263 and integer division,
-    // which discarded the half-line offset and prevented proper 4-field color framing.
-    
-    // NTSC subcarrier phase calculation
-    // Use 262.5 lines per field to preserve half-line offset between fields,
-    // which yields the correct 4-field color framing sequence.
-    const double lines_per_field = 262.5;
-    const double cycles_per_line = 227.5;
-
-    double absolute_lines = static_cast<double>(field_number) * lines_per_field + static_cast<double>(line_number);
-    double prev_cycles = absolute_lines * cycles_per_line;
-
-    const double phase_step = 2.0 * PI * (subcarrier_freq_ / sample_rate_);
-    double phase = (2.0 * PI * prev_cycles) + static_cast<double>(active_start) * phase_step;
-    double sin_phase = std::sin(phase);
-    double cos_phase = std::cos(phase);
-    const double sin_step = std::sin(phase_step);
-    const double cos_step = std::cos(phase_step);
-
-    const double pixel_step = static_cast<double>(width) / active_width;
-    double pixel_pos = 0.0;
-
-    for (int32_t sample = active_start; sample < active_end; ++sample) {
-        int32_t pixel_x = static_cast<int32_t>(pixel_pos);
-        pixel_pos += pixel_step;
-
-        if (pixel_x >= width) pixel_x = width - 1;
-
-        const uint16_t y = y_data[pixel_x];
-        const uint16_t i = i_data[pixel_x];
-        const uint16_t q = q_data[pixel_x];
-
-        int32_t luma_range = white_level_ - black_level_;
-        int32_t luma_scaled;
-
-        if (studio_range_input) {
-            // Preserve sub-black: don't clamp luma_scaled, allow negative values
-            luma_scaled = black_level_ + ((static_cast<int32_t>(y) - 64) * luma_range) / 876;
-        } else {
-            double y_norm = static_cast<double>(y) / 65535.0;
-            luma_scaled = black_level_ + static_cast<int32_t>(y_norm * luma_range);
-        }
-
-        const double I_MAX = 0.5957;
-        const double Q_MAX = 0.5226;
-        double i_norm;
-        double q_norm;
-        if (studio_range_input) {
-            i_norm = ((static_cast<double>(i) / 896.0) - 0.5) * 2.0 * I_MAX;
-            q_norm = ((static_cast<double>(q) / 896.0) - 0.5) * 2.0 * Q_MAX;
-        } else {
-            i_norm = ((static_cast<double>(i) / 65535.0) - 0.5) * 2.0 * I_MAX;
-            q_norm = ((static_cast<double>(q) / 65535.0) - 0.5) * 2.0 * Q_MAX;
-        }
-
-        double chroma = (i_norm * sin_phase) + (q_norm * cos_phase);
-        int32_t chroma_scaled = static_cast<int32_t>(chroma * luma_range);
-
-        int32_t composite = luma_scaled + chroma_scaled;
-        line_buffer[sample] = clamp_signal(composite);
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    
+    // Subcarrier phase for this line of the 4-field sequence (262.5 lines
+    // per field, so the half-line offset between fields is kept)
+    const SubcarrierTable& subcarrier = *subcarrier_;
+    const SubcarrierTable::LinePhase line_phase = subcarrier.line_phase(field_number, line_number);
+
+    // Map the source pixels onto the active samples
+    const HorizontalResampler& resampler = resampler_for(width);
+    thread_local std::vector<uint16_t> y_active;
+    thread_local std::vector<uint16_t> i_active;
+    thread_local std::vector<uint16_t> q_active;
+    y_active.resize(active_width);
+    i_active.resize(active_width);
+    q_active.resize(active_width);
+    resampler.apply(y_data, y_active.data());
+    resampler.apply(i_data, i_active.data());
+    resampler.apply(q_data, q_active.data());
+    const uint16_t* y = y_active.data();
+    const uint16_t* i = i_active.data();
+    const uint16_t* q = q_active.data();
+
+    // Levels and subcarrier modulation (exact or fixed-point kernel)
+    modulator_->modulate(y, i, q, studio_range_input, line_phase, luma, chroma);
+}
 
-        double next_sin = (sin_phase * cos_step) + (cos_phase * sin_step);
-        double next_cos = (cos_phase * cos_step) - (sin_phase * sin_step);
-        sin_phase = next_sin;
-        cos_phase = next_cos;
+void NTSCEncoder::encode_active_line(uint16_t* line_buffer,
+                                    const uint16_t* y_line,
+                                    const uint16_t* i_line,
+                                    const uint16_t* q_line,
+                                    int32_t line_number,
+                                    int32_t field_number,
+                                    int32_t width,
+                                    bool studio_range_input) {
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    thread_local std::vector<int32_t> luma;
+    thread_local std::vector<int32_t> chroma;
+    luma.resize(active_width);
+    chroma.resize(active_width);
+    encode_active_levels(y_line, i_line, q_line, line_number, field_number, width,
+                         studio_range_input, luma.data(), chroma.data());
+
+    uint16_t* out = line_buffer + params_.active_video_start;
+    for (int32_t n = 0; n < active_width; ++n) {
+        out[n] = clamp_to_16bit(luma[n] + chroma[n]);
     }
 }
 
-uint16_t NTSCEncoder::clamp_signal(double value) const {
-    int32_t int_value = static_cast<int32_t>(value);
-    if (int_value < 0) return 0;
-    if (int_value > 65535) return 65535;
-    return static_cast<uint16_t>(int_value);
+void NTSCEncoder::encode_active_line_yc(uint16_t* y_buffer,
+                                       uint16_t* c_buffer,
+                                       const uint16_t* y_line,
+                                       const uint16_t* i_line,
+                                       const uint16_t* q_line,
+                                       int32_t line_number,
+                                       int32_t field_number,
+                                       int32_t width,
+                                       bool studio_range_input) {
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    thread_local std::vector<int32_t> luma;
+    thread_local std::vector<int32_t> chroma;
+    luma.resize(active_width);
+    chroma.resize(active_width);
+    encode_active_levels(y_line, i_line, q_line, line_number, field_number, width,
+                         studio_range_input, luma.data(), chroma.data());
+
+    // Y carries the luma only; C the chroma centred on the 16-bit midpoint
+    uint16_t* y_out = y_buffer + params_.active_video_start;
+    uint16_t* c_out = c_buffer + params_.active_video_start;
+    for (int32_t n = 0; n < active_width; ++n) {
+        y_out[n] = clamp_to_16bit(luma[n]);
+        c_out[n] = clamp_to_16bit(32768 + chroma[n]);
+    }
 }
 
 void NTSCEncoder::enable_vits() {
@@ -440,63 +515,52 @@ void NTSCEncoder::set_source_video_standard(SourceVideoStandard standard) {
     }
 }
 
-void NTSCEncoder::generate_biphase_vbi_line(uint16_t* line_buffer, int32_t line_number, 
-                                           int32_t field_number, int32_t vbi_value) {
-    // Start with a standard blanking line with sync and color burst
-    generate_blanking_line(line_buffer);
-    generate_sync_pulse(line_buffer, line_number);
-    generate_color_burst(line_buffer, line_number, field_number);
-    
-    // Calculate line period (H) for NTSC: approximately 63.56 µs
-    double line_period_h = 63.556e-6;  // ~63.56 µs for NTSC
-    
-    // Get biphase signal position
-    int32_t biphase_start = BiphaseEncoder::get_signal_start_position(sample_rate_, line_period_h);
-    
-    // Extract 24-bit VBI value into three bytes (MSB first)
-    uint8_t byte0 = static_cast<uint8_t>((vbi_value >> 16) & 0xFF);
-    uint8_t byte1 = static_cast<uint8_t>((vbi_value >> 8) & 0xFF);
-    uint8_t byte2 = static_cast<uint8_t>(vbi_value & 0xFF);
-    
-    // Generate biphase signal from the three bytes
-    // High level: white level, Low level: black level
-    std::vector<uint16_t> biphase_signal = BiphaseEncoder::encode(
-        byte0, byte1, byte2,
-        sample_rate_,
-        static_cast<uint16_t>(white_level_),
-        static_cast<uint16_t>(black_level_)
-    );
-    
-    // Insert biphase signal into the line
-    int32_t signal_end = biphase_start + static_cast<int32_t>(biphase_signal.size());
-    if (signal_end > params_.field_width) {
-        signal_end = params_.field_width;
+void NTSCEncoder::encode_data_lines(Field& field, int32_t field_number, bool is_first_field,
+                                    const VBIData* vbi_data, int32_t biphase_line) {
+    // Three consecutive lines of biphase data
+    if (vbi_data != nullptr) {
+        biphase_->render_lines({static_cast<uint32_t>(vbi_data->vbi0),
+                                static_cast<uint32_t>(vbi_data->vbi1),
+                                static_cast<uint32_t>(vbi_data->vbi2)},
+                               {field.line_data(biphase_line),
+                                field.line_data(biphase_line + 1),
+                                field.line_data(biphase_line + 2)},
+                               params_.field_width);
     }
     
-    for (int32_t i = biphase_start; i < signal_end; ++i) {
-        int32_t signal_index = i - biphase_start;
-        if (signal_index < static_cast<int32_t>(biphase_signal.size())) {
-            line_buffer[i] = biphase_signal[signal_index];
-        }
+    // VITC replaces VITS, as in encode_vbi_line()
+    if (!is_vits_enabled() && vitc_enabled_ && vitc_generator_) {
+        // Consumer tape VITC placement: lines 14 and 16 (0-indexed 13,15);
+        // line 15 carries biphase data instead when there is VBI data
+        uint16_t* vitc_lines[] = {field.line_data(13), field.line_data(15)};
+        int32_t line_count = (vbi_data != nullptr) ? 1 : 2;
+        int32_t total_frame = vitc_start_frame_offset_ + (field_number / 2);
+        vitc_generator_->generate_lines(VideoSystem::NTSC, total_frame, vitc_lines, line_count, !is_first_field);
     }
 }
 
 void NTSCEncoder::encode_frame_yc(const FrameBuffer& frame_buffer, int32_t field_number,
                                   Field& y_field1, Field& c_field1,
                                   Field& y_field2, Field& c_field2,
-                                  const VBIData* vbi_data) {
-    // Initialize fields
-    y_field1.resize(params_.field_width, params_.field_height);
-    c_field1.resize(params_.field_width, params_.field_height);
-    y_field2.resize(params_.field_width, params_.field_height);
-    c_field2.resize(params_.field_width, params_.field_height);
+                                  const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
     
     // For separate Y/C output, we encode Y and C directly from source YIQ data:
     // Y field: luma component with sync + blanking (no chroma modulation)
-    // C field: chroma-only signal (modulated subcarrier centered at blanking level)
+    // C field: chroma-only signal (modulated subcarrier centered at 32768)
     //
-    // This is NOT created by decomposing composite - we build Y and C separately
-    // from the source YIQ to avoid any quality loss.
+    // This is NOT created by decomposing composite - both come from the same
+    // filtered, resampled source line as the composite path.
+    encode_field_yc(frame_buffer, field_number, true, y_field1, c_field1, vbi_field1);
+    encode_field_yc(frame_buffer, field_number + 1, false, y_field2, c_field2, vbi_field2);
+}
+
+void NTSCEncoder::encode_field_yc(const FrameBuffer& frame_buffer, int32_t field_number,
+                                  bool is_first_field, Field& y_field, Field& c_field,
+                                  const VBIData* vbi_data) {
+    y_field.resize(params_.field_width, params_.field_height);
+    c_field.resize(params_.field_width, params_.field_height);
     
     // Get frame dimensions
     int32_t frame_width = frame_buffer.width();
@@ -509,287 +573,121 @@ void NTSCEncoder::encode_frame_yc(const FrameBuffer& frame_buffer, int32_t field
     const uint16_t* i_plane = frame_data + pixel_count;
     const uint16_t* q_plane = frame_data + pixel_count * 2;
 
-    // Detect studio-range input (≤1023) to preserve sub-black
-    uint16_t y_max = 0;
-    for (int32_t i = 0; i < pixel_count; ++i) {
-        if (y_plane[i] > y_max) y_max = y_plane[i];
-    }
-    const bool studio_range_input = (y_max <= 1023);
+    // Studio-range input (≤1023) preserves sub-black
+    const bool studio_range_input = frame_buffer.is_studio_range();
     
-    // Process field 1 (even lines from source)
+    // Sync, blanking, and VBI lines, and post-active blanking
     for (int32_t line = 0; line < params_.field_height; ++line) {
-        uint16_t* y_line = y_field1.line_data(line);
-        uint16_t* c_line = c_field1.line_data(line);
+        uint16_t* y_line = y_field.line_data(line);
+        uint16_t* c_line = c_field.line_data(line);
         
-        // For sync, blanking, and VBI lines
         if (line < ACTIVE_LINES_START) {
-            // Initialize Y field with blanking level
-            generate_blanking_line(y_line);
-            
-            // Generate sync and blanking for Y field (no color burst)
-            generate_sync_pulse(y_line, line);
-            
-            // C field gets color burst (modulated at blanking level, centered at 32768)
-            generate_color_burst_chroma(c_line, line, field_number);
-            
-            // Handle VBI lines if enabled
-            if (vbi_data != nullptr && (line == 14 || line == 15 || line == 16)) {
-                int32_t vbi_value = 0;
-                if (line == 14) vbi_value = vbi_data->vbi0;
-                else if (line == 15) vbi_value = vbi_data->vbi1;
-                else if (line == 16) vbi_value = vbi_data->vbi2;
-                generate_biphase_vbi_line(y_line, line, field_number, vbi_value);
-            }
-            // VITS lines for field 1 (if enabled)
-            else if (vits_enabled_ && vits_generator_) {
-                // First field VITS lines (0-indexed in field)
-                if (line == 18) {  // Line 19 in NTSC frame (first field)
-                    vits_generator_->generate_vir(y_line, field_number);
-                }
-                else if (line == 19) {  // Line 20 in NTSC frame (first field) - NTC-7 Composite
-                    vits_generator_->generate_ntc7_composite(y_line, field_number);
-                }
-                else {
-                    // Other VBI lines - regular blanking
-                }
-                
-                // For C field during VITS lines, set to neutral (no chroma modulation)
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
-            else if (vitc_enabled_ && vitc_generator_) {
-                // VITC placement on luma only (consumer tape)
-                if (line == 13 || line == 15) {
-                    int32_t total_frame = vitc_start_frame_offset_ + (field_number / 2);
-                    vitc_generator_->generate_line(VideoSystem::NTSC, total_frame, y_line, line, false);
-                }
-                // Keep chroma neutral on VITC lines
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
-
-            // Ensure no color burst appears in luma during VITS/VBI lines
-            const int32_t burst_start = params_.colour_burst_start;
-            const int32_t burst_end = params_.colour_burst_end;
-            for (int32_t s = burst_start; s < burst_end && s < params_.field_width; ++s) {
-                y_line[s] = static_cast<uint16_t>(blanking_level_);
-            }
+            encode_vbi_line_yc(y_line, c_line, line, field_number, is_first_field, vbi_data);
         } else if (line >= ACTIVE_LINES_END) {
-            // Post-active blanking
-            generate_blanking_line(y_line);
-            generate_color_burst_chroma(c_line, line, field_number);
-        } else {
-            // Active video line - encode Y and C separately from source
-            int32_t source_line = (line - ACTIVE_LINES_START) * 2;  // Even lines for field 1
-            if (source_line >= frame_height) source_line = frame_height - 1;
-            
-            // Initialize Y field with blanking (same as composite)
             generate_blanking_line(y_line);
-            
-            // Generate sync for Y field (no color burst in Y)
-            generate_sync_pulse(y_line, line);
-
-            // C field gets color burst during sync/burst period
-            generate_color_burst_chroma_line(c_line, line, field_number, params_.active_video_start);
-            
-            // Encode active video portion
-            int32_t active_start = params_.active_video_start;
-            int32_t active_end = params_.active_video_end;
-            int32_t active_width = active_end - active_start;
-            
-            // Calculate NTSC subcarrier phase offset for this line
-            // Use 262.5 lines per field to preserve half-line offset between fields
-            const double lines_per_field = 262.5;
-            const double cycles_per_line = 227.5;
-            double absolute_lines = static_cast<double>(field_number) * lines_per_field + static_cast<double>(line);
-            double prev_cycles = absolute_lines * cycles_per_line;
-            
-            for (int32_t sample = active_start; sample < active_end; ++sample) {
-                // Map sample position to source pixel
-                double pixel_pos = static_cast<double>(sample - active_start) * frame_width / active_width;
-                int32_t pixel_x = static_cast<int32_t>(pixel_pos);
-                if (pixel_x >= frame_width) pixel_x = frame_width - 1;
-                
-                // Get filtered YIQ values from source
-                uint16_t y_val = y_plane[source_line * frame_width + pixel_x];
-                uint16_t i_val = i_plane[source_line * frame_width + pixel_x];
-                uint16_t q_val = q_plane[source_line * frame_width + pixel_x];
-                
-                // Convert Y to luma signal level
-                int32_t luma_range = white_level_ - black_level_;
-                int32_t y_signal;
-                if (studio_range_input) {
-                    // Studio codes: 64→black_level, 940→white_level, preserve sub-black
-                    int32_t y_delta = static_cast<int32_t>(y_val) - 64;
-                    y_signal = black_level_ + (y_delta * luma_range) / 876; // 940-64=876
-                } else {
-                    // Full-range input
-                    double y_norm = static_cast<double>(y_val) / 65535.0;
-                    y_signal = black_level_ + static_cast<int32_t>(y_norm * luma_range);
-                }
-                
-                // Convert I/Q to chroma signal
-                const double I_MAX = 0.5959;
-                const double Q_MAX = 0.5229;
-                double i_norm, q_norm;
-                if (studio_range_input) {
-                    // Studio chroma: 0-896 range
-                    i_norm = ((static_cast<double>(i_val) / 896.0) - 0.5) * 2.0 * I_MAX;
-                    q_norm = ((static_cast<double>(q_val) / 896.0) - 0.5) * 2.0 * Q_MAX;
-                } else {
-                    // Full-range chroma
-                    i_norm = ((static_cast<double>(i_val) / 65535.0) - 0.5) * 2.0 * I_MAX;
-                    q_norm = ((static_cast<double>(q_val) / 65535.0) - 0.5) * 2.0 * Q_MAX;
-                }
-                
-                // Calculate subcarrier phase (include line phase offset for correct NTSC phase)
-                double t = static_cast<double>(sample) / sample_rate_;
-                double phase = 2.0 * PI * (subcarrier_freq_ * t + prev_cycles);
-                
-                // Modulate chroma onto subcarrier (NTSC encoding: C = I*sin(ωt) + Q*cos(ωt))
-                double chroma = (i_norm * std::sin(phase)) + (q_norm * std::cos(phase));
-                int32_t chroma_signal = static_cast<int32_t>(chroma * luma_range);
-                
-                // Y field: luma only (no chroma)
-                y_line[sample] = clamp_to_16bit(y_signal);
-                
-                // C field: chroma only (centered at 16-bit midpoint, no luma)
-                c_line[sample] = clamp_to_16bit(32768 + chroma_signal);
-            }
-            
-            // Fill remaining samples with blanking
-            for (int32_t sample = active_end; sample < params_.field_width; ++sample) {
-                c_line[sample] = static_cast<uint16_t>(32768);
-            }
+            chroma_templates_->copy(c_line, line, field_number);
         }
     }
     
-    // Process field 2 (odd lines from source)
-    for (int32_t line = 0; line < params_.field_height; ++line) {
-        uint16_t* y_line = y_field2.line_data(line);
-        uint16_t* c_line = c_field2.line_data(line);
+    encode_active_lines(field_number, frame_width, [&](int32_t line) {
+        uint16_t* y_line = y_field.line_data(line);
+        uint16_t* c_line = c_field.line_data(line);
         
-        if (line < ACTIVE_LINES_START) {
-            // Initialize Y field with blanking level
-            generate_blanking_line(y_line);
-            
-            // Generate sync and blanking for Y field (no color burst)
-            generate_sync_pulse(y_line, line);
-            generate_color_burst_chroma(c_line, line, field_number + 1);
-            
-            if (vbi_data != nullptr && (line == 14 || line == 15 || line == 16)) {
-                int32_t vbi_value = 0;
-                if (line == 14) vbi_value = vbi_data->vbi0;
-                else if (line == 15) vbi_value = vbi_data->vbi1;
-                else if (line == 16) vbi_value = vbi_data->vbi2;
-                generate_biphase_vbi_line(y_line, line, field_number + 1, vbi_value);
-            }
-            // VITS lines for field 2 (if enabled)
-            else if (vits_enabled_ && vits_generator_) {
-                // Second field VITS lines (0-indexed in field)
-                if (line == 18) {  // Line 282 in NTSC frame (second field)
-                    vits_generator_->generate_vir(y_line, field_number + 1);
-                }
-                else if (line == 19) {  // Line 283 in NTSC frame (second field) - NTC-7 Combination
-                    vits_generator_->generate_ntc7_combination(y_line, field_number + 1);
-                }
-                else {
-                    // Other VBI lines - regular blanking
-                }
-                
-                // For C field during VITS lines, set to neutral (no chroma modulation)
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
-            else if (vitc_enabled_ && vitc_generator_) {
-                if (line == 13 || line == 15) {
-                    int32_t total_frame = vitc_start_frame_offset_ + ((field_number + 1) / 2);
-                    vitc_generator_->generate_line(VideoSystem::NTSC, total_frame, y_line, line, true);
-                }
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
+        // Even source lines for the first field, odd for the second
+        int32_t source_line = (line - ACTIVE_LINES_START) * 2 + (is_first_field ? 0 : 1);
+        if (source_line >= frame_height) source_line = frame_height - 1;
+        
+        // Initialize Y field with blanking (same as composite)
+        generate_blanking_line(y_line);
+        
+        // Generate sync for Y field (no color burst in Y)
+        generate_sync_pulse(y_line, line);
 
-            // Ensure no color burst appears in luma during VITS/VBI lines
-            const int32_t burst_start = params_.colour_burst_start;
-            const int32_t burst_end = params_.colour_burst_end;
-            for (int32_t s = burst_start; s < burst_end && s < params_.field_width; ++s) {
-                y_line[s] = static_cast<uint16_t>(blanking_level_);
-            }
-        } else if (line >= ACTIVE_LINES_END) {
-            generate_blanking_line(y_line);
-            generate_color_burst_chroma(c_line, line, field_number + 1);
-        } else {
-            int32_t source_line = (line - ACTIVE_LINES_START) * 2 + 1;  // Odd lines for field 2
-            if (source_line >= frame_height) source_line = frame_height - 1;
-            
-            // Initialize Y field with blanking (same as composite)
-            generate_blanking_line(y_line);
-            
-            // Generate sync for Y field (no color burst in Y)
-            generate_sync_pulse(y_line, line);
-            
-            // C field gets color burst during sync/burst period
-            generate_color_burst_chroma_line(c_line, line, field_number + 1, params_.active_video_start);
-            
-            int32_t active_start = params_.active_video_start;
-            int32_t active_end = params_.active_video_end;
-            int32_t active_width = active_end - active_start;
-            
-            // Calculate NTSC subcarrier phase offset for this line
-            // Use 262.5 lines per field to preserve half-line offset between fields
-            const double lines_per_field = 262.5;
-            const double cycles_per_line = 227.5;
-            double absolute_lines = static_cast<double>(field_number + 1) * lines_per_field + static_cast<double>(line);
-            double prev_cycles = absolute_lines * cycles_per_line;
-            
-            for (int32_t sample = active_start; sample < active_end; ++sample) {
-                double pixel_pos = static_cast<double>(sample - active_start) * frame_width / active_width;
-                int32_t pixel_x = static_cast<int32_t>(pixel_pos);
-                if (pixel_x >= frame_width) pixel_x = frame_width - 1;
-                
-                uint16_t y_val = y_plane[source_line * frame_width + pixel_x];
-                uint16_t i_val = i_plane[source_line * frame_width + pixel_x];
-                uint16_t q_val = q_plane[source_line * frame_width + pixel_x];
-
-                int32_t luma_range = white_level_ - black_level_;
-                int32_t y_signal;
-                if (studio_range_input) {
-                    // Studio codes: 64→black_level, 940→white_level, preserve sub-black
-                    int32_t y_delta = static_cast<int32_t>(y_val) - 64;
-                    y_signal = black_level_ + (y_delta * luma_range) / 876; // 940-64=876
-                } else {
-                    // Full-range input
-                    double y_norm = static_cast<double>(y_val) / 65535.0;
-                    y_signal = black_level_ + static_cast<int32_t>(y_norm * luma_range);
-                }
-                
-                const double I_MAX = 0.5959;
-                const double Q_MAX = 0.5229;
-                double i_norm, q_norm;
-                if (studio_range_input) {
-                    // Studio chroma: 0-896 range
-                    i_norm = ((static_cast<double>(i_val) / 896.0) - 0.5) * 2.0 * I_MAX;
-                    q_norm = ((static_cast<double>(q_val) / 896.0) - 0.5) * 2.0 * Q_MAX;
-                } else {
-                    // Full-range chroma
-                    i_norm = ((static_cast<double>(i_val) / 65535.0) - 0.5) * 2.0 * I_MAX;
-                    q_norm = ((static_cast<double>(q_val) / 65535.0) - 0.5) * 2.0 * Q_MAX;
-                }
-                
-                // Calculate subcarrier phase (include line phase offset for correct NTSC phase)
-                double t = static_cast<double>(sample) / sample_rate_;
-                double phase = 2.0 * PI * (subcarrier_freq_ * t + prev_cycles);
-                
-                // Modulate chroma onto subcarrier (NTSC encoding: C = I*sin(ωt) + Q*cos(ωt))
-                double chroma = (i_norm * std::sin(phase)) + (q_norm * std::cos(phase));
-                int32_t chroma_signal = static_cast<int32_t>(chroma * luma_range);
-                
-                y_line[sample] = clamp_to_16bit(y_signal);
-                c_line[sample] = clamp_to_16bit(32768 + chroma_signal);
-            }
-            
-            for (int32_t sample = active_end; sample < params_.field_width; ++sample) {
-                c_line[sample] = static_cast<uint16_t>(32768);
-            }
+        // C field gets color burst during sync/burst period
+        chroma_templates_->copy(c_line, line, field_number);
+        
+        // Encode active video portion
+        size_t offset = static_cast<size_t>(source_line) * frame_width;
+        encode_active_line_yc(y_line, c_line, y_plane + offset, i_plane + offset, q_plane + offset,
+                              line, field_number, frame_width, studio_range_input);
+        
+        // Y keeps its blanking level after active video, C gets 16-bit center
+        std::fill(c_line + params_.active_video_end, c_line + params_.field_width,
+                  static_cast<uint16_t>(32768));
+    });
+    
+    encode_data_lines(y_field, field_number, is_first_field, vbi_data, 14);
+}
+
+void NTSCEncoder::encode_vbi_line_yc(uint16_t* y_line, uint16_t* c_line, int32_t line,
+                                     int32_t field_number, bool is_first_field,
+                                     const VBIData* vbi_data) {
+    // Initialize Y field with blanking level
+    generate_blanking_line(y_line);
+    
+    // Generate sync and blanking for Y field (no color burst)
+    generate_sync_pulse(y_line, line);
+    
+    // C field gets color burst (modulated at blanking level, centered at 32768)
+    chroma_templates_->copy(c_line, line, field_number);
+    
+    // Handle VBI lines if enabled
+    if (vbi_data != nullptr && (line == 14 || line == 15 || line == 16)) {
+        // Composite blanking underneath; the codes are drawn on Y by encode_data_lines()
+        line_templates_->copy(y_line, line, field_number);
+    }
+    // VITS lines (if enabled)
+    else if (vits_enabled_ && vits_generator_) {
+        // First field VITS lines (0-indexed in field)
+        if (is_first_field && line == 18) {  // Line 19 in NTSC frame (first field)
+            vits_generator_->generate_vir(y_line, field_number);
         }
+        else if (is_first_field && line == 19) {  // Line 20 in NTSC frame (first field) - NTC-7 Composite
+            vits_generator_->generate_ntc7_composite(y_line, field_number);
+        }
+        // Second field VITS lines (0-indexed in field)
+        else if (!is_first_field && line == 18) {  // Line 282 in NTSC frame (second field)
+            vits_generator_->generate_vir(y_line, field_number);
+        }
+        else if (!is_first_field && line == 19) {  // Line 283 in NTSC frame (second field) - NTC-7 Combination
+            vits_generator_->generate_ntc7_combination(y_line, field_number);
+        }
+        else {
+            // Other VBI lines - regular blanking
+        }
+        
+        // For C field during VITS lines, set to neutral (no chroma modulation)
+        std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
+    }
+    else if (vitc_enabled_ && vitc_generator_) {
+        // VITC on luma only (consumer tape) is drawn by encode_data_lines()
+        // Keep chroma neutral on VITC lines
+        std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
+    }
+
+    // Ensure no color burst appears in luma during VITS/VBI lines
+    const int32_t burst_start = params_.colour_burst_start;
+    const int32_t burst_end = params_.colour_burst_end;
+    for (int32_t s = burst_start; s < burst_end && s < params_.field_width; ++s) {
+        y_line[s] = static_cast<uint16_t>(blanking_level_);
+    }
+}
+
+void NTSCEncoder::refresh_data_lines_yc(int32_t field_number,
+                                        Field& y_field1, Field& c_field1,
+                                        Field& y_field2, Field& c_field2,
+                                        const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
+    
+    for (int32_t line : {13, 14, 15, 16}) {
+        encode_vbi_line_yc(y_field1.line_data(line), c_field1.line_data(line), line,
+                           field_number, true, vbi_field1);
+        encode_vbi_line_yc(y_field2.line_data(line), c_field2.line_data(line), line,
+                           field_number + 1, false, vbi_field2);
     }
+    encode_data_lines(y_field1, field_number, true, vbi_field1, 14);
+    encode_data_lines(y_field2, field_number + 1, false, vbi_field2, 14);
 }
 
 } // namespace encode_orc
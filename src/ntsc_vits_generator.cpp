@@ -16,7 +16,17 @@
 namespace encode_orc {
 
 NTSCVITSGenerator::NTSCVITSGenerator(const VideoParameters& params)
-    : params_(params) {
+    : params_(params),
+      subcarrier_(SubcarrierTable::for_parameters(params)),
+      lines_(params.field_width, NUM_SIGNALS, subcarrier_->sequence_fields(),
+             [this](int32_t signal, uint16_t* line_buffer, int32_t field_number) {
+                 switch (signal) {
+                     case VIR: render_vir(line_buffer, field_number); break;
+                     case NTC7_COMPOSITE: render_ntc7_composite(line_buffer, field_number); break;
+                     case NTC7_COMBINATION: render_ntc7_combination(line_buffer, field_number); break;
+                     default: break;
+                 }
+             }) {
     
     // Set signal levels
     sync_level_ = 0x0000;  // Sync tip at -40 to -43 IRE (0V)
@@ -50,24 +60,6 @@ int32_t NTSCVITSGenerator::ire_to_sample(double ire) const {
     }
 }
 
-double NTSCVITSGenerator::calculate_phase(int32_t field_number, int32_t line_number, int32_t sample) const {
-    // Calculate absolute line number in NTSC
-    // NTSC has 262.5 lines per field (525 total lines)
-    bool is_first_field = (field_number % 2) == 0;
-    int32_t frame_line = is_first_field ? (line_number * 2) : (line_number * 2 + 1);
-    
-    int32_t absolute_line = (field_number * 262) + frame_line;
-    
-    // NTSC: Subcarrier at 3.579545 MHz, 227.5 cycles per line (approximately)
-    // Precise calculation: fSC / line_rate
-    double cycles_per_line = subcarrier_freq_ / (30000.0 / 1001.0 / 525.0);
-    double prev_cycles = absolute_line * cycles_per_line;
-    
-    // Phase for this sample
-    double time_phase = 2.0 * PI * subcarrier_freq_ * sample / sample_rate_;
-    return 2.0 * PI * prev_cycles + time_phase;
-}
-
 void NTSCVITSGenerator::generate_sync_pulse(uint16_t* line_buffer) {
     // NTSC horizontal sync: ~4.7 µs
     int32_t sync_samples = static_cast<int32_t>(4.7 * samples_per_us_);
@@ -79,7 +71,7 @@ void NTSCVITSGenerator::generate_sync_pulse(uint16_t* line_buffer) {
 
 void NTSCVITSGenerator::generate_color_burst(uint16_t* line_buffer, int32_t field_number, int32_t line_number) {
     // Delegate to shared color burst generator
-    ColorBurstGenerator burst_gen(params_);
+    ColorBurstGenerator burst_gen(params_, *subcarrier_);
     int32_t luma_range = white_level_ - blanking_level_;
     int32_t burst_amplitude = static_cast<int32_t>((20.0 / 100.0) * luma_range);
     burst_gen.generate_ntsc_burst(line_buffer, line_number, field_number, blanking_level_, burst_amplitude);
@@ -139,11 +131,10 @@ void NTSCVITSGenerator::generate_12_5t_pulse(uint16_t* line_buffer, double cente
     int32_t blanking = ire_to_sample(0.0);
     int32_t peak_level = ire_to_sample(peak_ire);
     int32_t amplitude = (peak_level - blanking) / 2;  // Half for modulation
+    const SubcarrierTable::LinePhase line_phase = subcarrier_->line_phase(field_number, line_number);
     
     // Generate 12.5 cycles of subcarrier with triangular envelope
     for (int32_t sample = start_sample; sample < end_sample && sample < params_.field_width; ++sample) {
-        double phase = calculate_phase(field_number, line_number, sample);
-        
         // Apply triangular envelope
         double envelope;
         if (sample < center_sample) {
@@ -158,7 +149,7 @@ void NTSCVITSGenerator::generate_12_5t_pulse(uint16_t* line_buffer, double cente
         if (envelope < 0.0) envelope = 0.0;
         if (envelope > 1.0) envelope = 1.0;
         
-        double chroma_signal = std::sin(phase);
+        double chroma_signal = subcarrier_->sin_at(line_phase, sample);
         int32_t value = blanking + static_cast<int32_t>(amplitude * envelope * (1.0 + chroma_signal));
         line_buffer[sample] = clamp_to_16bit(value);
     }
@@ -171,6 +162,8 @@ void NTSCVITSGenerator::generate_modulated_staircase(uint16_t* line_buffer, doub
                                                      double envelope_time_us) {
     // Generate staircase with modulated chroma
     double phase_offset = chroma_phase * PI / 180.0;  // Convert degrees to radians
+    const SubcarrierTable::LinePhase line_phase = subcarrier_->line_phase(field_number, line_number)
+                                                      .shifted(std::sin(phase_offset), std::cos(phase_offset));
     
     for (int step = 0; step < num_steps - 1; ++step) {
         double step_start = step_times[step];
@@ -198,8 +191,7 @@ void NTSCVITSGenerator::generate_modulated_staircase(uint16_t* line_buffer, doub
             }
             
             // Calculate chroma with phase offset
-            double phase = calculate_phase(field_number, line_number, sample) + phase_offset;
-            double chroma = std::cos(phase);
+            double chroma = subcarrier_->cos_at(line_phase, sample);
             
             int32_t value = luma_level + static_cast<int32_t>(chroma_amp * envelope * chroma);
             line_buffer[sample] = clamp_to_16bit(value);
@@ -219,6 +211,8 @@ void NTSCVITSGenerator::generate_modulated_pedestal(uint16_t* line_buffer, doubl
     int32_t pedestal = (low_level + high_level) / 2;
     
     double phase_offset = chroma_phase * PI / 180.0;
+    const SubcarrierTable::LinePhase line_phase = subcarrier_->line_phase(field_number, line_number)
+                                                  .shifted(std::sin(phase_offset), std::cos(phase_offset));
     
     int32_t chroma_amp = static_cast<int32_t>((chroma_pp / 100.0) * (white_level_ - blanking_level_) / 2.0);
     
@@ -236,8 +230,7 @@ void NTSCVITSGenerator::generate_modulated_pedestal(uint16_t* line_buffer, doubl
             envelope = 0.5 * (1.0 - std::cos(PI * t_from_end / envelope_time_us));
         }
         
-        double phase = calculate_phase(field_number, line_number, sample) + phase_offset;
-        double chroma = std::cos(phase);
+        double chroma = subcarrier_->cos_at(line_phase, sample);
         
         int32_t value = pedestal + static_cast<int32_t>(chroma_amp * envelope * chroma);
         line_buffer[sample] = clamp_to_16bit(value);
@@ -270,6 +263,18 @@ void NTSCVITSGenerator::generate_multiburst_packet(uint16_t* line_buffer, double
 // ============================================================================
 
 void NTSCVITSGenerator::generate_vir(uint16_t* line_buffer, int32_t field_number) {
+    lines_.draw(VIR, line_buffer, field_number);
+}
+
+void NTSCVITSGenerator::generate_ntc7_composite(uint16_t* line_buffer, int32_t field_number) {
+    lines_.draw(NTC7_COMPOSITE, line_buffer, field_number);
+}
+
+void NTSCVITSGenerator::generate_ntc7_combination(uint16_t* line_buffer, int32_t field_number) {
+    lines_.draw(NTC7_COMBINATION, line_buffer, field_number);
+}
+
+void NTSCVITSGenerator::render_vir(uint16_t* line_buffer, int32_t field_number) {
     // VIR (Vertical Interval Reference) Signal for NTSC (FCC 73-699, CCIR 314-4)
     // Structure as described in FCC documentation
     // Note: Encoder has already set blanking level and added sync + color burst
@@ -293,7 +298,7 @@ void NTSCVITSGenerator::generate_vir(uint16_t* line_buffer, int32_t field_number
     generate_flat_level(line_buffer, 48.0, 60.0, 7.5);
 }
 
-void NTSCVITSGenerator::generate_ntc7_composite(uint16_t* line_buffer, int32_t field_number) {
+void NTSCVITSGenerator::render_ntc7_composite(uint16_t* line_buffer, int32_t field_number) {
     // NTC-7 Composite Test Signal for NTSC (Figure 8.40)
     // Components:
     // - 100 IRE white bar: 12–30 µs (with 125ns rise/fall times)
@@ -336,7 +341,7 @@ void NTSCVITSGenerator::generate_ntc7_composite(uint16_t* line_buffer, int32_t f
     // 62 µs onward returns to 0 IRE blanking (already set by initialization)
 }
 
-void NTSCVITSGenerator::generate_ntc7_combination(uint16_t* line_buffer, int32_t field_number) {
+void NTSCVITSGenerator::render_ntc7_combination(uint16_t* line_buffer, int32_t field_number) {
     // NTC-7 Combination Test Signal for NTSC (Figure 8.43)
     // Components:
     // - White flag: 100 IRE, 12-16 µs (4 µs width)
@@ -0,0 +1,35 @@
+/*
+ * File:        output_plan.cpp
+ * Module:      encode-orc
+ * Purpose:     Byte layout of a project's output files, computed before encoding
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "output_plan.h"
+
+namespace encode_orc {
+
+OutputPlan::OutputPlan(const std::vector<VideoSection>& sections, const VideoParameters& params,
+                       bool separate_yc)
+    : field_bytes_(static_cast<int64_t>(params.field_width) * params.field_height *
+                   static_cast<int64_t>(sizeof(uint16_t))),
+      file_count_(separate_yc ? 2 : 1) {
+    sections_.reserve(sections.size());
+    for (const auto& section : sections) {
+        Extent extent;
+        extent.first_field = total_fields_;
+        extent.field_count = static_cast<int64_t>(section_frames(section)) * 2;
+        sections_.push_back(extent);
+        total_fields_ += extent.field_count;
+    }
+}
+
+int32_t OutputPlan::section_frames(const VideoSection& section) {
+    const bool has_source = section.yuv422_image_source || section.png_image_source ||
+                            section.mov_file_source || section.mp4_file_source;
+    return has_source ? section.duration.value_or(0) : 0;
+}
+
+} // namespace encode_orc
@@ -21,6 +21,30 @@ PALEncoder::PALEncoder(const VideoParameters& params,
                        bool enable_luma_filter) 
     : params_(params),
       vits_enabled_(false) {
+    reconfigure(params, enable_chroma_filter, enable_luma_filter);
+}
+
+void PALEncoder::reconfigure(const VideoParameters& params,
+                             bool enable_chroma_filter,
+                             bool enable_luma_filter) {
+    // Generators cache levels and timing derived from the parameters, so
+    // they are only kept if the signal format is unchanged
+    if (!params_.has_same_signal_format(params)) {
+        vits_generator_.reset();
+        vitc_generator_.reset();
+        subcarrier_.reset();
+        modulator_.reset();
+        line_templates_.reset();
+        chroma_templates_.reset();
+        biphase_.reset();
+    }
+    params_ = params;
+    if (!subcarrier_) {
+        subcarrier_ = SubcarrierTable::for_parameters(params_);
+    }
+    if (!modulator_) {
+        modulator_ = std::make_unique<LineModulator>(params_, subcarrier_, U_MAX, V_MAX);
+    }
     
     // Set signal levels
     sync_level_ = 0x0000;  // Sync tip at 0 IRE (0V)
@@ -33,13 +57,87 @@ PALEncoder::PALEncoder(const VideoParameters& params,
     sample_rate_ = params_.sample_rate;
     samples_per_cycle_ = sample_rate_ / subcarrier_freq_;
     
-    // Initialize filters if requested
-    if (enable_chroma_filter) {
-        chroma_filter_ = Filters::create_pal_uv_filter();
+    // Template lines are generated on first use, after the levels above are set
+    if (!line_templates_) {
+        line_templates_ = std::make_unique<LineTemplateCache>(
+            params_.field_width, params_.field_height, subcarrier_->sequence_fields(),
+            [this](uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
+                if (line_number < VSYNC_LINES) {
+                    generate_vsync_line(line_buffer, line_number);
+                    return;
+                }
+                generate_blanking_line(line_buffer);
+                generate_sync_pulse(line_buffer, line_number);
+                generate_color_burst(line_buffer, line_number, field_number);
+            });
+    }
+    if (!chroma_templates_) {
+        chroma_templates_ = std::make_unique<LineTemplateCache>(
+            params_.field_width, params_.field_height, subcarrier_->sequence_fields(),
+            [this](uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
+                generate_color_burst_chroma(line_buffer, line_number, field_number);
+            });
+    }
+    if (!biphase_) {
+        // Biphase codes run from white (high) to black (low), 64 µs line period
+        biphase_ = std::make_unique<BiphaseEncoder>(sample_rate_, 64e-6,
+                                                    static_cast<uint16_t>(white_level_),
+                                                    static_cast<uint16_t>(black_level_));
+    }
+    
+    // Initialize filters if requested (coefficients are fixed, so an
+    // existing filter is kept as-is)
+    if (!enable_chroma_filter) {
+        chroma_filter_.reset();
+    } else if (!chroma_filter_) {
+        chroma_filter_ = Filters::make_pal_uv_filter();
+    }
+    if (!enable_luma_filter) {
+        luma_filter_.reset();
+    } else if (!luma_filter_) {
+        luma_filter_ = Filters::make_pal_uv_filter();  // Reuse same filter for luma
+    }
+    
+    reset();
+}
+
+const HorizontalResampler& PALEncoder::resampler_for(int32_t source_width) {
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    const HorizontalResampler::Mode mode = HorizontalResampler::default_mode();
+    if (!resampler_ || !resampler_->matches(source_width, active_width, mode)) {
+        resampler_ = std::make_unique<HorizontalResampler>(source_width, active_width, mode);
     }
-    if (enable_luma_filter) {
-        luma_filter_ = Filters::create_pal_uv_filter();  // Reuse same filter for luma
+    return *resampler_;
+}
+
+void PALEncoder::encode_active_lines(int32_t field_number, int32_t source_width,
+                                    const std::function<void(int32_t line)>& encode_line) {
+    if (!line_pool_) {
+        for (int32_t line = ACTIVE_LINES_START; line < ACTIVE_LINES_END; ++line) {
+            encode_line(line);
+        }
+        return;
     }
+    
+    // Build everything the lines share before the threads read it
+    line_templates_->prepare(field_number);
+    chroma_templates_->prepare(field_number);
+    resampler_for(source_width);
+    line_pool_->run(ACTIVE_LINES_START, ACTIVE_LINES_END, encode_line);
+}
+
+void PALEncoder::set_line_threads(int32_t num_threads) {
+    if (num_threads <= 1) {
+        line_pool_.reset();
+    } else if (!line_pool_ || line_pool_->num_threads() != num_threads) {
+        line_pool_ = std::make_unique<LineThreadPool>(num_threads);
+    }
+}
+
+void PALEncoder::reset() {
+    vits_enabled_ = false;
+    vitc_enabled_ = false;
+    vitc_start_frame_offset_ = 0;
 }
 
 void PALEncoder::enable_vits() {
@@ -92,144 +190,154 @@ void PALEncoder::set_source_video_standard(SourceVideoStandard standard) {
 }
 
 Frame PALEncoder::encode_frame(const FrameBuffer& frame_buffer, int32_t field_number,
-                              const VBIData* vbi_data) {
-    Frame frame(params_.field_width, params_.field_height);
+                               const FrameVBI* frame_vbi) {
+    Frame frame;
+    encode_frame(frame_buffer, field_number, frame, frame_vbi);
+    return frame;
+}
+
+void PALEncoder::encode_frame(const FrameBuffer& frame_buffer, int32_t field_number, Frame& frame,
+                              const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
     
     // Encode first field (even lines: 0, 2, 4, ...)
-    frame.field1() = encode_field(frame_buffer, field_number, true, vbi_data);
+    encode_field(frame_buffer, field_number, true, frame.field1(), vbi_field1);
     
     // Encode second field (odd lines: 1, 3, 5, ...)
-    frame.field2() = encode_field(frame_buffer, field_number + 1, false, vbi_data);
-    
-    return frame;
+    encode_field(frame_buffer, field_number + 1, false, frame.field2(), vbi_field2);
 }
 
 Field PALEncoder::encode_field(const FrameBuffer& frame_buffer, 
                                int32_t field_number, 
                                bool is_first_field,
                                const VBIData* vbi_data) {
-    Field field(params_.field_width, params_.field_height);
+    Field field;
+    encode_field(frame_buffer, field_number, is_first_field, field, vbi_data);
+    return field;
+}
+
+void PALEncoder::encode_field(const FrameBuffer& frame_buffer, 
+                              int32_t field_number, 
+                              bool is_first_field,
+                              Field& field,
+                              const VBIData* vbi_data) {
+    field.resize(params_.field_width, params_.field_height);
 
     // Verify input format
     if (frame_buffer.format() != FrameBuffer::Format::YUV444P16) {
         // For now, just create a blanking field if wrong format
         field.fill(static_cast<uint16_t>(blanking_level_));
-        return field;
+        return;
     }
     
-    // Detect if source is in studio code space (≤1023) to preserve sub-black
-    const uint16_t* y_plane_all = frame_buffer.data().data();
-    const int32_t total_pixels = frame_buffer.width() * frame_buffer.height();
-    uint16_t y_max = 0;
-    for (int32_t i = 0; i < total_pixels; ++i) {
-        if (y_plane_all[i] > y_max) y_max = y_plane_all[i];
-    }
-    const bool studio_range_input = (y_max <= 1023);
+    // Studio code space (≤1023) preserves sub-black; range is classified by the loader
+    const bool studio_range_input = frame_buffer.is_studio_range();
     
     // Get frame dimensions
     int32_t frame_width = frame_buffer.width();
     int32_t frame_height = frame_buffer.height();
     
-    // PAL has 313 lines per field
+    // PAL has 313 lines per field; sync, VBI and post-video blanking first
     for (int32_t line = 0; line < LINES_PER_FIELD; ++line) {
         uint16_t* line_buffer = field.line_data(line);
         
         // Lines 1-5: Vertical sync (field sync)
         if (line < VSYNC_LINES) {
-            generate_vsync_line(line_buffer, line);
+            line_templates_->copy(line_buffer, line, field_number);
         }
         // Lines 6-22: VBI (Vertical Blanking Interval)
         else if (line < ACTIVE_LINES_START) {
-            // Lines 15, 16, 17 (0-indexed) = field lines 16, 17, 18 contain biphase data
-            if (vbi_data != nullptr && (line == 15 || line == 16 || line == 17)) {
-                int32_t vbi_value = 0;
-                if (line == 15) vbi_value = vbi_data->vbi0;
-                else if (line == 16) vbi_value = vbi_data->vbi1;
-                else if (line == 17) vbi_value = vbi_data->vbi2;
-                generate_biphase_vbi_line(line_buffer, line, field_number, vbi_value);
-            }
-            // VITS lines (if enabled)
-            else if (is_vits_enabled()) {
-                // First field VITS lines (0-indexed in field)
-                if (is_first_field && line == 12) {  // Line 13 in PAL frame (odd-first field parity)
-                    vits_generator_->generate_multiburst(line_buffer, field_number);
-                }
-                else if (is_first_field && line == 18) {  // Line 332 in PAL frame
-                    vits_generator_->generate_uk_national(line_buffer, field_number);
-                }
-                // Second field VITS lines (0-indexed in field)
-                else if (!is_first_field && line == 12) {  // Line 13 in PAL frame
-                    vits_generator_->generate_itu_its(line_buffer, field_number);
-                }
-                else if (!is_first_field && line == 18) {  // Line 19 in PAL frame
-                    vits_generator_->generate_itu_composite(line_buffer, field_number);
-                }
-                else {
-                    generate_blanking_line(line_buffer);
-                    generate_sync_pulse(line_buffer, line);
-                    generate_color_burst(line_buffer, line, field_number);
-                }
-            }
-            else if (is_vitc_enabled()) {
-                // Consumer tape VITC placement: lines 19 and 21 (0-indexed 18,20)
-                generate_blanking_line(line_buffer);
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-                if (line == 18 || line == 20) {
-                    int32_t total_frame = vitc_start_frame_offset_ + (field_number / 2);
-                    vitc_generator_->generate_line(VideoSystem::PAL, total_frame, line_buffer, line, !is_first_field);
-                }
-            }
-            else {
-                generate_blanking_line(line_buffer);
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-            }
+            encode_vbi_line(line_buffer, line, field_number, is_first_field, vbi_data);
         }
-        // Lines 23-310: Active video
-        else if (line < ACTIVE_LINES_END) {
-            // Calculate which line in the source frame to use
-            int32_t line_in_field = line - ACTIVE_LINES_START;
-            int32_t line_in_frame = is_first_field ? (line_in_field * 2) : (line_in_field * 2 + 1);
+        // Lines 311-313: Post-video blanking
+        else if (line >= ACTIVE_LINES_END) {
+            line_templates_->copy(line_buffer, line, field_number);
+        }
+    }
+    
+    // Lines 23-310: Active video
+    encode_active_lines(field_number, frame_width, [&](int32_t line) {
+        uint16_t* line_buffer = field.line_data(line);
+        
+        // Calculate which line in the source frame to use
+        int32_t line_in_field = line - ACTIVE_LINES_START;
+        int32_t line_in_frame = is_first_field ? (line_in_field * 2) : (line_in_field * 2 + 1);
+        
+        // Blanking with sync and color burst, from the template cache
+        line_templates_->copy(line_buffer, line, field_number);
+        
+        // Check if line is within source frame
+        if (line_in_frame < frame_height) {
+            // Get pointers to YUV data
+            const uint16_t* frame_data = frame_buffer.data().data();
+            int32_t pixel_count = frame_width * frame_height;
+            const uint16_t* y_plane = frame_data;
+            const uint16_t* u_plane = frame_data + pixel_count;
+            const uint16_t* v_plane = frame_data + pixel_count * 2;
             
-            // Initialize line with blanking level
-            generate_blanking_line(line_buffer);
+            const uint16_t* y_line = y_plane + (line_in_frame * frame_width);
+            const uint16_t* u_line = u_plane + (line_in_frame * frame_width);
+            const uint16_t* v_line = v_plane + (line_in_frame * frame_width);
             
-            // Check if line is within source frame
-            if (line_in_frame < frame_height) {
-                // Get pointers to YUV data
-                const uint16_t* frame_data = frame_buffer.data().data();
-                int32_t pixel_count = frame_width * frame_height;
-                const uint16_t* y_plane = frame_data;
-                const uint16_t* u_plane = frame_data + pixel_count;
-                const uint16_t* v_plane = frame_data + pixel_count * 2;
-                
-                const uint16_t* y_line = y_plane + (line_in_frame * frame_width);
-                const uint16_t* u_line = u_plane + (line_in_frame * frame_width);
-                const uint16_t* v_line = v_plane + (line_in_frame * frame_width);
-                
-                // Generate horizontal sync and color burst
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-                
-                // Encode active video portion
-                encode_active_line(line_buffer, y_line, u_line, v_line, 
-                                 line, field_number, frame_width, studio_range_input);
-            } else {
-                // Beyond source frame - use blanking with sync and burst
-                generate_sync_pulse(line_buffer, line);
-                generate_color_burst(line_buffer, line, field_number);
-            }
+            // Encode active video portion
+            encode_active_line(line_buffer, y_line, u_line, v_line, 
+                             line, field_number, frame_width, studio_range_input);
+        }
+    });
+    
+    encode_data_lines(field, field_number, is_first_field, vbi_data);
+}
+
+void PALEncoder::encode_vbi_line(uint16_t* line_buffer, int32_t line, int32_t field_number,
+                                 bool is_first_field, const VBIData* vbi_data) {
+    // Lines 15, 16, 17 (0-indexed) = field lines 16, 17, 18 contain biphase data
+    if (vbi_data != nullptr && (line == 15 || line == 16 || line == 17)) {
+        // Codes are drawn by encode_data_lines()
+        line_templates_->copy(line_buffer, line, field_number);
+    }
+    // VITS lines (if enabled)
+    else if (is_vits_enabled()) {
+        // First field VITS lines (0-indexed in field)
+        if (is_first_field && line == 12) {  // Line 13 in PAL frame (odd-first field parity)
+            vits_generator_->generate_multiburst(line_buffer, field_number);
+        }
+        else if (is_first_field && line == 18) {  // Line 332 in PAL frame
+            vits_generator_->generate_uk_national(line_buffer, field_number);
+        }
+        // Second field VITS lines (0-indexed in field)
+        else if (!is_first_field && line == 12) {  // Line 13 in PAL frame
+            vits_generator_->generate_itu_its(line_buffer, field_number);
+        }
+        else if (!is_first_field && line == 18) {  // Line 19 in PAL frame
+            vits_generator_->generate_itu_composite(line_buffer, field_number);
         }
-        // Lines 311-313: Post-video blanking
         else {
-            generate_blanking_line(line_buffer);
-            generate_sync_pulse(line_buffer, line);
-            generate_color_burst(line_buffer, line, field_number);
+            line_templates_->copy(line_buffer, line, field_number);
         }
     }
+    else if (is_vitc_enabled()) {
+        // Consumer tape VITC placement: lines 19 and 21 (0-indexed 18,20)
+        // Timecode is drawn by encode_data_lines()
+        line_templates_->copy(line_buffer, line, field_number);
+    }
+    else {
+        line_templates_->copy(line_buffer, line, field_number);
+    }
+}
+
+void PALEncoder::refresh_data_lines(Frame& frame, int32_t field_number, const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
     
-    return field;
+    // Only the biphase (15-17) and VITC (18, 20) lines carry per-frame data;
+    // everything else repeats with the 8-field colour sequence
+    for (int32_t line : {15, 16, 17, 18, 20}) {
+        encode_vbi_line(frame.field1().line_data(line), line, field_number, true, vbi_field1);
+        encode_vbi_line(frame.field2().line_data(line), line, field_number + 1, false, vbi_field2);
+    }
+    encode_data_lines(frame.field1(), field_number, true, vbi_field1);
+    encode_data_lines(frame.field2(), field_number + 1, false, vbi_field2);
 }
 
 void PALEncoder::generate_sync_pulse(uint16_t* line_buffer, int32_t /* line_number */) {
@@ -249,7 +357,7 @@ void PALEncoder::generate_sync_pulse(uint16_t* line_buffer, int32_t /* line_numb
 
 void PALEncoder::generate_color_burst(uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
     // Delegate to shared color burst generator
-    ColorBurstGenerator burst_gen(params_);
+    ColorBurstGenerator burst_gen(params_, *subcarrier_);
     int32_t luma_range = white_level_ - blanking_level_;
     int32_t burst_amplitude = static_cast<int32_t>((3.0 / 14.0) * luma_range);
     burst_gen.generate_pal_burst(line_buffer, line_number, field_number, blanking_level_, burst_amplitude);
@@ -257,7 +365,7 @@ void PALEncoder::generate_color_burst(uint16_t* line_buffer, int32_t line_number
 
 void PALEncoder::generate_color_burst_chroma(uint16_t* line_buffer, int32_t line_number, int32_t field_number) {
     // Generate color burst on chroma channel (centered at 32768)
-    ColorBurstGenerator burst_gen(params_);
+    ColorBurstGenerator burst_gen(params_, *subcarrier_);
     
     // Calculate burst amplitude: 3/14 of luma range (same as composite mode)
     int32_t luma_range = white_level_ - blanking_level_;
@@ -267,19 +375,6 @@ void PALEncoder::generate_color_burst_chroma(uint16_t* line_buffer, int32_t line
     burst_gen.generate_pal_burst(line_buffer, line_number, field_number, 32768, burst_amplitude);
 }
 
-void PALEncoder::generate_color_burst_chroma_line(uint16_t* line_buffer, int32_t line_number, 
-                                                   int32_t field_number, int32_t /* burst_end */) {
-    // Generate color burst on chroma for the portion before active video
-    ColorBurstGenerator burst_gen(params_);
-    
-    // Calculate burst amplitude: 3/14 of luma range (same as composite mode for PAL)
-    int32_t luma_range = white_level_ - blanking_level_;
-    int32_t burst_amplitude = static_cast<int32_t>((3.0 / 14.0) * luma_range);
-    
-    // Generate burst centered at 32768
-    burst_gen.generate_pal_burst(line_buffer, line_number, field_number, 32768, burst_amplitude);
-}
-
 void PALEncoder::generate_vsync_line(uint16_t* line_buffer, int32_t line_number) {
     // PAL vertical sync pattern
     // Lines 1-2.5: broad pulses (inverted)
@@ -315,14 +410,15 @@ void PALEncoder::generate_blanking_line(uint16_t* line_buffer) {
     std::fill_n(line_buffer, params_.field_width, static_cast<uint16_t>(blanking_level_));
 }
 
-void PALEncoder::encode_active_line(uint16_t* line_buffer,
-                                   const uint16_t* y_line,
-                                   const uint16_t* u_line,
-                                   const uint16_t* v_line,
-                                   int32_t line_number,
-                                   int32_t field_number,
-                                   int32_t width,
-                                   bool studio_range_input) {
+void PALEncoder::encode_active_levels(const uint16_t* y_line,
+                                     const uint16_t* u_line,
+                                     const uint16_t* v_line,
+                                     int32_t line_number,
+                                     int32_t field_number,
+                                     int32_t width,
+                                     bool studio_range_input,
+                                     int32_t* luma,
+                                     int32_t* chroma) {
     // Resolve source pointers; only allocate filtered buffers when filters are enabled.
     const uint16_t* y_data = y_line;
     const uint16_t* u_data = u_line;
@@ -331,8 +427,7 @@ void PALEncoder::encode_active_line(uint16_t* line_buffer,
     if (luma_filter_) {
         thread_local std::vector<uint16_t> y_filtered;
         y_filtered.resize(width);
-        std::copy(y_line, y_line + width, y_filtered.begin());
-        luma_filter_->apply(y_filtered);
+        luma_filter_->apply(y_line, y_filtered.data(), width);
         y_data = y_filtered.data();
     }
 
@@ -341,209 +436,127 @@ void PALEncoder::encode_active_line(uint16_t* line_buffer,
         thread_local std::vector<uint16_t> v_filtered;
         u_filtered.resize(width);
         v_filtered.resize(width);
-        std::copy(u_line, u_line + width, u_filtered.begin());
-        std::copy(v_line, v_line + width, v_filtered.begin());
-        chroma_filter_->apply(u_filtered);
-        chroma_filter_->apply(v_filtered);
+        chroma_filter_->apply(u_line, u_filtered.data(), width);
+        chroma_filter_->apply(v_line, v_filtered.data(), width);
         u_data = u_filtered.data();
         v_data = v_filtered.data();
     }
     
-    // Encode the active video portion of the line
-    int32_t active_start = params_.active_video_start;
-    int32_t active_end = params_.active_video_end;
-    int32_t active_width = active_end - active_start;
-    
-    // Calculate absolute line number in PAL 8-field sequence
-    // Following ld-chroma-encoder's calculation [palencoder.cpp:186-188]
-    // First, convert field line number to frame line number (1-625)
-    bool is_first_field = (field_number % 2) == 0;
-    int32_t frame_line = is_first_field ? (line_number * 2 + 1) : (line_number * 2 + 2);
-    
-    // Now calculate prevLines using frame_line
-    int32_t field_id = field_number % 8;
-    int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-    
-    // Get V-switch for PAL alternation (based on absolute line number)
-    // PAL V-switch alternates every line
-    int32_t v_switch = (prev_lines % 2 == 0) ? 1 : -1;
-    
-    // PAL subcarrier phase calculation (following ld-chroma-encoder):
-    // prevCycles = number of complete cycles of subcarrier since sequence start
-    // phase = 2π * (fSC * t + prevCycles)
-    // where prevCycles accumulates by 283.7516 per line
-    double prev_cycles = prev_lines * 283.7516;  // Cycles of phase advance
-
-    const double phase_step = 2.0 * PI * (subcarrier_freq_ / sample_rate_);
-    double phase = (2.0 * PI * prev_cycles) + static_cast<double>(active_start) * phase_step;
-    double sin_phase = std::sin(phase);
-    double cos_phase = std::cos(phase);
-    const double sin_step = std::sin(phase_step);
-    const double cos_step = std::cos(phase_step);
-
-    const double pixel_step = static_cast<double>(width) / active_width;
-    double pixel_pos = 0.0;
-
-    for (int32_t sample = active_start; sample < active_end; ++sample) {
-        int32_t pixel_x = static_cast<int32_t>(pixel_pos);
-        pixel_pos += pixel_step;
-
-        if (pixel_x >= width) pixel_x = width - 1;
-
-        const uint16_t y = y_data[pixel_x];
-        const uint16_t u = u_data[pixel_x];
-        const uint16_t v = v_data[pixel_x];
-
-        int32_t luma_range = white_level_ - black_level_;
-        int32_t luma_scaled;
-
-        if (studio_range_input) {
-            // Preserve sub-black: don't clamp luma_scaled, allow negative values
-            luma_scaled = black_level_ + ((static_cast<int32_t>(y) - 64) * luma_range) / 876;
-        } else {
-            double y_norm = static_cast<double>(y) / 65535.0;
-            luma_scaled = black_level_ + static_cast<int32_t>(y_norm * luma_range);
-        }
-
-        const double U_MAX = 0.436010;
-        const double V_MAX = 0.614975;
-        double u_norm;
-        double v_norm;
-        if (studio_range_input) {
-            u_norm = ((static_cast<double>(u) / 896.0) - 0.5) * 2.0 * U_MAX;
-            v_norm = ((static_cast<double>(v) / 896.0) - 0.5) * 2.0 * V_MAX;
-        } else {
-            u_norm = ((static_cast<double>(u) / 65535.0) - 0.5) * 2.0 * U_MAX;
-            v_norm = ((static_cast<double>(v) / 65535.0) - 0.5) * 2.0 * V_MAX;
-        }
-
-        double chroma = (u_norm * sin_phase) + (v_norm * v_switch * cos_phase);
-        int32_t chroma_scaled = static_cast<int32_t>(chroma * luma_range);
-
-        int32_t composite = luma_scaled + chroma_scaled;
-        line_buffer[sample] = clamp_to_16bit(composite);
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    
+    // Subcarrier phase and V-switch for this line of the 8-field sequence
+    const SubcarrierTable& subcarrier = *subcarrier_;
+    const SubcarrierTable::LinePhase line_phase = subcarrier.line_phase(field_number, line_number);
+
+    // Map the source pixels onto the active samples
+    const HorizontalResampler& resampler = resampler_for(width);
+    thread_local std::vector<uint16_t> y_active;
+    thread_local std::vector<uint16_t> u_active;
+    thread_local std::vector<uint16_t> v_active;
+    y_active.resize(active_width);
+    u_active.resize(active_width);
+    v_active.resize(active_width);
+    resampler.apply(y_data, y_active.data());
+    resampler.apply(u_data, u_active.data());
+    resampler.apply(v_data, v_active.data());
+    const uint16_t* y = y_active.data();
+    const uint16_t* u = u_active.data();
+    const uint16_t* v = v_active.data();
+
+    // Levels and subcarrier modulation (exact or fixed-point kernel)
+    modulator_->modulate(y, u, v, studio_range_input, line_phase, luma, chroma);
+}
 
-        double next_sin = (sin_phase * cos_step) + (cos_phase * sin_step);
-        double next_cos = (cos_phase * cos_step) - (sin_phase * sin_step);
-        sin_phase = next_sin;
-        cos_phase = next_cos;
+void PALEncoder::encode_active_line(uint16_t* line_buffer,
+                                   const uint16_t* y_line,
+                                   const uint16_t* u_line,
+                                   const uint16_t* v_line,
+                                   int32_t line_number,
+                                   int32_t field_number,
+                                   int32_t width,
+                                   bool studio_range_input) {
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    thread_local std::vector<int32_t> luma;
+    thread_local std::vector<int32_t> chroma;
+    luma.resize(active_width);
+    chroma.resize(active_width);
+    encode_active_levels(y_line, u_line, v_line, line_number, field_number, width,
+                         studio_range_input, luma.data(), chroma.data());
+
+    uint16_t* out = line_buffer + params_.active_video_start;
+    for (int32_t n = 0; n < active_width; ++n) {
+        out[n] = clamp_to_16bit(luma[n] + chroma[n]);
     }
 }
 
-uint16_t PALEncoder::yuv_to_composite(uint16_t y, uint16_t u, uint16_t v,
-                                      double phase, int32_t v_switch, bool studio_range_input) {
-    // Convert 16-bit YUV to normalized values
-    // For studio input (y,u,v in 0-1023 range):
-    //   Y: 0-1023 → map 64→black, 940→white, preserve sub-black (0-63)
-    //   U,V: 0-896 → map to ±0.436/±0.614
-    // For full-range input (y,u,v in 0-65535 range):
-    //   Y: 0-65535 → 0.0-1.0
-    //   U,V: 0-65535 → ±0.436/±0.615
-    
-    int32_t luma_range = white_level_ - black_level_;
-    int32_t luma_scaled;
-    
-    if (studio_range_input) {
-        // Studio codes: 64→black_level, 940→white_level, preserve sub-black (allows negative)
-        luma_scaled = black_level_ + ((static_cast<int32_t>(y) - 64) * luma_range) / 876;
-    } else {
-        // Full-range: 0-65535 → normalized to black-white range
-        double y_norm = static_cast<double>(y) / 65535.0;
-        luma_scaled = black_level_ + static_cast<int32_t>(y_norm * luma_range);
-    }
-    
-    // Scale U/V back to their actual ranges
-    // Max values for PAL: U_MAX=0.436010, V_MAX=0.614975
-    const double U_MAX = 0.436010;
-    const double V_MAX = 0.614975;
-    double u_norm, v_norm;
-    if (studio_range_input) {
-        // Studio chroma: 0-896 range (64-960 studio codes)
-        u_norm = ((static_cast<double>(u) / 896.0) - 0.5) * 2.0 * U_MAX;
-        v_norm = ((static_cast<double>(v) / 896.0) - 0.5) * 2.0 * V_MAX;
-    } else {
-        // Full-range: 0-65535
-        u_norm = ((static_cast<double>(u) / 65535.0) - 0.5) * 2.0 * U_MAX;  // ±U_MAX range
-        v_norm = ((static_cast<double>(v) / 65535.0) - 0.5) * 2.0 * V_MAX;  // ±V_MAX range
+void PALEncoder::encode_active_line_yc(uint16_t* y_buffer,
+                                      uint16_t* c_buffer,
+                                      const uint16_t* y_line,
+                                      const uint16_t* u_line,
+                                      const uint16_t* v_line,
+                                      int32_t line_number,
+                                      int32_t field_number,
+                                      int32_t width,
+                                      bool studio_range_input) {
+    const int32_t active_width = params_.active_video_end - params_.active_video_start;
+    thread_local std::vector<int32_t> luma;
+    thread_local std::vector<int32_t> chroma;
+    luma.resize(active_width);
+    chroma.resize(active_width);
+    encode_active_levels(y_line, u_line, v_line, line_number, field_number, width,
+                         studio_range_input, luma.data(), chroma.data());
+
+    // Y carries the luma only; C the chroma centred on the 16-bit midpoint
+    uint16_t* y_out = y_buffer + params_.active_video_start;
+    uint16_t* c_out = c_buffer + params_.active_video_start;
+    for (int32_t n = 0; n < active_width; ++n) {
+        y_out[n] = clamp_to_16bit(luma[n]);
+        c_out[n] = clamp_to_16bit(32768 + chroma[n]);
     }
-    
-    // PAL chroma encoding - following ld-chroma-encoder exactly
-    // Composite = Y + U*sin(ωt) + V*cos(ωt)*Vsw  (from Poynton p338)
-    // The V-switch alternates the V component sign every line
-    // 
-    // U and V are in their natural ±U_MAX/±V_MAX ranges
-    // They modulate the chroma signal directly as per ld-chroma-encoder
-    
-    // Calculate chroma modulation (using U/V directly as per ld-chroma-encoder)
-    double chroma = (u_norm * std::sin(phase)) + (v_norm * v_switch * std::cos(phase));
-    
-    // Scale chroma to signal amplitude (matching ld-chroma-encoder)
-    // The chroma modulates directly, scaled by luma_range
-    int32_t chroma_scaled = static_cast<int32_t>(chroma * luma_range);
-    
-    // Combine luma and chroma
-    int32_t composite = luma_scaled + chroma_scaled;
-    
-    return clamp_to_16bit(composite);
 }
 
-void PALEncoder::generate_biphase_vbi_line(uint16_t* line_buffer, int32_t line_number,
-                                           int32_t field_number, int32_t vbi_value) {
-    // Start with a standard blanking line with sync and color burst
-    generate_blanking_line(line_buffer);
-    generate_sync_pulse(line_buffer, line_number);
-    generate_color_burst(line_buffer, line_number, field_number);
-    
-    // Calculate line period (H) for PAL: 64 µs
-    double line_period_h = 64.0e-6;  // 64 µs for PAL
-    
-    // Get biphase signal position
-    int32_t biphase_start = BiphaseEncoder::get_signal_start_position(sample_rate_, line_period_h);
-    
-    // Extract 24-bit VBI value into three bytes (MSB first)
-    uint8_t byte0 = static_cast<uint8_t>((vbi_value >> 16) & 0xFF);
-    uint8_t byte1 = static_cast<uint8_t>((vbi_value >> 8) & 0xFF);
-    uint8_t byte2 = static_cast<uint8_t>(vbi_value & 0xFF);
-    
-    // Generate biphase signal from the three bytes
-    // High level: white level, Low level: black level
-    std::vector<uint16_t> biphase_signal = BiphaseEncoder::encode(
-        byte0, byte1, byte2,
-        sample_rate_,
-        static_cast<uint16_t>(white_level_),
-        static_cast<uint16_t>(black_level_)
-    );
-    
-    // Insert biphase signal into the line
-    int32_t signal_end = biphase_start + static_cast<int32_t>(biphase_signal.size());
-    if (signal_end > params_.field_width) {
-        signal_end = params_.field_width;
+void PALEncoder::encode_data_lines(Field& field, int32_t field_number, bool is_first_field,
+                                   const VBIData* vbi_data) {
+    // Lines 15, 16, 17 (0-indexed) = field lines 16, 17, 18 contain biphase data
+    if (vbi_data != nullptr) {
+        biphase_->render_lines({static_cast<uint32_t>(vbi_data->vbi0),
+                                static_cast<uint32_t>(vbi_data->vbi1),
+                                static_cast<uint32_t>(vbi_data->vbi2)},
+                               {field.line_data(15), field.line_data(16), field.line_data(17)},
+                               params_.field_width);
     }
     
-    for (int32_t i = biphase_start; i < signal_end; ++i) {
-        int32_t signal_index = i - biphase_start;
-        if (signal_index < static_cast<int32_t>(biphase_signal.size())) {
-            line_buffer[i] = biphase_signal[signal_index];
-        }
+    // VITC replaces VITS, as in encode_vbi_line()
+    if (!is_vits_enabled() && vitc_enabled_ && vitc_generator_) {
+        // Consumer tape VITC placement: lines 19 and 21 (0-indexed 18,20)
+        uint16_t* vitc_lines[] = {field.line_data(18), field.line_data(20)};
+        int32_t total_frame = vitc_start_frame_offset_ + (field_number / 2);
+        vitc_generator_->generate_lines(VideoSystem::PAL, total_frame, vitc_lines, 2, !is_first_field);
     }
 }
 
 void PALEncoder::encode_frame_yc(const FrameBuffer& frame_buffer, int32_t field_number,
                                  Field& y_field1, Field& c_field1,
                                  Field& y_field2, Field& c_field2,
-                                 const VBIData* vbi_data) {
-    // Initialize fields
-    y_field1.resize(params_.field_width, params_.field_height);
-    c_field1.resize(params_.field_width, params_.field_height);
-    y_field2.resize(params_.field_width, params_.field_height);
-    c_field2.resize(params_.field_width, params_.field_height);
+                                 const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
     
     // For separate Y/C output, we encode Y and C directly from source YUV data:
     // Y field: luma component with sync + blanking (no chroma modulation)
-    // C field: chroma-only signal (modulated subcarrier centered at blanking level)
+    // C field: chroma-only signal (modulated subcarrier centered at 32768)
     //
-    // This is NOT created by decomposing composite - we build Y and C separately
-    // from the source YUV to avoid any quality loss.
+    // This is NOT created by decomposing composite - both come from the same
+    // filtered, resampled source line as the composite path.
+    encode_field_yc(frame_buffer, field_number, true, y_field1, c_field1, vbi_field1);
+    encode_field_yc(frame_buffer, field_number + 1, false, y_field2, c_field2, vbi_field2);
+}
+
+void PALEncoder::encode_field_yc(const FrameBuffer& frame_buffer, int32_t field_number,
+                                 bool is_first_field, Field& y_field, Field& c_field,
+                                 const VBIData* vbi_data) {
+    y_field.resize(params_.field_width, params_.field_height);
+    c_field.resize(params_.field_width, params_.field_height);
     
     // Get frame dimensions
     int32_t frame_width = frame_buffer.width();
@@ -556,281 +569,120 @@ void PALEncoder::encode_frame_yc(const FrameBuffer& frame_buffer, int32_t field_
     const uint16_t* u_plane = frame_data + pixel_count;
     const uint16_t* v_plane = frame_data + pixel_count * 2;
 
-    // Detect studio-range input (≤1023) to preserve sub-black
-    uint16_t y_max = 0;
-    for (int32_t i = 0; i < pixel_count; ++i) {
-        if (y_plane[i] > y_max) y_max = y_plane[i];
-    }
-    const bool studio_range_input = (y_max <= 1023);
+    // Studio-range input (≤1023) preserves sub-black
+    const bool studio_range_input = frame_buffer.is_studio_range();
     
-    // For separate Y/C encoding, we use the source data directly
-    // (filters are applied during composite encoding, but for Y/C we skip filtering
-    // to avoid complexity with line-by-line processing)
-    
-    // Process field 1 (even lines from source)
+    // Sync, blanking, and VBI lines, and post-active blanking
     for (int32_t line = 0; line < params_.field_height; ++line) {
-        uint16_t* y_line = y_field1.line_data(line);
-        uint16_t* c_line = c_field1.line_data(line);
+        uint16_t* y_line = y_field.line_data(line);
+        uint16_t* c_line = c_field.line_data(line);
         
-        // For sync, blanking, and VBI lines
         if (line < ACTIVE_LINES_START) {
-            // Initialize Y field with blanking level
-            generate_blanking_line(y_line);
-            
-            // Generate sync for Y field (no color burst)
-            generate_sync_pulse(y_line, line);
-            
-            // C field gets color burst (modulated at blanking level, centered at 32768)
-            generate_color_burst_chroma(c_line, line, field_number);
-            
-            // Handle VBI lines if enabled
-            if (vbi_data != nullptr && (line == 15 || line == 16 || line == 17)) {
-                int32_t vbi_value = 0;
-                if (line == 15) vbi_value = vbi_data->vbi0;
-                else if (line == 16) vbi_value = vbi_data->vbi1;
-                else if (line == 17) vbi_value = vbi_data->vbi2;
-                generate_biphase_vbi_line(y_line, line, field_number, vbi_value);
-            }
-            // VITS lines for field 1 (if enabled)
-            else if (vits_enabled_ && vits_generator_) {
-                // First field VITS lines (0-indexed in field)
-                if (line == 18) {  // Line 332 in PAL frame (odd-first field parity)
-                    vits_generator_->generate_uk_national(y_line, field_number);
-                }
-                else if (line == 19) {  // Line 333 in PAL frame
-                    vits_generator_->generate_multiburst(y_line, field_number);
-                }
-                else {
-                    // Other VBI lines - regular blanking
-                }
-                
-                // For C field during VITS lines, set to neutral (no chroma modulation)
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
-            else if (vitc_enabled_ && vitc_generator_) {
-                if (line == 18 || line == 20) {
-                    int32_t total_frame = vitc_start_frame_offset_ + (field_number / 2);
-                    vitc_generator_->generate_line(VideoSystem::PAL, total_frame, y_line, line, false);
-                }
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
-
-            // Ensure no color burst appears in luma during VITS/VBI lines
-            const int32_t burst_start = params_.colour_burst_start;
-            const int32_t burst_end = params_.colour_burst_end;
-            for (int32_t s = burst_start; s < burst_end && s < params_.field_width; ++s) {
-                y_line[s] = static_cast<uint16_t>(blanking_level_);
-            }
+            encode_vbi_line_yc(y_line, c_line, line, field_number, is_first_field, vbi_data);
         } else if (line >= ACTIVE_LINES_END) {
-            // Post-active blanking
-            generate_blanking_line(y_line);
-            generate_color_burst_chroma(c_line, line, field_number);
-        } else {
-            // Active video line - encode Y and C separately from source
-            int32_t source_line = (line - ACTIVE_LINES_START) * 2;  // Even lines for field 1
-            if (source_line >= frame_height) source_line = frame_height - 1;
-            
-            // Initialize Y field with blanking (same as composite)
             generate_blanking_line(y_line);
-            
-            // Generate sync for Y field (no color burst in Y)
-            generate_sync_pulse(y_line, line);
-            
-            // C field gets color burst during sync/burst period
-            generate_color_burst_chroma_line(c_line, line, field_number, params_.active_video_start);
-            
-            // Encode active video portion
-            int32_t active_start = params_.active_video_start;
-            int32_t active_end = params_.active_video_end;
-            int32_t active_width = active_end - active_start;
-            
-            // Calculate PAL phase parameters for this line
-            bool is_first_field = (field_number % 2) == 0;
-            int32_t frame_line = is_first_field ? (line * 2 + 1) : (line * 2 + 2);
-            int32_t field_id = field_number % 8;
-            int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-            int32_t v_switch = (prev_lines % 2 == 0) ? 1 : -1;
-            double prev_cycles = prev_lines * 283.7516;
-            
-            for (int32_t sample = active_start; sample < active_end; ++sample) {
-                // Map sample position to source pixel
-                double pixel_pos = static_cast<double>(sample - active_start) * frame_width / active_width;
-                int32_t pixel_x = static_cast<int32_t>(pixel_pos);
-                if (pixel_x >= frame_width) pixel_x = frame_width - 1;
-                
-                // Get filtered YUV values from source
-                uint16_t y_val = y_plane[source_line * frame_width + pixel_x];
-                uint16_t u_val = u_plane[source_line * frame_width + pixel_x];
-                uint16_t v_val = v_plane[source_line * frame_width + pixel_x];
-                
-                // Convert Y to luma signal level
-                int32_t luma_range = white_level_ - black_level_;
-                int32_t y_signal;
-                if (studio_range_input) {
-                    // Studio codes: 64 -> black_level_, 940 -> white_level_, sub-black allowed
-                    int32_t y_delta = static_cast<int32_t>(y_val) - 64;   // can be negative
-                    y_signal = black_level_ + (y_delta * luma_range) / 876; // 940-64=876
-                } else {
-                    // Full-range input
-                    double y_norm = static_cast<double>(y_val) / 65535.0;
-                    y_signal = black_level_ + static_cast<int32_t>(y_norm * luma_range);
-                }
-
-                // Convert U/V to chroma signal
-                const double U_MAX = 0.436010;
-                const double V_MAX = 0.614975;
-                double u_norm = studio_range_input
-                               ? (static_cast<double>(static_cast<int32_t>(u_val) - 512) / 448.0) * U_MAX
-                               : ((static_cast<double>(u_val) / 65535.0 - 0.5) * 2.0 * U_MAX);
-                double v_norm = studio_range_input
-                               ? (static_cast<double>(static_cast<int32_t>(v_val) - 512) / 448.0) * V_MAX
-                               : ((static_cast<double>(v_val) / 65535.0 - 0.5) * 2.0 * V_MAX);
-                
-                // Calculate subcarrier phase
-                double t = static_cast<double>(sample) / sample_rate_;
-                double phase = 2.0 * PI * (subcarrier_freq_ * t + prev_cycles);
-                
-                // Modulate chroma onto subcarrier (PAL encoding)
-                double chroma = (u_norm * std::sin(phase)) + (v_norm * v_switch * std::cos(phase));
-                int32_t chroma_signal = static_cast<int32_t>(chroma * luma_range);
-                
-                // Y field: luma only (no chroma)
-                y_line[sample] = clamp_to_16bit(y_signal);
-                
-                // C field: chroma only (centered at 16-bit midpoint, no luma)
-                c_line[sample] = clamp_to_16bit(32768 + chroma_signal);
-            }
-            
-            // Fill remaining samples with blanking
-            for (int32_t sample = active_end; sample < params_.field_width; ++sample) {
-                // Y keeps its blanking level, C gets 16-bit center
-                c_line[sample] = static_cast<uint16_t>(32768);
-            }
+            chroma_templates_->copy(c_line, line, field_number);
         }
     }
     
-    // Process field 2 (odd lines from source)
-    for (int32_t line = 0; line < params_.field_height; ++line) {
-        uint16_t* y_line = y_field2.line_data(line);
-        uint16_t* c_line = c_field2.line_data(line);
+    encode_active_lines(field_number, frame_width, [&](int32_t line) {
+        uint16_t* y_line = y_field.line_data(line);
+        uint16_t* c_line = c_field.line_data(line);
         
-        if (line < ACTIVE_LINES_START) {
-            // Initialize Y field with blanking level
-            generate_blanking_line(y_line);
-            
-            // Generate sync for Y field (no color burst)
-            generate_sync_pulse(y_line, line);
-            
-            // C field gets color burst (centered at 32768)
-            generate_color_burst_chroma(c_line, line, field_number + 1);
-            
-            if (vbi_data != nullptr && (line == 15 || line == 16 || line == 17)) {
-                int32_t vbi_value = 0;
-                if (line == 15) vbi_value = vbi_data->vbi0;
-                else if (line == 16) vbi_value = vbi_data->vbi1;
-                else if (line == 17) vbi_value = vbi_data->vbi2;
-                generate_biphase_vbi_line(y_line, line, field_number + 1, vbi_value);
-            }
-            // VITS lines for field 2 (if enabled)
-            else if (vits_enabled_ && vits_generator_) {
-                // Second field VITS lines (0-indexed in field)
-                if (line == 11) {  // Line 12 in PAL frame
-                    vits_generator_->generate_itu_composite(y_line, field_number + 1);
-                }
-                else if (line == 19) {  // Line 20 in PAL frame
-                    vits_generator_->generate_itu_its(y_line, field_number + 1);
-                }
-                else {
-                    // Other VBI lines - regular blanking
-                }
-                
-                // For C field during VITS lines, set to neutral (no chroma modulation)
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
-            else if (vitc_enabled_ && vitc_generator_) {
-                if (line == 18 || line == 20) {
-                    int32_t total_frame = vitc_start_frame_offset_ + ((field_number + 1) / 2);
-                    vitc_generator_->generate_line(VideoSystem::PAL, total_frame, y_line, line, true);
-                }
-                std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
-            }
-
-            // Ensure no color burst appears in luma during VITS/VBI lines
-            const int32_t burst_start = params_.colour_burst_start;
-            const int32_t burst_end = params_.colour_burst_end;
-            for (int32_t s = burst_start; s < burst_end && s < params_.field_width; ++s) {
-                y_line[s] = static_cast<uint16_t>(blanking_level_);
-            }
-        } else if (line >= ACTIVE_LINES_END) {
-            generate_blanking_line(y_line);
-            generate_color_burst_chroma(c_line, line, field_number + 1);
-        } else {
-            int32_t source_line = (line - ACTIVE_LINES_START) * 2 + 1;  // Odd lines for field 2
-            if (source_line >= frame_height) source_line = frame_height - 1;
-            
-            // Initialize Y field with blanking (same as composite)
-            generate_blanking_line(y_line);
-            
-            // Generate sync for Y field (no color burst in Y)
-            generate_sync_pulse(y_line, line);
-            
-            // C field gets color burst during sync/burst period
-            generate_color_burst_chroma_line(c_line, line, field_number + 1, params_.active_video_start);
-            
-            int32_t active_start = params_.active_video_start;
-            int32_t active_end = params_.active_video_end;
-            int32_t active_width = active_end - active_start;
-            
-            bool is_first_field = ((field_number + 1) % 2) == 0;
-            int32_t frame_line = is_first_field ? (line * 2 + 1) : (line * 2 + 2);
-            int32_t field_id = (field_number + 1) % 8;
-            int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-            int32_t v_switch = (prev_lines % 2 == 0) ? 1 : -1;
-            double prev_cycles = prev_lines * 283.7516;
-            
-            for (int32_t sample = active_start; sample < active_end; ++sample) {
-                double pixel_pos = static_cast<double>(sample - active_start) * frame_width / active_width;
-                int32_t pixel_x = static_cast<int32_t>(pixel_pos);
-                if (pixel_x >= frame_width) pixel_x = frame_width - 1;
-                
-                uint16_t y_val = y_plane[source_line * frame_width + pixel_x];
-                uint16_t u_val = u_plane[source_line * frame_width + pixel_x];
-                uint16_t v_val = v_plane[source_line * frame_width + pixel_x];
-
-                int32_t luma_range = white_level_ - black_level_;
-                int32_t y_signal;
-                if (studio_range_input) {
-                    int32_t y_delta = static_cast<int32_t>(y_val) - 64;
-                    y_signal = black_level_ + (y_delta * luma_range) / 876; // 940-64
-                } else {
-                    double y_norm = static_cast<double>(y_val) / 65535.0;
-                    y_signal = black_level_ + static_cast<int32_t>(y_norm * luma_range);
-                }
+        // Even source lines for the first field, odd for the second
+        int32_t source_line = (line - ACTIVE_LINES_START) * 2 + (is_first_field ? 0 : 1);
+        if (source_line >= frame_height) source_line = frame_height - 1;
+        
+        // Initialize Y field with blanking (same as composite)
+        generate_blanking_line(y_line);
+        
+        // Generate sync for Y field (no color burst in Y)
+        generate_sync_pulse(y_line, line);
+        
+        // C field gets color burst during sync/burst period
+        chroma_templates_->copy(c_line, line, field_number);
+        
+        // Encode active video portion
+        size_t offset = static_cast<size_t>(source_line) * frame_width;
+        encode_active_line_yc(y_line, c_line, y_plane + offset, u_plane + offset, v_plane + offset,
+                              line, field_number, frame_width, studio_range_input);
+        
+        // Y keeps its blanking level after active video, C gets 16-bit center
+        std::fill(c_line + params_.active_video_end, c_line + params_.field_width,
+                  static_cast<uint16_t>(32768));
+    });
+    
+    encode_data_lines(y_field, field_number, is_first_field, vbi_data);
+}
 
-                const double U_MAX = 0.436010;
-                const double V_MAX = 0.614975;
-                double u_norm = studio_range_input
-                               ? (static_cast<double>(static_cast<int32_t>(u_val) - 512) / 448.0) * U_MAX
-                               : ((static_cast<double>(u_val) / 65535.0 - 0.5) * 2.0 * U_MAX);
-                double v_norm = studio_range_input
-                               ? (static_cast<double>(static_cast<int32_t>(v_val) - 512) / 448.0) * V_MAX
-                               : ((static_cast<double>(v_val) / 65535.0 - 0.5) * 2.0 * V_MAX);
-                
-                double t = static_cast<double>(sample) / sample_rate_;
-                double phase = 2.0 * PI * (subcarrier_freq_ * t + prev_cycles);
-                
-                double chroma = (u_norm * std::sin(phase)) + (v_norm * v_switch * std::cos(phase));
-                int32_t chroma_signal = static_cast<int32_t>(chroma * luma_range);
-                
-                y_line[sample] = clamp_to_16bit(y_signal);
-                c_line[sample] = clamp_to_16bit(32768 + chroma_signal);
-            }
-            
-            for (int32_t sample = active_end; sample < params_.field_width; ++sample) {
-                c_line[sample] = static_cast<uint16_t>(32768);
-            }
+void PALEncoder::encode_vbi_line_yc(uint16_t* y_line, uint16_t* c_line, int32_t line,
+                                    int32_t field_number, bool is_first_field,
+                                    const VBIData* vbi_data) {
+    // Initialize Y field with blanking level
+    generate_blanking_line(y_line);
+    
+    // Generate sync for Y field (no color burst)
+    generate_sync_pulse(y_line, line);
+    
+    // C field gets color burst (modulated at blanking level, centered at 32768)
+    chroma_templates_->copy(c_line, line, field_number);
+    
+    // Handle VBI lines if enabled
+    if (vbi_data != nullptr && (line == 15 || line == 16 || line == 17)) {
+        // Composite blanking underneath; the codes are drawn on Y by encode_data_lines()
+        line_templates_->copy(y_line, line, field_number);
+    }
+    // VITS lines (if enabled)
+    else if (vits_enabled_ && vits_generator_) {
+        // First field VITS lines (0-indexed in field)
+        if (is_first_field && line == 18) {  // Line 332 in PAL frame (odd-first field parity)
+            vits_generator_->generate_uk_national(y_line, field_number);
         }
+        else if (is_first_field && line == 19) {  // Line 333 in PAL frame
+            vits_generator_->generate_multiburst(y_line, field_number);
+        }
+        // Second field VITS lines (0-indexed in field)
+        else if (!is_first_field && line == 11) {  // Line 12 in PAL frame
+            vits_generator_->generate_itu_composite(y_line, field_number);
+        }
+        else if (!is_first_field && line == 19) {  // Line 20 in PAL frame
+            vits_generator_->generate_itu_its(y_line, field_number);
+        }
+        else {
+            // Other VBI lines - regular blanking
+        }
+        
+        // For C field during VITS lines, set to neutral (no chroma modulation)
+        std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
+    }
+    else if (vitc_enabled_ && vitc_generator_) {
+        // VITC on luma is drawn by encode_data_lines()
+        std::fill_n(c_line, params_.field_width, static_cast<uint16_t>(32768));
+    }
+
+    // Ensure no color burst appears in luma during VITS/VBI lines
+    const int32_t burst_start = params_.colour_burst_start;
+    const int32_t burst_end = params_.colour_burst_end;
+    for (int32_t s = burst_start; s < burst_end && s < params_.field_width; ++s) {
+        y_line[s] = static_cast<uint16_t>(blanking_level_);
+    }
+}
+
+void PALEncoder::refresh_data_lines_yc(int32_t field_number,
+                                       Field& y_field1, Field& c_field1,
+                                       Field& y_field2, Field& c_field2,
+                                       const FrameVBI* frame_vbi) {
+    const VBIData* vbi_field1 = frame_vbi ? &frame_vbi->field1 : nullptr;
+    const VBIData* vbi_field2 = frame_vbi ? &frame_vbi->field2 : nullptr;
+    
+    for (int32_t line : {15, 16, 17, 18, 20}) {
+        encode_vbi_line_yc(y_field1.line_data(line), c_field1.line_data(line), line,
+                           field_number, true, vbi_field1);
+        encode_vbi_line_yc(y_field2.line_data(line), c_field2.line_data(line), line,
+                           field_number + 1, false, vbi_field2);
     }
+    encode_data_lines(y_field1, field_number, true, vbi_field1);
+    encode_data_lines(y_field2, field_number + 1, false, vbi_field2);
 }
 
 } // namespace encode_orc
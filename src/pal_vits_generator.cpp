@@ -16,7 +16,18 @@
 namespace encode_orc {
 
 PALVITSGenerator::PALVITSGenerator(const VideoParameters& params)
-    : params_(params) {
+    : params_(params),
+      subcarrier_(SubcarrierTable::for_parameters(params)),
+      lines_(params.field_width, NUM_SIGNALS, subcarrier_->sequence_fields(),
+             [this](int32_t signal, uint16_t* line_buffer, int32_t field_number) {
+                 switch (signal) {
+                     case ITU_COMPOSITE: render_itu_composite(line_buffer, field_number); break;
+                     case UK_NATIONAL: render_uk_national(line_buffer, field_number); break;
+                     case ITU_ITS: render_itu_its(line_buffer, field_number); break;
+                     case MULTIBURST: render_multiburst(line_buffer, field_number); break;
+                     default: break;
+                 }
+             }) {
     
     // Set signal levels
     sync_level_ = 0x0000;  // Sync tip at 0 IRE (0V)
@@ -50,34 +61,6 @@ int32_t PALVITSGenerator::ire_to_sample(double ire) const {
     }
 }
 
-double PALVITSGenerator::calculate_phase(int32_t field_number, int32_t line_number, int32_t sample) const {
-    // Calculate absolute line number in PAL 8-field sequence
-    bool is_first_field = (field_number % 2) == 0;
-    int32_t frame_line = is_first_field ? (line_number * 2 + 1) : (line_number * 2 + 2);
-    
-    int32_t field_id = field_number % 8;
-    int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-    
-    // PAL: 283.7516 subcarrier cycles per line
-    double prev_cycles = prev_lines * 283.7516;
-    
-    // Phase for this sample
-    double time_phase = 2.0 * PI * subcarrier_freq_ * sample / sample_rate_;
-    return 2.0 * PI * prev_cycles + time_phase;
-}
-
-int32_t PALVITSGenerator::get_v_switch(int32_t field_number, int32_t line_number) const {
-    // Calculate absolute line number
-    bool is_first_field = (field_number % 2) == 0;
-    int32_t frame_line = is_first_field ? (line_number * 2 + 1) : (line_number * 2 + 2);
-    
-    int32_t field_id = field_number % 8;
-    int32_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
-    
-    // V-switch alternates every line
-    return (prev_lines % 2) == 0 ? 1 : -1;
-}
-
 void PALVITSGenerator::generate_sync_pulse(uint16_t* line_buffer) {
     // PAL horizontal sync: 4.7 µs
     int32_t sync_samples = static_cast<int32_t>(4.7 * samples_per_us_);
@@ -89,7 +72,7 @@ void PALVITSGenerator::generate_sync_pulse(uint16_t* line_buffer) {
 
 void PALVITSGenerator::generate_color_burst(uint16_t* line_buffer, int32_t field_number, int32_t line_number) {
     // Delegate to shared color burst generator
-    ColorBurstGenerator burst_gen(params_);
+    ColorBurstGenerator burst_gen(params_, *subcarrier_);
     int32_t luma_range = white_level_ - blanking_level_;
     int32_t burst_amplitude = static_cast<int32_t>((3.0 / 14.0) * luma_range);
     burst_gen.generate_pal_burst(line_buffer, line_number, field_number, blanking_level_, burst_amplitude);
@@ -149,11 +132,10 @@ void PALVITSGenerator::generate_10t_pulse(uint16_t* line_buffer, double center_t
     int32_t blanking = ire_to_sample(0.0);
     int32_t peak_level = ire_to_sample(peak_ire);
     int32_t amplitude = (peak_level - blanking) / 2;  // Half for modulation
+    const SubcarrierTable::LinePhase line_phase = subcarrier_->line_phase(field_number, line_number);
     
     // Generate 10 cycles of subcarrier with triangular envelope
     for (int32_t sample = start_sample; sample < end_sample && sample < params_.field_width; ++sample) {
-        double phase = calculate_phase(field_number, line_number, sample);
-        
         // Apply triangular envelope
         double envelope;
         if (sample < center_sample) {
@@ -168,7 +150,7 @@ void PALVITSGenerator::generate_10t_pulse(uint16_t* line_buffer, double center_t
         if (envelope < 0.0) envelope = 0.0;
         if (envelope > 1.0) envelope = 1.0;
         
-        double chroma_signal = std::sin(phase);
+        double chroma_signal = subcarrier_->sin_at(line_phase, sample);
         int32_t value = blanking + static_cast<int32_t>(amplitude * envelope * (1.0 + chroma_signal));
         line_buffer[sample] = clamp_to_16bit(value);
     }
@@ -179,8 +161,10 @@ void PALVITSGenerator::generate_modulated_staircase(uint16_t* line_buffer, doubl
                                                     int num_steps, double chroma_amplitude, double chroma_phase,
                                                     int32_t field_number, int32_t line_number) {
     // Generate staircase with modulated chroma
-    int32_t v_switch = get_v_switch(field_number, line_number);
     double phase_offset = chroma_phase * PI / 180.0;  // Convert degrees to radians
+    const SubcarrierTable::LinePhase line_phase = subcarrier_->line_phase(field_number, line_number)
+                                                      .shifted(std::sin(phase_offset), std::cos(phase_offset));
+    const int32_t v_switch = line_phase.v_switch;
     
     for (int step = 0; step < num_steps - 1; ++step) {
         double step_start = step_times[step];
@@ -208,9 +192,8 @@ void PALVITSGenerator::generate_modulated_staircase(uint16_t* line_buffer, doubl
             }
             
             // Calculate chroma with V-switch and phase offset
-            double phase = calculate_phase(field_number, line_number, sample) + phase_offset;
-            double u_chroma = std::cos(phase);
-            double v_chroma = v_switch * std::sin(phase);
+            double u_chroma = subcarrier_->cos_at(line_phase, sample);
+            double v_chroma = v_switch * subcarrier_->sin_at(line_phase, sample);
             double chroma = (u_chroma + v_chroma) / std::sqrt(2.0);  // Simplified for 60° phase
             
             int32_t value = luma_level + static_cast<int32_t>(chroma_amp * envelope * chroma);
@@ -229,8 +212,10 @@ void PALVITSGenerator::generate_modulated_pedestal(uint16_t* line_buffer, double
     int32_t high_level = ire_to_sample(luma_high);
     int32_t pedestal = (low_level + high_level) / 2;
     
-    int32_t v_switch = get_v_switch(field_number, line_number);
     double phase_offset = chroma_phase * PI / 180.0;
+    const SubcarrierTable::LinePhase line_phase = subcarrier_->line_phase(field_number, line_number)
+                                                  .shifted(std::sin(phase_offset), std::cos(phase_offset));
+    const int32_t v_switch = line_phase.v_switch;
     
     int32_t chroma_amp = static_cast<int32_t>((chroma_pp / 100.0) * (white_level_ - blanking_level_) / 2.0);
     
@@ -248,9 +233,8 @@ void PALVITSGenerator::generate_modulated_pedestal(uint16_t* line_buffer, double
             envelope = 0.5 * (1.0 - std::cos(PI * t_from_end / 1.0));
         }
         
-        double phase = calculate_phase(field_number, line_number, sample) + phase_offset;
-        double u_chroma = std::cos(phase);
-        double v_chroma = v_switch * std::sin(phase);
+        double u_chroma = subcarrier_->cos_at(line_phase, sample);
+        double v_chroma = v_switch * subcarrier_->sin_at(line_phase, sample);
         double chroma = (u_chroma + v_chroma) / std::sqrt(2.0);
         
         int32_t value = pedestal + static_cast<int32_t>(chroma_amp * envelope * chroma);
@@ -284,6 +268,22 @@ void PALVITSGenerator::generate_multiburst_packet(uint16_t* line_buffer, double
 // ============================================================================
 
 void PALVITSGenerator::generate_itu_composite(uint16_t* line_buffer, int32_t field_number) {
+    lines_.draw(ITU_COMPOSITE, line_buffer, field_number);
+}
+
+void PALVITSGenerator::generate_uk_national(uint16_t* line_buffer, int32_t field_number) {
+    lines_.draw(UK_NATIONAL, line_buffer, field_number);
+}
+
+void PALVITSGenerator::generate_itu_its(uint16_t* line_buffer, int32_t field_number) {
+    lines_.draw(ITU_ITS, line_buffer, field_number);
+}
+
+void PALVITSGenerator::generate_multiburst(uint16_t* line_buffer, int32_t field_number) {
+    lines_.draw(MULTIBURST, line_buffer, field_number);
+}
+
+void PALVITSGenerator::render_itu_composite(uint16_t* line_buffer, int32_t field_number) {
     // ITU Composite Test Signal for PAL (Figure 8.41) - Line 12
     // Components:
     // - White flag: 100 IRE, 10 µs (12-22 µs)
@@ -317,7 +317,7 @@ void PALVITSGenerator::generate_itu_composite(uint16_t* line_buffer, int32_t fie
     generate_flat_level(line_buffer, 60.0, 62.0, 100.0);
 }
 
-void PALVITSGenerator::generate_uk_national(uint16_t* line_buffer, int32_t field_number) {
+void PALVITSGenerator::render_uk_national(uint16_t* line_buffer, int32_t field_number) {
     // UK PAL National Test Signal #1 (Figure 8.42) - Line 332
     // Components:
     // - White flag: 100 IRE, 10 µs (12-22 µs)
@@ -349,7 +349,7 @@ void PALVITSGenerator::generate_uk_national(uint16_t* line_buffer, int32_t field
                                 21.43, 60.0, field_number, 332);
 }
 
-void PALVITSGenerator::generate_itu_its(uint16_t* line_buffer, int32_t field_number) {
+void PALVITSGenerator::render_itu_its(uint16_t* line_buffer, int32_t field_number) {
     // ITU Combination ITS Test Signal (Figure 8.45) - Line 20
     // Components:
     // - 3-step modulated pedestal: 20, 60, 100 IRE peak-to-peak (14-28 µs)
@@ -383,7 +383,7 @@ void PALVITSGenerator::generate_itu_its(uint16_t* line_buffer, int32_t field_num
     generate_flat_level(line_buffer, 61.0, 64.0, 0.0);
 }
 
-void PALVITSGenerator::generate_multiburst(uint16_t* line_buffer, int32_t field_number) {
+void PALVITSGenerator::render_multiburst(uint16_t* line_buffer, int32_t field_number) {
     // ITU Multiburst Test Signal (Figure 8.38) - Line 333
     // Components:
     // - White flag: 80 IRE, 4 µs
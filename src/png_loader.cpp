@@ -216,6 +216,7 @@ bool PNGLoader::load_frames(int32_t start_frame,
                             cached_frame_);
             // Frame is now in normalized studio range (Y:64-940, U/V:0-896)
             // No additional luma remapping needed; downstream encoder expects this range
+            cached_frame_.update_signal_range();
             frame_loaded_ = true;
         } catch (const std::exception& e) {
             error_message = std::string("Error loading PNG file: ") + e.what();
@@ -0,0 +1,92 @@
+/*
+ * File:        subcarrier_table.cpp
+ * Module:      encode-orc
+ * Purpose:     Precomputed colour subcarrier phase for PAL and NTSC
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "subcarrier_table.h"
+#include <cmath>
+#include <mutex>
+
+namespace encode_orc {
+
+namespace {
+
+constexpr double PI = 3.141592653589793238463;
+
+// PAL: 283.7516 cycles per line = 709379 / 2500
+constexpr int64_t PAL_CYCLE_STEPS = 2500;
+constexpr int64_t PAL_STEPS_PER_LINE = 709379 % PAL_CYCLE_STEPS;
+
+// NTSC: 227.5 cycles per line and 262.5 lines per field, counted in
+// half-lines (455 / 4 cycles each)
+constexpr int64_t NTSC_CYCLE_STEPS = 4;
+constexpr int64_t NTSC_STEPS_PER_HALF_LINE = 455 % NTSC_CYCLE_STEPS;
+
+} // namespace
+
+SubcarrierTable::SubcarrierTable(const VideoParameters& params)
+    : params_(params),
+      pal_(params.system == VideoSystem::PAL),
+      sequence_fields_(pal_ ? 8 : 4) {
+    const int64_t cycle_steps = pal_ ? PAL_CYCLE_STEPS : NTSC_CYCLE_STEPS;
+    cycle_sin_.resize(cycle_steps);
+    cycle_cos_.resize(cycle_steps);
+    for (int64_t k = 0; k < cycle_steps; ++k) {
+        double phase = 2.0 * PI * static_cast<double>(k) / static_cast<double>(cycle_steps);
+        cycle_sin_[k] = std::sin(phase);
+        cycle_cos_[k] = std::cos(phase);
+    }
+
+    // Only the fractional cycles matter, so reduce before taking sin/cos
+    const double cycles_per_sample = params_.fSC / params_.sample_rate;
+    sample_sin_.resize(params_.field_width);
+    sample_cos_.resize(params_.field_width);
+    for (int32_t s = 0; s < params_.field_width; ++s) {
+        double cycles = static_cast<double>(s) * cycles_per_sample;
+        double phase = 2.0 * PI * (cycles - std::floor(cycles));
+        sample_sin_[s] = std::sin(phase);
+        sample_cos_[s] = std::cos(phase);
+    }
+}
+
+std::shared_ptr<const SubcarrierTable> SubcarrierTable::for_parameters(const VideoParameters& params) {
+    static std::mutex mutex;
+    static std::vector<std::shared_ptr<const SubcarrierTable>> tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& table : tables) {
+        if (table->matches(params)) {
+            return table;
+        }
+    }
+    tables.push_back(std::make_shared<const SubcarrierTable>(params));
+    return tables.back();
+}
+
+SubcarrierTable::LinePhase SubcarrierTable::line_phase(int32_t field_number, int32_t line_number) const {
+    const int64_t field_id = field_number % sequence_fields_;
+    LinePhase phase;
+    int64_t step;
+
+    if (pal_) {
+        // Lines since the start of the 8-field sequence, following
+        // ld-chroma-encoder [palencoder.cpp:186-188]
+        int64_t frame_line = (field_id % 2 == 0) ? (line_number * 2 + 1) : (line_number * 2 + 2);
+        int64_t prev_lines = ((field_id / 2) * 625) + ((field_id % 2) * 313) + (frame_line / 2);
+        step = (prev_lines % PAL_CYCLE_STEPS) * PAL_STEPS_PER_LINE % PAL_CYCLE_STEPS;
+        phase.v_switch = (prev_lines % 2 == 0) ? 1 : -1;
+    } else {
+        int64_t half_lines = field_id * 525 + static_cast<int64_t>(line_number) * 2;
+        step = (half_lines % NTSC_CYCLE_STEPS) * NTSC_STEPS_PER_HALF_LINE % NTSC_CYCLE_STEPS;
+    }
+
+    phase.sin = cycle_sin_[step];
+    phase.cos = cycle_cos_[step];
+    return phase;
+}
+
+} // namespace encode_orc
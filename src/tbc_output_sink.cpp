@@ -0,0 +1,209 @@
+/*
+ * File:        tbc_output_sink.cpp
+ * Module:      encode-orc
+ * Purpose:     Project output files that encoded sections append to
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "tbc_output_sink.h"
+#include <algorithm>
+
+namespace encode_orc {
+
+std::string TBCOutputSink::yc_base_filename(const std::string& output_filename) {
+    if (output_filename.length() > 4 && output_filename.substr(output_filename.length() - 4) == ".tbc") {
+        return output_filename.substr(0, output_filename.length() - 4);
+    }
+    return output_filename;
+}
+
+std::vector<std::string> TBCOutputSink::filenames_for(const std::string& output_filename,
+                                                      bool separate_yc, bool yc_legacy) {
+    if (!separate_yc) {
+        return {output_filename};
+    }
+    std::string y_filename;
+    std::string c_filename;
+    YCTBCWriter::filenames_for(yc_base_filename(output_filename),
+                               yc_legacy ? YCTBCWriter::NamingMode::LEGACY : YCTBCWriter::NamingMode::MODERN,
+                               y_filename, c_filename);
+    return {y_filename, c_filename};
+}
+
+bool TBCOutputSink::open(const std::string& output_filename, bool separate_yc, bool yc_legacy) {
+    if (!open_files(output_filename, separate_yc, yc_legacy, -1)) {
+        return false;
+    }
+    fields_written_ = 0;
+    first_field_ = 0;
+    synced_field_offset_ = 0;
+    return true;
+}
+
+bool TBCOutputSink::open_section(const std::string& output_filename, bool separate_yc, bool yc_legacy,
+                                 int64_t first_field, int64_t field_bytes) {
+    if (!open_files(output_filename, separate_yc, yc_legacy, first_field * field_bytes)) {
+        return false;
+    }
+    fields_written_ = first_field;
+    first_field_ = first_field;
+    field_bytes_ = field_bytes;
+    synced_field_offset_ = first_field;
+    return true;
+}
+
+bool TBCOutputSink::reserve(int64_t file_bytes) {
+    if (separate_yc_) {
+        if (!yc_writer_) {
+            error_message_ = "Output files are not open";
+            return false;
+        }
+        for (TBCWriter* writer : {yc_writer_->y_writer(), yc_writer_->c_writer()}) {
+            if (!writer->preallocate(file_bytes)) {
+                error_message_ = writer->error();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (!composite_writer_.preallocate(file_bytes)) {
+        error_message_ = composite_writer_.error();
+        return false;
+    }
+    return true;
+}
+
+bool TBCOutputSink::open_files(const std::string& output_filename, bool separate_yc, bool yc_legacy,
+                               int64_t offset) {
+    close();
+
+    separate_yc_ = separate_yc;
+    filenames_.clear();
+    error_message_.clear();
+    field_bytes_ = 0;
+    next_sync_ = std::chrono::steady_clock::now() + sync_interval_;
+
+    if (!separate_yc_) {
+        const bool opened = offset < 0 ? composite_writer_.open(output_filename)
+                                       : composite_writer_.open_at(output_filename, offset);
+        if (!opened) {
+            error_message_ = "Could not open output file: " + composite_writer_.error();
+            return false;
+        }
+        filenames_.push_back(output_filename);
+        return true;
+    }
+
+    yc_writer_ = std::make_unique<YCTBCWriter>(yc_legacy ? YCTBCWriter::NamingMode::LEGACY
+                                                         : YCTBCWriter::NamingMode::MODERN);
+    std::string base_filename = yc_base_filename(output_filename);
+    const bool opened = offset < 0 ? yc_writer_->open(base_filename)
+                                   : yc_writer_->open_at(base_filename, offset);
+    if (!opened) {
+        error_message_ = "Could not open Y/C output files: " + base_filename;
+        return false;
+    }
+    filenames_.push_back(yc_writer_->y_writer()->filename());
+    filenames_.push_back(yc_writer_->c_writer()->filename());
+    return true;
+}
+
+bool TBCOutputSink::write_frame(const EncodedFrame& frame) {
+    bool ok;
+    if (separate_yc_) {
+        ok = yc_writer_ &&
+             yc_writer_->write_y_field(frame.y_field1) &&
+             yc_writer_->write_c_field(frame.c_field1) &&
+             yc_writer_->write_y_field(frame.y_field2) &&
+             yc_writer_->write_c_field(frame.c_field2);
+    } else {
+        ok = composite_writer_.write_field(frame.composite.field1()) &&
+             composite_writer_.write_field(frame.composite.field2());
+    }
+
+    if (!ok) {
+        // Keep the writer's reason (out of space, I/O error) where there is one
+        error_message_ = "Failed to write output file";
+        for (const TBCWriter* writer : writers()) {
+            if (!writer->error().empty()) {
+                error_message_ = writer->error();
+                break;
+            }
+        }
+        return false;
+    }
+    fields_written_ += 2;
+    if (field_bytes_ == 0) {
+        const Field& field = separate_yc_ ? frame.y_field1 : frame.composite.field1();
+        field_bytes_ = static_cast<int64_t>(field.size() * sizeof(uint16_t));
+    }
+
+    if (sync_interval_.count() > 0 && std::chrono::steady_clock::now() >= next_sync_) {
+        return sync();
+    }
+    return true;
+}
+
+void TBCOutputSink::set_sync_interval(double seconds, SyncCallback callback) {
+    sync_interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(seconds));
+    sync_callback_ = std::move(callback);
+    next_sync_ = std::chrono::steady_clock::now() + sync_interval_;
+}
+
+std::vector<TBCWriter*> TBCOutputSink::writers() {
+    if (yc_writer_) {
+        return {yc_writer_->y_writer(), yc_writer_->c_writer()};
+    }
+    if (composite_writer_.is_open()) {
+        return {&composite_writer_};
+    }
+    return {};
+}
+
+bool TBCOutputSink::sync() {
+    // With direct I/O a partial block can stay buffered, so only whole
+    // fields that reached every file count as synced
+    int64_t synced_bytes = -1;
+    for (TBCWriter* writer : writers()) {
+        if (!writer->sync()) {
+            error_message_ = writer->error();
+            return false;
+        }
+        synced_bytes = synced_bytes < 0 ? writer->flushed() : std::min(synced_bytes, writer->flushed());
+    }
+    if (synced_bytes > 0 && field_bytes_ > 0) {
+        synced_field_offset_ = first_field_ + synced_bytes / field_bytes_;
+    }
+
+    next_sync_ = std::chrono::steady_clock::now() + sync_interval_;
+    if (sync_callback_) {
+        sync_callback_(synced_field_offset_);
+    }
+    return true;
+}
+
+bool TBCOutputSink::close() {
+    bool ok = true;
+    if (yc_writer_) {
+        ok = yc_writer_->close();
+        yc_writer_.reset();
+    }
+    if (composite_writer_.is_open()) {
+        ok = composite_writer_.close() && ok;
+    }
+
+    if (!ok && error_message_.empty()) {
+        error_message_ = "Failed to write output file";
+    }
+    return ok;
+}
+
+bool TBCOutputSink::is_open() const {
+    return separate_yc_ ? (yc_writer_ && yc_writer_->is_open()) : composite_writer_.is_open();
+}
+
+} // namespace encode_orc
@@ -0,0 +1,161 @@
+/*
+ * File:        vbi_schedule.cpp
+ * Module:      encode-orc
+ * Purpose:     On-demand LaserDisc VBI codes for any field of a project
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "vbi_schedule.h"
+#include "biphase_encoder.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace encode_orc {
+
+VBISchedule::VBISchedule(const YAMLProjectConfig& config, VideoSystem system, const OutputPlan& plan)
+    : fps_((system == VideoSystem::PAL) ? 25 : 30) {
+    if (!standard_supports_vbi(config.laserdisc.standard, system)) {
+        return;
+    }
+
+    sections_.reserve(config.sections.size());
+    for (size_t i = 0; i < config.sections.size(); ++i) {
+        const VideoSection& video_section = config.sections[i];
+        const OutputPlan::Extent& extent = plan.section(i);
+        if (extent.field_count == 0) {
+            continue;
+        }
+
+        Section section;
+        section.first_field = extent.first_field;
+        section.field_count = extent.field_count;
+
+        if (video_section.laserdisc) {
+            const auto& laserdisc = *video_section.laserdisc;
+            if (laserdisc.disc_area == "lead-in") {
+                section.disc_area = DiscArea::LeadIn;
+            } else if (laserdisc.disc_area == "lead-out") {
+                section.disc_area = DiscArea::LeadOut;
+            }
+            section.picture_start = laserdisc.picture_start.value_or(0);
+            section.chapter = laserdisc.chapter.value_or(0);
+
+            // Timecode start is HH:MM:SS:FF
+            if (laserdisc.timecode_start && !laserdisc.timecode_start->empty()) {
+                int32_t hh = 0, mm = 0, ss = 0, ff = 0;
+                std::sscanf(laserdisc.timecode_start->c_str(), "%d:%d:%d:%d", &hh, &mm, &ss, &ff);
+                section.has_timecode = true;
+                section.timecode_start = hh * 3600 * fps_ + mm * 60 * fps_ + ss * fps_ + ff;
+            }
+        }
+
+        sections_.push_back(section);
+    }
+}
+
+bool VBISchedule::field_vbi(int64_t field_number, VBIData& vbi) const {
+    const Section* section = find(field_number);
+    if (!section) {
+        return false;
+    }
+    vbi = compute(*section, field_number);
+    return true;
+}
+
+bool VBISchedule::frame_vbi(int64_t field_number, FrameVBI& vbi) const {
+    // A section always holds whole frames
+    const Section* section = find(field_number);
+    if (!section || field_number + 1 >= section->first_field + section->field_count) {
+        return false;
+    }
+    vbi.field1 = compute(*section, field_number);
+    vbi.field2 = compute(*section, field_number + 1);
+    return true;
+}
+
+const VBISchedule::Section* VBISchedule::find(int64_t field_number) const {
+    // Sections are few and sorted, so this costs the same however long the
+    // programme is
+    auto next = std::upper_bound(sections_.begin(), sections_.end(), field_number,
+                                 [](int64_t field, const Section& section) {
+                                     return field < section.first_field;
+                                 });
+    if (next == sections_.begin()) {
+        return nullptr;
+    }
+    const Section& section = *(next - 1);
+    if (field_number >= section.first_field + section.field_count) {
+        return nullptr;
+    }
+    return &section;
+}
+
+VBIData VBISchedule::compute(const Section& section, int64_t field_number) const {
+    const int64_t section_field = field_number - section.first_field;
+    const int32_t section_frame = static_cast<int32_t>(section_field / 2);
+    const bool is_first_field = (section_field % 2) == 0;
+
+    VBIData vbi;
+
+    // Lead-in and lead-out use special codes
+    if (section.disc_area == DiscArea::LeadIn) {
+        vbi.vbi0 = 0x8BA000;  // Lead-in flag set
+        vbi.vbi1 = 0x88FFFF;
+        vbi.vbi2 = 0x88FFFF;
+        return vbi;
+    }
+    if (section.disc_area == DiscArea::LeadOut) {
+        vbi.vbi0 = 0x8F7000;  // Lead-out flag set
+        vbi.vbi1 = 0x80EEEE;
+        vbi.vbi2 = 0x80EEEE;
+        return vbi;
+    }
+
+    // Programme area
+    vbi.vbi0 = 0x87A000;
+    vbi.vbi1 = 0x80DD00;  // No picture number/timecode/chapter
+    vbi.vbi2 = 0x80DD00;
+
+    if (!is_first_field) {
+        // Field 2: chapter number on line 18
+        if (section.chapter > 0) {
+            vbi.vbi2 = 0x800DDD | ((to_bcd(section.chapter) & 0x7F) << 12);
+        }
+        return vbi;
+    }
+
+    // Field 1: picture number or timecode on lines 17/18
+    if (section.picture_start > 0) {
+        uint8_t b0, b1, b2;
+        BiphaseEncoder::encode_cav_picture_number(section.picture_start + section_frame, b0, b1, b2);
+        const int32_t cav = (static_cast<int32_t>(b0) << 16) |
+                            (static_cast<int32_t>(b1) << 8) |
+                            static_cast<int32_t>(b2);
+        vbi.vbi1 = cav;
+        vbi.vbi2 = cav;
+    } else if (section.has_timecode) {
+        // CLV timecode: hours and minutes on lines 17/18, seconds and
+        // picture number on line 16
+        const int32_t total_frame = section.timecode_start + section_frame;
+        const int32_t total_seconds = total_frame / fps_;
+        const int32_t frame_in_second = total_frame % fps_;
+        const int32_t total_minutes = total_seconds / 60;
+
+        const int32_t hh = (total_minutes / 60) % 10;
+        const int32_t mm = total_minutes % 60;
+        const int32_t ss = total_seconds % 60;
+
+        const int32_t x1 = 0x0A + ss / 10;
+        vbi.vbi0 = (0x8 << 20) | (x1 << 16) | (0xE << 12) | ((ss % 10) << 8) | to_bcd(frame_in_second);
+
+        const int32_t timecode = 0xF0DD00 | (to_bcd(hh) << 16) | to_bcd(mm);
+        vbi.vbi1 = timecode;
+        vbi.vbi2 = timecode;
+    }
+
+    return vbi;
+}
+
+} // namespace encode_orc
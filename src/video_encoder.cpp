@@ -8,16 +8,13 @@
  */
 
 #include "video_encoder.h"
-#include "biphase_encoder.h"
+#include "vbi_schedule.h"
 #include "yuv422_loader.h"
 #include "png_loader.h"
 #include "mov_loader.h"
 #include "mp4_loader.h"
-#include "yc_tbc_writer.h"
 #include "logging.h"
 #include <iostream>
-#include <fstream>
-#include <cstdio>
 
 namespace encode_orc {
 
@@ -40,18 +37,14 @@ void VideoEncoder::clear_video_level_overrides() {
     s_white_16b_ire_override = std::nullopt;
 }
 
-bool VideoEncoder::encode_yuv422_image(const std::string& output_filename,
+bool VideoEncoder::encode_yuv422_image(TBCOutputSink& output,
                                        VideoSystem system,
                                        SourceVideoStandard source_standard,
                                        const std::string& yuv422_file,
                                        int32_t num_frames,
-                                       int32_t picture_start,
-                                       int32_t chapter,
-                                       const std::string& timecode_start,
                                        bool enable_chroma_filter,
                                        bool enable_luma_filter,
-                                       bool separate_yc,
-                                       bool yc_legacy) {
+                                       int32_t first_frame) {
     try {
         // Get video parameters for the system
         VideoParameters params;
@@ -86,8 +79,8 @@ bool VideoEncoder::encode_yuv422_image(const std::string& output_filename,
             return false;
         }
         
-        FrameBuffer image_frame;
-        if (!yuv422_loader.load_frame(0, image_frame)) {
+        std::vector<FrameBuffer> image_frames(1);
+        if (!yuv422_loader.load_frame(0, image_frames[0])) {
             error_message_ = "Failed to load YUV422 frame";
             yuv422_loader.close();
             return false;
@@ -98,222 +91,13 @@ bool VideoEncoder::encode_yuv422_image(const std::string& output_filename,
         ENCODE_ORC_LOG_DEBUG("Image: {} ({}x{})", yuv422_file, img_width, img_height);
         ENCODE_ORC_LOG_DEBUG("Field dimensions: {}x{}", params.field_width, params.field_height);
         
-        // Determine whether this standard should carry biphase VBI metadata (for metadata DB only)
-        const bool include_vbi = standard_supports_vbi(source_standard, system);
         yuv422_loader.close();
         
-        // Open TBC file for writing
-        ENCODE_ORC_LOG_DEBUG("Writing TBC file: {}", output_filename);
-        if (separate_yc) {
-            ENCODE_ORC_LOG_DEBUG("  Mode: Separate Y/C");
-        }
-        
-        std::ofstream tbc_file;
-        YCTBCWriter yc_writer(yc_legacy ? YCTBCWriter::NamingMode::LEGACY : YCTBCWriter::NamingMode::MODERN);
-        
-        if (separate_yc) {
-            // For separate Y/C mode, use output_filename as base (don't strip .tbc)
-            // The YCTBCWriter will add .tbcy and .tbcc extensions (or .tbc and _chroma.tbc for legacy)
-            if (!yc_writer.open(output_filename)) {
-                error_message_ = "Failed to open Y/C output files: " + output_filename;
-                return false;
-            }
-        } else {
-            tbc_file.open(output_filename, std::ios::binary);
-            if (!tbc_file) {
-                error_message_ = "Failed to open output file: " + output_filename;
-                return false;
-            }
-        }
-        
-        // Create and initialize metadata BEFORE encoding so we can pass VBI data to encoders
-        int32_t total_fields = num_frames * 2;
-        CaptureMetadata metadata;
-        metadata.initialize(system, total_fields);
-        metadata.video_params = params;
-        metadata.git_branch = "main";
-        metadata.git_commit = "v0.1.0-dev";
-        metadata.capture_notes = "YUV422 raw image from " + yuv422_file;
-        
-        // Add VBI data for each field (frame numbers on lines 16, 17, 18) when the standard allows it
-        if (include_vbi) {
-            metadata.vbi_data.resize(total_fields);
-        }
-        
-        // Determine VBI mode based on which parameter is provided
-        bool use_cav = (picture_start > 0);
-        bool use_clv_chapter = (chapter > 0);
-        bool use_clv_timecode = !timecode_start.empty();
-        
-        // Determine frame rate based on video system
-        int32_t fps = (system == VideoSystem::PAL) ? 25 : 30;
-        
-        // Parse CLV timecode start value (HH:MM:SS:FF format)
-        int32_t timecode_start_frame = 0;
-        if (use_clv_timecode) {
-            int32_t start_hh = 0, start_mm = 0, start_ss = 0, start_ff = 0;
-            int parsed = std::sscanf(timecode_start.c_str(), "%d:%d:%d:%d", 
-                                      &start_hh, &start_mm, &start_ss, &start_ff);
-            if (parsed >= 3) {
-                timecode_start_frame = start_hh * 3600 * fps +
-                                       start_mm * 60 * fps +
-                                       start_ss * fps +
-                                       start_ff;
-            }
-        }
-        
-        if (include_vbi) {
-            for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-                VBIData vbi;
-                
-                if (use_cav) {
-                    vbi.vbi0 = 0x8BA000;
-                    
-                    int32_t picture_number = picture_start + frame_num;
-                    uint8_t vbi_byte0, vbi_byte1, vbi_byte2;
-                    BiphaseEncoder::encode_cav_picture_number(picture_number, vbi_byte0, vbi_byte1, vbi_byte2);
-                    
-                    int32_t cav_picture_number = (static_cast<int32_t>(vbi_byte0) << 16) |
-                                                 (static_cast<int32_t>(vbi_byte1) << 8) |
-                                                 static_cast<int32_t>(vbi_byte2);
-                    
-                    vbi.vbi1 = cav_picture_number;
-                    vbi.vbi2 = cav_picture_number;
-                } else if (use_clv_chapter) {
-                    int32_t chapter_bcd = ((chapter / 10) << 4) | (chapter % 10);
-                    int32_t chapter_code = 0x800DDD | ((chapter_bcd & 0x7F) << 12);
-                    
-                    vbi.vbi1 = chapter_code;
-                    vbi.vbi2 = chapter_code;
-                } else if (use_clv_timecode) {
-                    int32_t total_frame = timecode_start_frame + frame_num;
-                    int32_t total_seconds = total_frame / fps;
-                    int32_t frame_in_second = total_frame % fps;
-                    
-                    int32_t total_minutes = total_seconds / 60;
-                    int32_t total_hours = total_minutes / 60;
-                    
-                    int32_t hh = total_hours % 10;
-                    int32_t mm = total_minutes % 60;
-                    int32_t ss = total_seconds % 60;
-                    
-                    int32_t sec_tens = ss / 10;
-                    int32_t sec_units = ss % 10;
-                    int32_t x1 = 0x0A + sec_tens;
-                    
-                    int32_t pic_tens = frame_in_second / 10;
-                    int32_t pic_units = frame_in_second % 10;
-                    int32_t pic_bcd = (pic_tens << 4) | pic_units;
-                    
-                    vbi.vbi0 = (0x8 << 20) | (x1 << 16) | (0xE << 12) | (sec_units << 8) | pic_bcd;
-                    
-                    int32_t hh_bcd = ((hh / 10) << 4) | (hh % 10);
-                    int32_t mm_bcd = ((mm / 10) << 4) | (mm % 10);
-                    
-                    int32_t timecode = 0xF0DD00 | (hh_bcd << 16) | mm_bcd;
-                    
-                    vbi.vbi1 = timecode;
-                    vbi.vbi2 = timecode;
-                } else {
-                    vbi.vbi1 = 0x88FFFF;
-                    vbi.vbi2 = 0x88FFFF;
-                }
-                
-                metadata.vbi_data[frame_num * 2] = vbi;
-                metadata.vbi_data[frame_num * 2 + 1] = vbi;
-            }
-        }
-        
-        for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-            int32_t field_number = frame_num * 2;
-            
-            // Get VBI data for this frame if available
-            const VBIData* vbi_data = nullptr;
-            if (include_vbi && frame_num * 2 < static_cast<int32_t>(metadata.vbi_data.size()) && 
-                metadata.vbi_data[frame_num * 2].has_value()) {
-                vbi_data = &metadata.vbi_data[frame_num * 2].value();
-            }
-            
-            if (separate_yc) {
-                // Encode with separate Y/C output
-                Field y_field1, c_field1, y_field2, c_field2;
-                
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    pal_encoder.encode_frame_yc(image_frame, field_number,
-                                                y_field1, c_field1, y_field2, c_field2,
-                                                vbi_data);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    ntsc_encoder.encode_frame_yc(image_frame, field_number,
-                                                 y_field1, c_field1, y_field2, c_field2,
-                                                 vbi_data);
-                }
-                
-                // Write Y and C fields
-                yc_writer.write_y_field(y_field1);
-                yc_writer.write_c_field(c_field1);
-                yc_writer.write_y_field(y_field2);
-                yc_writer.write_c_field(c_field2);
-                
-            } else {
-                // Standard composite output
-                Frame encoded_frame;
-                
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    encoded_frame = pal_encoder.encode_frame(image_frame, field_number,
-                                                             vbi_data);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    encoded_frame = ntsc_encoder.encode_frame(image_frame, field_number,
-                                                             vbi_data);
-                }
-                
-                // Write field 1
-                const Field& field1 = encoded_frame.field1();
-                tbc_file.write(reinterpret_cast<const char*>(field1.data().data()),
-                              field1.data().size() * sizeof(uint16_t));
-                
-                // Write field 2
-                const Field& field2 = encoded_frame.field2();
-                tbc_file.write(reinterpret_cast<const char*>(field2.data().data()),
-                              field2.data().size() * sizeof(uint16_t));
-            }
-            
-            if ((frame_num + 1) % 10 == 0 || frame_num == num_frames - 1) {
-                ENCODE_ORC_LOG_DEBUG("Writing field {} / {}", (frame_num + 1) * 2, total_fields);
-            }
-        }
-        
-        if (separate_yc) {
-            yc_writer.close();
-        } else {
-            tbc_file.close();
-        }
-        
-        // Write metadata
-        std::string metadata_filename = output_filename + ".db";
-        ENCODE_ORC_LOG_DEBUG("Writing metadata: {}", metadata_filename);
-        
-        MetadataWriter metadata_writer;
-        if (!metadata_writer.open(metadata_filename)) {
-            error_message_ = "Failed to open metadata database: " + metadata_writer.get_error();
+        if (!encode_frames(output, params, source_standard, image_frames, num_frames, first_frame,
+                           enable_chroma_filter, enable_luma_filter)) {
             return false;
         }
         
-        if (!metadata_writer.write_metadata(metadata)) {
-            error_message_ = "Failed to write metadata: " + metadata_writer.get_error();
-            return false;
-        }
-        
-        ENCODE_ORC_LOG_DEBUG("  {}", output_filename);
-        ENCODE_ORC_LOG_DEBUG("  {}.db", output_filename);
-        
         return true;
         
     } catch (const std::exception& e) {
@@ -322,18 +106,14 @@ bool VideoEncoder::encode_yuv422_image(const std::string& output_filename,
     }
 }
 
-bool VideoEncoder::encode_png_image(const std::string& output_filename,
+bool VideoEncoder::encode_png_image(TBCOutputSink& output,
                                     VideoSystem system,
                                     SourceVideoStandard source_standard,
                                     const std::string& png_file,
                                     int32_t num_frames,
-                                    int32_t picture_start,
-                                    int32_t chapter,
-                                    const std::string& timecode_start,
                                     bool enable_chroma_filter,
                                     bool enable_luma_filter,
-                                    bool separate_yc,
-                                    bool yc_legacy) {
+                                    int32_t first_frame) {
     try {
         VideoParameters params = (system == VideoSystem::PAL)
                                  ? VideoParameters::create_pal_composite()
@@ -374,175 +154,16 @@ bool VideoEncoder::encode_png_image(const std::string& output_filename,
         ENCODE_ORC_LOG_DEBUG("Image: {} ({}x{})", png_file, img_width, img_height);
         ENCODE_ORC_LOG_DEBUG("Field dimensions: {}x{}", params.field_width, params.field_height);
 
-        FrameBuffer image_frame;
-        if (!png_loader.load_frame(0, img_width, img_height, params, image_frame, load_error)) {
+        std::vector<FrameBuffer> image_frames(1);
+        if (!png_loader.load_frame(0, img_width, img_height, params, image_frames[0], load_error)) {
             error_message_ = load_error;
             png_loader.close();
             return false;
         }
         png_loader.close();
 
-        std::ofstream tbc_file;
-        YCTBCWriter yc_writer(yc_legacy ? YCTBCWriter::NamingMode::LEGACY : YCTBCWriter::NamingMode::MODERN);
-
-        if (separate_yc) {
-            if (!yc_writer.open(output_filename)) {
-                error_message_ = "Failed to open Y/C output files: " + output_filename;
-                return false;
-            }
-        } else {
-            tbc_file.open(output_filename, std::ios::binary);
-            if (!tbc_file) {
-                error_message_ = "Failed to open output file: " + output_filename;
-                return false;
-            }
-        }
-
-        int32_t total_fields = num_frames * 2;
-        for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-            int32_t field_number = frame_num * 2;
-
-            if (separate_yc) {
-                Field y_field1, c_field1, y_field2, c_field2;
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    pal_encoder.encode_frame_yc(image_frame, field_number,
-                                                y_field1, c_field1, y_field2, c_field2);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    ntsc_encoder.encode_frame_yc(image_frame, field_number,
-                                                 y_field1, c_field1, y_field2, c_field2);
-                }
-
-                yc_writer.write_y_field(y_field1);
-                yc_writer.write_c_field(c_field1);
-                yc_writer.write_y_field(y_field2);
-                yc_writer.write_c_field(c_field2);
-            } else {
-                Frame encoded_frame;
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    encoded_frame = pal_encoder.encode_frame(image_frame, field_number);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    encoded_frame = ntsc_encoder.encode_frame(image_frame, field_number);
-                }
-
-                const Field& field1 = encoded_frame.field1();
-                tbc_file.write(reinterpret_cast<const char*>(field1.data().data()),
-                               field1.data().size() * sizeof(uint16_t));
-                const Field& field2 = encoded_frame.field2();
-                tbc_file.write(reinterpret_cast<const char*>(field2.data().data()),
-                               field2.data().size() * sizeof(uint16_t));
-            }
-
-            if ((frame_num + 1) % 10 == 0 || frame_num == num_frames - 1) {
-                ENCODE_ORC_LOG_DEBUG("Writing field {} / {}", (frame_num + 1) * 2, total_fields);
-            }
-        }
-
-        if (separate_yc) {
-            yc_writer.close();
-        } else {
-            tbc_file.close();
-        }
-
-        CaptureMetadata metadata;
-        metadata.initialize(system, total_fields);
-        metadata.video_params = params;
-        metadata.git_branch = "main";
-        metadata.git_commit = "v0.1.0-dev";
-        metadata.capture_notes = "PNG image from " + png_file;
-
-        // Add VBI data if supported by the selected standard
-        const bool include_vbi_png = standard_supports_vbi(source_standard, system);
-        if (include_vbi_png) {
-            metadata.vbi_data.resize(total_fields);
-        }
-
-        // Determine VBI mode based on provided parameters
-        bool use_cav = (picture_start > 0);
-        bool use_clv_chapter = (chapter > 0);
-        bool use_clv_timecode = !timecode_start.empty();
-
-        // Determine frame rate based on video system
-        int32_t fps = (system == VideoSystem::PAL) ? 25 : 30;
-
-        // Parse CLV timecode start value (HH:MM:SS:FF format)
-        int32_t timecode_start_frame = 0;
-        if (use_clv_timecode) {
-            int32_t start_hh = 0, start_mm = 0, start_ss = 0, start_ff = 0;
-            int parsed = std::sscanf(timecode_start.c_str(), "%d:%d:%d:%d",
-                                     &start_hh, &start_mm, &start_ss, &start_ff);
-            if (parsed >= 3) {
-                timecode_start_frame = start_hh * 3600 * fps +
-                                       start_mm * 60 * fps +
-                                       start_ss * fps +
-                                       start_ff;
-            }
-        }
-
-        if (include_vbi_png) {
-            for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-                VBIData vbi;
-                
-                if (use_cav) {
-                    vbi.vbi0 = 0x8BA000;
-                    int32_t picture_number = picture_start + frame_num;
-                    uint8_t vbi_byte0, vbi_byte1, vbi_byte2;
-                    BiphaseEncoder::encode_cav_picture_number(picture_number, vbi_byte0, vbi_byte1, vbi_byte2);
-                    int32_t cav_picture_number = (static_cast<int32_t>(vbi_byte0) << 16) |
-                                                 (static_cast<int32_t>(vbi_byte1) << 8) |
-                                                 static_cast<int32_t>(vbi_byte2);
-                    vbi.vbi1 = cav_picture_number;
-                    vbi.vbi2 = cav_picture_number;
-                } else if (use_clv_chapter) {
-                    int32_t chapter_bcd = ((chapter / 10) << 4) | (chapter % 10);
-                    int32_t chapter_code = 0x800DDD | ((chapter_bcd & 0x7F) << 12);
-                    vbi.vbi1 = chapter_code;
-                    vbi.vbi2 = chapter_code;
-                } else if (use_clv_timecode) {
-                    int32_t total_frame = timecode_start_frame + frame_num;
-                    int32_t total_seconds = total_frame / fps;
-                    int32_t frame_in_second = total_frame % fps;
-                    int32_t total_minutes = total_seconds / 60;
-                    int32_t total_hours = total_minutes / 60;
-                    int32_t hh = total_hours % 10;
-                    int32_t mm = total_minutes % 60;
-                    int32_t ss = total_seconds % 60;
-                    int32_t sec_tens = ss / 10;
-                    int32_t sec_units = ss % 10;
-                    int32_t x1 = 0x0A + sec_tens;
-                    int32_t pic_tens = frame_in_second / 10;
-                    int32_t pic_units = frame_in_second % 10;
-                    int32_t pic_bcd = (pic_tens << 4) | pic_units;
-                    vbi.vbi0 = (0x8 << 20) | (x1 << 16) | (0xE << 12) | (sec_units << 8) | pic_bcd;
-                    int32_t hh_bcd = ((hh / 10) << 4) | (hh % 10);
-                    int32_t mm_bcd = ((mm / 10) << 4) | (mm % 10);
-                    int32_t timecode = 0xF0DD00 | (hh_bcd << 16) | mm_bcd;
-                    vbi.vbi1 = timecode;
-                    vbi.vbi2 = timecode;
-                } else {
-                    vbi.vbi1 = 0x88FFFF;
-                    vbi.vbi2 = 0x88FFFF;
-                }
-                metadata.vbi_data[frame_num * 2] = vbi;
-                metadata.vbi_data[frame_num * 2 + 1] = vbi;
-            }
-        }
-
-        std::string metadata_filename = output_filename + ".db";
-        MetadataWriter metadata_writer;
-        if (!metadata_writer.open(metadata_filename)) {
-            error_message_ = "Failed to open metadata database: " + metadata_writer.get_error();
-            return false;
-        }
-        if (!metadata_writer.write_metadata(metadata)) {
-            error_message_ = "Failed to write metadata: " + metadata_writer.get_error();
+        if (!encode_frames(output, params, source_standard, image_frames, num_frames, first_frame,
+                           enable_chroma_filter, enable_luma_filter)) {
             return false;
         }
 
@@ -554,19 +175,15 @@ bool VideoEncoder::encode_png_image(const std::string& output_filename,
     }
 }
 
-bool VideoEncoder::encode_mov_file(const std::string& output_filename,
+bool VideoEncoder::encode_mov_file(TBCOutputSink& output,
                                    VideoSystem system,
                                    SourceVideoStandard source_standard,
                                    const std::string& mov_file,
                                    int32_t num_frames,
                                    int32_t start_frame,
-                                   int32_t picture_start,
-                                   int32_t chapter,
-                                   const std::string& timecode_start,
                                    bool enable_chroma_filter,
                                    bool enable_luma_filter,
-                                   bool separate_yc,
-                                   bool yc_legacy) {
+                                   int32_t first_frame) {
     try {
         // Get video parameters for the system
         VideoParameters params;
@@ -575,9 +192,6 @@ bool VideoEncoder::encode_mov_file(const std::string& output_filename,
         } else {
             params = VideoParameters::create_ntsc_composite();
         }
-
-        // Determine whether this standard should carry biphase VBI metadata (for metadata DB only)
-        const bool include_vbi = standard_supports_vbi(source_standard, system);
         
         // Apply any video level overrides
         VideoParameters::apply_video_level_overrides(params, 
@@ -604,210 +218,24 @@ bool VideoEncoder::encode_mov_file(const std::string& output_filename,
         ENCODE_ORC_LOG_DEBUG("MOV file: {}x{}", mov_width, mov_height);
         ENCODE_ORC_LOG_DEBUG("Expected: {}x{}", expected_width, expected_height);
         
-        // Load frames from MOV file
-        std::vector<FrameBuffer> frames;
-        if (!mov_loader.load_frames(start_frame, num_frames, expected_width, expected_height,
-                                    params, frames, error_message_)) {
+        // Stream frames from the MOV file; ffmpeg decodes ahead while we encode
+        // A resumed section picks the stream up at its first missing frame
+        if (!mov_loader.start_stream(start_frame + first_frame, num_frames - first_frame,
+                                     expected_width, expected_height, params, error_message_)) {
             mov_loader.close();
             return false;
         }
         
-        mov_loader.close();
-        
-        // Verify we got exactly the number of frames requested
-        int32_t actual_num_frames = static_cast<int32_t>(frames.size());
-        if (actual_num_frames != num_frames) {
-            error_message_ = "Frame count mismatch: requested " + std::to_string(num_frames) +
-                           ", got " + std::to_string(actual_num_frames) + 
-                           ". MOV file extraction must be frame-accurate.";
-            return false;
-        }
-        
-        ENCODE_ORC_LOG_DEBUG("Loaded {} frames from MOV file", actual_num_frames);
+        ENCODE_ORC_LOG_DEBUG("Streaming {} frames from MOV file", num_frames - first_frame);
         ENCODE_ORC_LOG_DEBUG("Encoding {} frames ({} fields)", num_frames, num_frames * 2);
         
-        // Open TBC file for writing
-        std::ofstream tbc_file;
-        YCTBCWriter yc_writer(yc_legacy ? YCTBCWriter::NamingMode::LEGACY : YCTBCWriter::NamingMode::MODERN);
-        
-        if (separate_yc) {
-            if (!yc_writer.open(output_filename)) {
-                error_message_ = "Failed to open Y/C output files: " + output_filename;
-                return false;
-            }
-        } else {
-            tbc_file.open(output_filename, std::ios::binary);
-            if (!tbc_file) {
-                error_message_ = "Failed to open output file: " + output_filename;
-                return false;
-            }
-        }
-        
-        // Encode and write fields
-        for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-            int32_t field_number = frame_num * 2;
-            
-            if (frame_num % 10 == 0 || frame_num == num_frames - 1) {
-                ENCODE_ORC_LOG_DEBUG("Encoding MOV frame {}/{}", frame_num + 1, num_frames);
-            }
-            
-            if (separate_yc) {
-                // Encode with separate Y/C output
-                Field y_field1, c_field1, y_field2, c_field2;
-                
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    pal_encoder.encode_frame_yc(frames[frame_num], field_number,
-                                                y_field1, c_field1, y_field2, c_field2, nullptr);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    ntsc_encoder.encode_frame_yc(frames[frame_num], field_number,
-                                                 y_field1, c_field1, y_field2, c_field2, nullptr);
-                }
-                
-                // Write Y and C fields
-                yc_writer.write_y_field(y_field1);
-                yc_writer.write_c_field(c_field1);
-                yc_writer.write_y_field(y_field2);
-                yc_writer.write_c_field(c_field2);
-            } else {
-                // Encode with composite output
-                Frame frame;
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    frame = pal_encoder.encode_frame(frames[frame_num], field_number, nullptr);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    frame = ntsc_encoder.encode_frame(frames[frame_num], field_number, nullptr);
-                }
-                
-                // Write fields to TBC file
-                const Field& field1 = frame.field1();
-                tbc_file.write(reinterpret_cast<const char*>(field1.data().data()),
-                              field1.data().size() * sizeof(uint16_t));
-                
-                const Field& field2 = frame.field2();
-                tbc_file.write(reinterpret_cast<const char*>(field2.data().data()),
-                              field2.data().size() * sizeof(uint16_t));
-            }
-        }
-        
-        // Close files
-        if (separate_yc) {
-            yc_writer.close();
-        } else if (tbc_file.is_open()) {
-            tbc_file.close();
-        }
-        
-        // Create and initialize metadata
-        int32_t total_fields = num_frames * 2;
-        CaptureMetadata metadata;
-        metadata.initialize(system, total_fields);
-        metadata.video_params = params;
-        metadata.git_branch = "main";
-        metadata.git_commit = "v0.1.0-dev";
-        metadata.capture_notes = "MOV file from " + mov_file;
-        
-        // Add VBI data for each field when the standard allows it
-        if (include_vbi) {
-            metadata.vbi_data.resize(total_fields);
-            
-            // Determine VBI mode
-            bool use_cav = (picture_start > 0);
-            bool use_clv_chapter = (chapter > 0);
-            bool use_clv_timecode = !timecode_start.empty();
-            
-            int32_t fps = (system == VideoSystem::PAL) ? 25 : 30;
-            
-            int32_t timecode_start_frame = 0;
-            if (use_clv_timecode) {
-                int32_t start_hh = 0, start_mm = 0, start_ss = 0, start_ff = 0;
-                int parsed = std::sscanf(timecode_start.c_str(), "%d:%d:%d:%d", 
-                                          &start_hh, &start_mm, &start_ss, &start_ff);
-                if (parsed >= 3) {
-                    timecode_start_frame = start_hh * 3600 * fps +
-                                           start_mm * 60 * fps +
-                                           start_ss * fps +
-                                           start_ff;
-                }
-            }
-            
-            for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-                VBIData vbi;
-                
-                if (use_cav) {
-                    vbi.vbi0 = 0x8BA000;
-                    
-                    int32_t picture_number = picture_start + frame_num;
-                    uint8_t vbi_byte0, vbi_byte1, vbi_byte2;
-                    BiphaseEncoder::encode_cav_picture_number(picture_number, vbi_byte0, vbi_byte1, vbi_byte2);
-                    
-                    int32_t cav_picture_number = (static_cast<int32_t>(vbi_byte0) << 16) |
-                                                 (static_cast<int32_t>(vbi_byte1) << 8) |
-                                                 static_cast<int32_t>(vbi_byte2);
-                    
-                    vbi.vbi1 = cav_picture_number;
-                    vbi.vbi2 = cav_picture_number;
-                } else if (use_clv_chapter) {
-                    int32_t chapter_bcd = ((chapter / 10) << 4) | (chapter % 10);
-                    int32_t chapter_code = 0x800DDD | ((chapter_bcd & 0x7F) << 12);
-                    
-                    vbi.vbi1 = chapter_code;
-                    vbi.vbi2 = chapter_code;
-                } else if (use_clv_timecode) {
-                    int32_t total_frame = timecode_start_frame + frame_num;
-                    int32_t total_seconds = total_frame / fps;
-                    int32_t frame_in_second = total_frame % fps;
-                    
-                    int32_t total_minutes = total_seconds / 60;
-                    int32_t total_hours = total_minutes / 60;
-                    
-                    int32_t hh = total_hours % 10;
-                    int32_t mm = total_minutes % 60;
-                    int32_t ss = total_seconds % 60;
-                    
-                    int32_t sec_tens = ss / 10;
-                    int32_t sec_units = ss % 10;
-                    int32_t x1 = 0x0A + sec_tens;
-                    
-                    int32_t pic_tens = frame_in_second / 10;
-                    int32_t pic_units = frame_in_second % 10;
-                    int32_t pic_bcd = (pic_tens << 4) | pic_units;
-                    
-                    vbi.vbi0 = (0x8 << 20) | (x1 << 16) | (0xE << 12) | (sec_units << 8) | pic_bcd;
-                    
-                    int32_t hh_bcd = ((hh / 10) << 4) | (hh % 10);
-                    int32_t mm_bcd = ((mm / 10) << 4) | (mm % 10);
-                    
-                    int32_t timecode = 0xF0DD00 | (hh_bcd << 16) | mm_bcd;
-                    
-                    vbi.vbi1 = timecode;
-                    vbi.vbi2 = timecode;
-                } else {
-                    vbi.vbi1 = 0x88FFFF;
-                    vbi.vbi2 = 0x88FFFF;
-                }
-                
-                metadata.vbi_data[frame_num * 2] = vbi;
-                metadata.vbi_data[frame_num * 2 + 1] = vbi;
-            }
-        }
-        
-        // Write metadata database
-        std::string metadata_filename = output_filename + ".db";
-        MetadataWriter metadata_writer;
-        if (!metadata_writer.open(metadata_filename)) {
-            error_message_ = "Failed to open metadata database: " + metadata_writer.get_error();
-            return false;
-        }
-        if (!metadata_writer.write_metadata(metadata)) {
-            error_message_ = "Failed to write metadata: " + metadata_writer.get_error();
+        // Encode and append to the project output
+        if (!encode_frames(output, params, source_standard, stream_source(mov_loader, num_frames, "MOV"),
+                           false, num_frames, first_frame,
+                           enable_chroma_filter, enable_luma_filter)) {
             return false;
         }
+        mov_loader.close();
         
         return true;
         
@@ -817,19 +245,15 @@ bool VideoEncoder::encode_mov_file(const std::string& output_filename,
     }
 }
 
-bool VideoEncoder::encode_mp4_file(const std::string& output_filename,
+bool VideoEncoder::encode_mp4_file(TBCOutputSink& output,
                                    VideoSystem system,
                                    SourceVideoStandard source_standard,
                                    const std::string& mp4_file,
                                    int32_t num_frames,
                                    int32_t start_frame,
-                                   int32_t picture_start,
-                                   int32_t chapter,
-                                   const std::string& timecode_start,
                                    bool enable_chroma_filter,
                                    bool enable_luma_filter,
-                                   bool separate_yc,
-                                   bool yc_legacy) {
+                                   int32_t first_frame) {
     try {
         // Get video parameters for the system
         VideoParameters params;
@@ -838,9 +262,6 @@ bool VideoEncoder::encode_mp4_file(const std::string& output_filename,
         } else {
             params = VideoParameters::create_ntsc_composite();
         }
-
-        // Determine whether this standard should carry biphase VBI metadata (for metadata DB only)
-        const bool include_vbi = standard_supports_vbi(source_standard, system);
         
         // Apply any video level overrides
         VideoParameters::apply_video_level_overrides(params, 
@@ -867,217 +288,154 @@ bool VideoEncoder::encode_mp4_file(const std::string& output_filename,
         ENCODE_ORC_LOG_DEBUG("MP4 file: {}x{}", mp4_width, mp4_height);
         ENCODE_ORC_LOG_DEBUG("Expected: {}x{}", expected_width, expected_height);
         
-        // Load frames from MP4 file
-        std::vector<FrameBuffer> frames;
-        if (!mp4_loader.load_frames(start_frame, num_frames, expected_width, expected_height,
-                                    params, frames, error_message_)) {
+        // Stream frames from the MP4 file; ffmpeg decodes ahead while we encode
+        // A resumed section picks the stream up at its first missing frame
+        if (!mp4_loader.start_stream(start_frame + first_frame, num_frames - first_frame,
+                                     expected_width, expected_height, params, error_message_)) {
             mp4_loader.close();
             return false;
         }
         
-        mp4_loader.close();
+        ENCODE_ORC_LOG_DEBUG("Streaming {} frames from MP4 file", num_frames - first_frame);
+        ENCODE_ORC_LOG_DEBUG("Encoding {} frames ({} fields)", num_frames, num_frames * 2);
         
-        // Verify we got exactly the number of frames requested
-        int32_t actual_num_frames = static_cast<int32_t>(frames.size());
-        if (actual_num_frames != num_frames) {
-            error_message_ = "Frame count mismatch: requested " + std::to_string(num_frames) +
-                           ", got " + std::to_string(actual_num_frames) + 
-                           ". MP4 file extraction must be frame-accurate.";
+        // Encode and append to the project output
+        if (!encode_frames(output, params, source_standard, stream_source(mp4_loader, num_frames, "MP4"),
+                           false, num_frames, first_frame,
+                           enable_chroma_filter, enable_luma_filter)) {
             return false;
         }
+        mp4_loader.close();
         
-        ENCODE_ORC_LOG_DEBUG("Loaded {} frames from MP4 file", actual_num_frames);
-        ENCODE_ORC_LOG_DEBUG("Encoding {} frames ({} fields)", num_frames, num_frames * 2);
-        
-        // Open TBC file for writing
-        std::ofstream tbc_file;
-        YCTBCWriter yc_writer(yc_legacy ? YCTBCWriter::NamingMode::LEGACY : YCTBCWriter::NamingMode::MODERN);
+        return true;
         
-        if (separate_yc) {
-            if (!yc_writer.open(output_filename)) {
-                error_message_ = "Failed to open Y/C output files: " + output_filename;
-                return false;
-            }
-        } else {
-            tbc_file.open(output_filename, std::ios::binary);
-            if (!tbc_file) {
-                error_message_ = "Failed to open output file: " + output_filename;
-                return false;
-            }
+    } catch (const std::exception& e) {
+        error_message_ = std::string("Exception: ") + e.what();
+        return false;
+    }
+}
+
+
+bool VideoEncoder::encode_frames(TBCOutputSink& output,
+                                 const VideoParameters& params,
+                                 SourceVideoStandard source_standard,
+                                 const std::vector<FrameBuffer>& frames,
+                                 int32_t num_frames,
+                                 int32_t first_frame,
+                                 bool enable_chroma_filter,
+                                 bool enable_luma_filter) {
+    if (frames.empty()) {
+        error_message_ = "No source frames to encode";
+        return false;
+    }
+    
+    // A single source frame is a still image repeated for every output frame
+    const bool repeat_frame = (frames.size() == 1);
+    const FrameSource source = [&](int32_t frame_num, FrameBuffer&) {
+        return repeat_frame ? &frames[0] : &frames[frame_num];
+    };
+    
+    return encode_frames(output, params, source_standard, source, repeat_frame, num_frames, first_frame,
+                         enable_chroma_filter, enable_luma_filter);
+}
+
+VideoEncoder::FrameSource VideoEncoder::stream_source(VideoLoaderBase& loader, int32_t num_frames,
+                                                      const std::string& source_name) {
+    return [this, &loader, num_frames, source_name](int32_t frame_num, FrameBuffer& scratch)
+               -> const FrameBuffer* {
+        std::string stream_error;
+        if (loader.next_frame(scratch, stream_error)) {
+            return &scratch;
         }
         
-        // Encode and write fields
-        for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-            int32_t field_number = frame_num * 2;
-            
-            if (frame_num % 10 == 0 || frame_num == num_frames - 1) {
-                ENCODE_ORC_LOG_DEBUG("Encoding MP4 frame {}/{}", frame_num + 1, num_frames);
-            }
-            
-            if (separate_yc) {
-                // Encode with separate Y/C output
-                Field y_field1, c_field1, y_field2, c_field2;
-                
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    pal_encoder.encode_frame_yc(frames[frame_num], field_number,
-                                                y_field1, c_field1, y_field2, c_field2, nullptr);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    ntsc_encoder.encode_frame_yc(frames[frame_num], field_number,
-                                                 y_field1, c_field1, y_field2, c_field2, nullptr);
-                }
-                
-                // Write Y and C fields
-                yc_writer.write_y_field(y_field1);
-                yc_writer.write_c_field(c_field1);
-                yc_writer.write_y_field(y_field2);
-                yc_writer.write_c_field(c_field2);
-            } else {
-                // Encode with composite output
-                Frame frame;
-                if (system == VideoSystem::PAL) {
-                    PALEncoder pal_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    pal_encoder.set_source_video_standard(source_standard);
-                    frame = pal_encoder.encode_frame(frames[frame_num], field_number, nullptr);
-                } else {
-                    NTSCEncoder ntsc_encoder(params, enable_chroma_filter, enable_luma_filter);
-                    ntsc_encoder.set_source_video_standard(source_standard);
-                    frame = ntsc_encoder.encode_frame(frames[frame_num], field_number, nullptr);
-                }
-                
-                // Write fields to TBC file
-                const Field& field1 = frame.field1();
-                tbc_file.write(reinterpret_cast<const char*>(field1.data().data()),
-                              field1.data().size() * sizeof(uint16_t));
-                
-                const Field& field2 = frame.field2();
-                tbc_file.write(reinterpret_cast<const char*>(field2.data().data()),
-                              field2.data().size() * sizeof(uint16_t));
-            }
+        if (!stream_error.empty()) {
+            error_message_ = stream_error;
+        } else {
+            error_message_ = "Frame count mismatch: requested " + std::to_string(num_frames) +
+                           ", got " + std::to_string(frame_num) + 
+                           ". " + source_name + " file extraction must be frame-accurate.";
         }
-        
-        // Close files
-        if (separate_yc) {
-            yc_writer.close();
-        } else if (tbc_file.is_open()) {
-            tbc_file.close();
+        return nullptr;
+    };
+}
+
+bool VideoEncoder::encode_frames(TBCOutputSink& output,
+                                 const VideoParameters& params,
+                                 SourceVideoStandard source_standard,
+                                 const FrameSource& source,
+                                 bool repeated_frame,
+                                 int32_t num_frames,
+                                 int32_t first_frame,
+                                 bool enable_chroma_filter,
+                                 bool enable_luma_filter) {
+    const bool separate_yc = output.separate_yc();
+    const int64_t first_field = output.field_offset() - static_cast<int64_t>(first_frame) * 2;
+    
+    // Keep the pipeline (and its encoders) from the previous section unless
+    // the thread count changed
+    if (pipeline_ && pipeline_->num_threads() == FrameEncodePipeline::resolve_thread_count(num_threads_)) {
+        pipeline_->configure(params, source_standard, enable_chroma_filter,
+                             enable_luma_filter, separate_yc);
+    } else {
+        pipeline_ = std::make_unique<FrameEncodePipeline>(params, source_standard, enable_chroma_filter,
+                                                          enable_luma_filter, separate_yc, num_threads_);
+    }
+    FrameEncodePipeline& pipeline = *pipeline_;
+    pipeline.set_line_threads(line_threads_);
+    ENCODE_ORC_LOG_DEBUG("Encoding with {} thread(s)", pipeline.num_threads());
+    
+    int32_t frames_written = first_frame;
+    std::string output_error;
+    pipeline.start([&](const EncodedFrame& encoded) {
+        bool ok = output.write_frame(encoded);
+        if (!ok) {
+            // The pipeline only knows the write failed; keep the reason
+            output_error = output.error();
+        }
+        
+        ++frames_written;
+        if (frames_written % 10 == 0 || frames_written == num_frames) {
+            ENCODE_ORC_LOG_DEBUG("Writing field {} / {}", frames_written * 2, num_frames * 2);
+        }
+        return ok;
+    });
+    
+    // Frames still queued or encoding are never overwritten: frame n reuses the
+    // slot of frame n - (max_in_flight + 1), which has been written by then
+    std::vector<BufferPool<FrameBuffer>::Handle> scratch(repeated_frame ? 1 : pipeline.max_in_flight() + 1);
+    for (auto& buffer : scratch) {
+        buffer = frame_buffer_pool_.acquire();
+    }
+    bool source_ok = true;
+    
+    for (int32_t frame_num = first_frame; frame_num < num_frames; ++frame_num) {
+        const FrameBuffer* frame_buffer = source(frame_num, *scratch[frame_num % scratch.size()]);
+        if (!frame_buffer) {
+            source_ok = false;
+            break;
         }
         
-        // Create and initialize metadata
-        int32_t total_fields = num_frames * 2;
-        CaptureMetadata metadata;
-        metadata.initialize(system, total_fields);
-        metadata.video_params = params;
-        metadata.git_branch = "main";
-        metadata.git_commit = "v0.1.0-dev";
-        metadata.capture_notes = "MP4 file from " + mp4_file;
-        
-        // Add VBI data for each field when the standard allows it
-        if (include_vbi) {
-            metadata.vbi_data.resize(total_fields);
-            
-            // Determine VBI mode
-            bool use_cav = (picture_start > 0);
-            bool use_clv_chapter = (chapter > 0);
-            bool use_clv_timecode = !timecode_start.empty();
-            
-            int32_t fps = (system == VideoSystem::PAL) ? 25 : 30;
-            
-            int32_t timecode_start_frame = 0;
-            if (use_clv_timecode) {
-                int32_t start_hh = 0, start_mm = 0, start_ss = 0, start_ff = 0;
-                int parsed = std::sscanf(timecode_start.c_str(), "%d:%d:%d:%d", 
-                                          &start_hh, &start_mm, &start_ss, &start_ff);
-                if (parsed >= 3) {
-                    timecode_start_frame = start_hh * 3600 * fps +
-                                           start_mm * 60 * fps +
-                                           start_ss * fps +
-                                           start_ff;
-                }
-            }
-            
-            for (int32_t frame_num = 0; frame_num < num_frames; ++frame_num) {
-                VBIData vbi;
-                
-                if (use_cav) {
-                    vbi.vbi0 = 0x8BA000;
-                    
-                    int32_t picture_number = picture_start + frame_num;
-                    uint8_t vbi_byte0, vbi_byte1, vbi_byte2;
-                    BiphaseEncoder::encode_cav_picture_number(picture_number, vbi_byte0, vbi_byte1, vbi_byte2);
-                    
-                    int32_t cav_picture_number = (static_cast<int32_t>(vbi_byte0) << 16) |
-                                                 (static_cast<int32_t>(vbi_byte1) << 8) |
-                                                 static_cast<int32_t>(vbi_byte2);
-                    
-                    vbi.vbi1 = cav_picture_number;
-                    vbi.vbi2 = cav_picture_number;
-                } else if (use_clv_chapter) {
-                    int32_t chapter_bcd = ((chapter / 10) << 4) | (chapter % 10);
-                    int32_t chapter_code = 0x800DDD | ((chapter_bcd & 0x7F) << 12);
-                    
-                    vbi.vbi1 = chapter_code;
-                    vbi.vbi2 = chapter_code;
-                } else if (use_clv_timecode) {
-                    int32_t total_frame = timecode_start_frame + frame_num;
-                    int32_t total_seconds = total_frame / fps;
-                    int32_t frame_in_second = total_frame % fps;
-                    
-                    int32_t total_minutes = total_seconds / 60;
-                    int32_t total_hours = total_minutes / 60;
-                    
-                    int32_t hh = total_hours % 10;
-                    int32_t mm = total_minutes % 60;
-                    int32_t ss = total_seconds % 60;
-                    
-                    int32_t sec_tens = ss / 10;
-                    int32_t sec_units = ss % 10;
-                    int32_t x1 = 0x0A + sec_tens;
-                    
-                    int32_t pic_tens = frame_in_second / 10;
-                    int32_t pic_units = frame_in_second % 10;
-                    int32_t pic_bcd = (pic_tens << 4) | pic_units;
-                    
-                    vbi.vbi0 = (0x8 << 20) | (x1 << 16) | (0xE << 12) | (sec_units << 8) | pic_bcd;
-                    
-                    int32_t hh_bcd = ((hh / 10) << 4) | (hh % 10);
-                    int32_t mm_bcd = ((mm / 10) << 4) | (mm % 10);
-                    
-                    int32_t timecode = 0xF0DD00 | (hh_bcd << 16) | mm_bcd;
-                    
-                    vbi.vbi1 = timecode;
-                    vbi.vbi2 = timecode;
-                } else {
-                    vbi.vbi1 = 0x88FFFF;
-                    vbi.vbi2 = 0x88FFFF;
-                }
-                
-                metadata.vbi_data[frame_num * 2] = vbi;
-                metadata.vbi_data[frame_num * 2 + 1] = vbi;
-            }
-        }
+        // The schedule is indexed by output field, so the frame's VBI is
+        // exactly what the .db records for it
+        FrameVBI vbi;
+        const bool has_vbi = vbi_schedule_ && vbi_schedule_->frame_vbi(first_field + frame_num * 2, vbi);
         
-        // Write metadata database
-        std::string metadata_filename = output_filename + ".db";
-        MetadataWriter metadata_writer;
-        if (!metadata_writer.open(metadata_filename)) {
-            error_message_ = "Failed to open metadata database: " + metadata_writer.get_error();
-            return false;
-        }
-        if (!metadata_writer.write_metadata(metadata)) {
-            error_message_ = "Failed to write metadata: " + metadata_writer.get_error();
-            return false;
+        if (!pipeline.submit(*frame_buffer, frame_num * 2, has_vbi ? &vbi : nullptr, repeated_frame)) {
+            break;
         }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        error_message_ = std::string("Exception: ") + e.what();
+    }
+    
+    if (!pipeline.finish()) {
+        error_message_ = output_error.empty() ? pipeline.get_error()
+                                              : pipeline.get_error() + ": " + output_error;
         return false;
     }
+    
+    const BufferPoolStats stats = frame_buffer_pool_.stats();
+    ENCODE_ORC_LOG_DEBUG("Source frame pool: {} allocated, {} reused, peak {} in use",
+                         stats.allocated, stats.reused, stats.peak);
+    
+    return source_ok;
 }
 
 } // namespace encode_orc
@@ -10,6 +10,8 @@
 #include "video_loader_base.h"
 #include <algorithm>
 #include <cmath>
+#include <exception>
+#include <utility>
 
 namespace encode_orc {
 
@@ -73,6 +75,9 @@ void VideoLoaderUtils::pad_and_upsample_yuv(int32_t target_width,
             out_v[out_idx] = neutral_v;
         }
     }
+    
+    // Classify once here so encoders can rely on the cached range
+    frame.update_signal_range();
 }
 
 void VideoLoaderUtils::pad_and_upsample_yuv_8bit(int32_t target_width,
@@ -152,6 +157,8 @@ void VideoLoaderUtils::pad_and_upsample_yuv_8bit(int32_t target_width,
             out_v[out_idx] = neutral_v_out;
         }
     }
+    
+    frame.update_signal_range();
 }
 
 bool VideoLoaderUtils::validate_frame_rate(double frame_rate, VideoSystem system,
@@ -192,5 +199,161 @@ bool VideoLoaderBase::validate_frame_range(int32_t start_frame, int32_t num_fram
     return true;
 }
 
+VideoLoaderBase::~VideoLoaderBase() {
+    // Streaming loaders stop their reader in their own destructor (the hooks
+    // are gone by now); this only catches a loader that forgot
+    stop_stream();
+}
+
+bool VideoLoaderBase::start_stream(int32_t start_frame,
+                                   int32_t num_frames,
+                                   int32_t expected_width,
+                                   int32_t expected_height,
+                                   const VideoParameters& params,
+                                   std::string& error_message,
+                                   size_t prefetch_frames) {
+    stop_stream();
+    
+    if (!is_open()) {
+        error_message = "Video file is not open";
+        return false;
+    }
+    if (!validate_dimensions(expected_width, expected_height, error_message) ||
+        !validate_format(params.system, error_message) ||
+        !validate_frame_range(start_frame, num_frames, error_message)) {
+        return false;
+    }
+    
+    if (!open_frame_stream(start_frame, num_frames, error_message)) {
+        return false;
+    }
+    
+    stream_queue_.clear();
+    stream_depth_ = std::max<size_t>(prefetch_frames, 1);
+    stream_num_frames_ = num_frames;
+    stream_stopping_ = false;
+    stream_finished_ = false;
+    stream_error_.clear();
+    
+    stream_thread_ = std::thread(&VideoLoaderBase::stream_reader_loop, this);
+    return true;
+}
+
+bool VideoLoaderBase::next_frame(FrameBuffer& frame, std::string& error_message) {
+    std::unique_lock<std::mutex> lock(stream_mutex_);
+    if (!stream_thread_.joinable()) {
+        error_message = "No frame stream has been started";
+        return false;
+    }
+    
+    stream_ready_.wait(lock, [this] { return !stream_queue_.empty() || stream_finished_; });
+    if (stream_queue_.empty()) {
+        error_message = stream_error_;
+        return false;
+    }
+    
+    // Hand the caller's old buffer back to the reader for reuse
+    FrameBuffer recycled = std::move(frame);
+    frame = std::move(stream_queue_.front());
+    stream_queue_.pop_front();
+    if (!recycled.data().empty() && stream_free_.size() < stream_depth_) {
+        stream_free_.push_back(std::move(recycled));
+    }
+    lock.unlock();
+    
+    stream_space_.notify_one();
+    return true;
+}
+
+void VideoLoaderBase::stop_stream() {
+    {
+        std::lock_guard<std::mutex> lock(stream_mutex_);
+        stream_stopping_ = true;
+    }
+    stream_space_.notify_all();
+    
+    if (stream_thread_.joinable()) {
+        stream_thread_.join();
+    }
+    
+    stream_queue_.clear();
+    stream_free_.clear();
+}
+
+bool VideoLoaderBase::open_frame_stream(int32_t /* start_frame */, int32_t /* num_frames */,
+                                        std::string& error_message) {
+    error_message = "Frame streaming is not supported for this source";
+    return false;
+}
+
+bool VideoLoaderBase::read_stream_frame(FrameBuffer& /* frame */, bool& end_of_stream,
+                                        std::string& /* error_message */) {
+    end_of_stream = true;
+    return true;
+}
+
+bool VideoLoaderBase::close_frame_stream(bool /* complete */, std::string& /* error_message */) {
+    return true;
+}
+
+void VideoLoaderBase::stream_reader_loop() {
+    std::string error;
+    bool complete = false;
+    
+    try {
+        for (int32_t frames_read = 0; ; ++frames_read) {
+            if (frames_read == stream_num_frames_) {
+                complete = true;
+                break;
+            }
+            
+            FrameBuffer frame;
+            {
+                std::unique_lock<std::mutex> lock(stream_mutex_);
+                stream_space_.wait(lock, [this] {
+                    return stream_stopping_ || stream_queue_.size() < stream_depth_;
+                });
+                if (stream_stopping_) {
+                    break;
+                }
+                if (!stream_free_.empty()) {
+                    frame = std::move(stream_free_.back());
+                    stream_free_.pop_back();
+                }
+            }
+            
+            // Decode outside the lock so the consumer can keep taking frames
+            bool end_of_stream = false;
+            if (!read_stream_frame(frame, end_of_stream, error)) {
+                break;
+            }
+            if (end_of_stream) {
+                complete = true;
+                break;
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(stream_mutex_);
+                stream_queue_.push_back(std::move(frame));
+            }
+            stream_ready_.notify_one();
+        }
+    } catch (const std::exception& e) {
+        error = std::string("Exception: ") + e.what();
+        complete = false;
+    }
+    
+    std::string close_error;
+    if (!close_frame_stream(complete, close_error) && error.empty()) {
+        error = close_error;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(stream_mutex_);
+        stream_error_ = error;
+        stream_finished_ = true;
+    }
+    stream_ready_.notify_all();
+}
 
 } // namespace encode_orc
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <vector>
 
 namespace encode_orc {
@@ -19,7 +20,6 @@ namespace encode_orc {
 namespace {
 // VITC physical layer constants
 constexpr double BIT_PERIOD_S = 0.5517e-6;      // 0.5517 µs per bit
-constexpr int32_t TOTAL_BITS = 90;              // 90 bits per word
 constexpr double EDGE_TIME_S = 200.0e-9;        // 200 ns nominal rise/fall
 constexpr double LEAD_MARGIN_S = 11.2e-6;       // ≥11.2 µs after sync
 constexpr double TRAIL_MARGIN_S = 1.9e-6;       // ≤1.9 µs before next sync
@@ -53,13 +53,26 @@ VITCGenerator::VITCGenerator(const VideoParameters& params)
     low_level_ = static_cast<uint16_t>(std::clamp(blanking_level_, 0, 65535));
     // VITC peaks at 100 IRE (white level) per EBU Tech 3097 / SMPTE 12M and yaml-project-format.md
     high_level_ = static_cast<uint16_t>(std::clamp(white_level_, 0, 65535));
+
+    // Render the four bit cells; a level change starts with the edge
+    for (int32_t previous = 0; previous < 2; ++previous) {
+        for (int32_t bit = 0; bit < 2; ++bit) {
+            uint16_t from_level = previous ? high_level_ : low_level_;
+            uint16_t to_level = bit ? high_level_ : low_level_;
+            std::vector<uint16_t>& cell = cells_[previous * 2 + bit];
+            cell.assign(samples_per_bit_, to_level);
+            if (previous != bit) {
+                write_transition(cell.data(), rise_fall_samples_, from_level, to_level);
+            }
+        }
+    }
 }
 
 void VITCGenerator::build_vitc_bits(VideoSystem system,
                                      int32_t total_frame,
                                      bool is_second_field,
-                                     std::vector<uint8_t>& bits) const {
-    bits.assign(TOTAL_BITS, 0);
+                                     Bits& bits) const {
+    bits.fill(0);
 
     const int fps = (system == VideoSystem::PAL) ? 25 : 30;
     const int frames = total_frame % fps;
@@ -111,7 +124,7 @@ void VITCGenerator::build_vitc_bits(VideoSystem system,
     }
 }
 
-uint8_t VITCGenerator::compute_crc(const std::vector<uint8_t>& bits) {
+uint8_t VITCGenerator::compute_crc(const Bits& bits) {
     // Compute 8-bit CRC as per EBU Tech 3097 / SMPTE 12M spec.
     // Each CRC bit is the XOR of specific data bits (Hamming code parity).
     // Reference: Unai.VITC VITCLine.cs SetChecksum()
@@ -145,7 +158,23 @@ uint8_t VITCGenerator::compute_crc(const std::vector<uint8_t>& bits) {
     return crc;
 }
 
-void VITCGenerator::render_nrz(const std::vector<uint8_t>& bits, uint16_t* line_buffer) const {
+void VITCGenerator::write_transition(uint16_t* line_buffer, int32_t ramp_len,
+                                     uint16_t from_level, uint16_t to_level) {
+    const double start_level = static_cast<double>(from_level);
+    const double end_level = static_cast<double>(to_level);
+    
+    for (int32_t i = 0; i < ramp_len; ++i) {
+        // Normalized position [0, 1]
+        double x = (ramp_len > 1) ? static_cast<double>(i) / static_cast<double>(ramp_len - 1) : 0.0;
+        // Sine-squared shaping
+        double s = std::sin(0.5 * M_PI * x);
+        double y = s * s;
+        double level = start_level + y * (end_level - start_level);
+        line_buffer[i] = static_cast<uint16_t>(std::clamp(level, 0.0, 65535.0));
+    }
+}
+
+void VITCGenerator::render_nrz(const Bits& bits, uint16_t* line_buffer) const {
     const int32_t buffer_size = params_.field_width;
 
     // NRZ (Non-Return to Zero) encoding per EBU Tech 3097 §2.1:
@@ -158,62 +187,29 @@ void VITCGenerator::render_nrz(const std::vector<uint8_t>& bits, uint16_t* line_
     // - Rise/fall time: 200ns ± 50ns
     // - Shape: sine-squared pulse edge
     // - Max overshoot: 5%
+    //
+    // The edge sits at the start of the bit, so each bit is one of the
+    // precomputed cells picked by the previous bit and this one.
 
-    // Lambda to write a transition with sine-squared shaping
-    auto write_transition = [&](int32_t start, int32_t end, uint16_t from_level, uint16_t to_level) {
-        if (start >= buffer_size || end <= start) return;
-        
-        int32_t ramp_start = std::max(0, start);
-        int32_t ramp_end = std::min(end, buffer_size);
-        int32_t ramp_len = ramp_end - ramp_start;
-        
-        if (ramp_len <= 0) return;
-        
-        const double start_level = static_cast<double>(from_level);
-        const double end_level = static_cast<double>(to_level);
-        
-        for (int32_t i = 0; i < ramp_len; ++i) {
-            // Normalized position [0, 1]
-            double x = (ramp_len > 1) ? static_cast<double>(i) / static_cast<double>(ramp_len - 1) : 0.0;
-            // Sine-squared shaping
-            double s = std::sin(0.5 * M_PI * x);
-            double y = s * s;
-            double level = start_level + y * (end_level - start_level);
-            line_buffer[ramp_start + i] = static_cast<uint16_t>(std::clamp(level, 0.0, 65535.0));
-        }
-    };
-
-    // Render each bit with proper transitions
-    uint16_t current_level = low_level_;  // Start at blanking (bit 0 level)
-    
     // Fill initial region before VITC with blanking
-    for (int32_t i = 0; i < start_sample_ && i < buffer_size; ++i) {
-        line_buffer[i] = low_level_;
-    }
+    std::fill_n(line_buffer, std::min(start_sample_, buffer_size), low_level_);
 
-    for (size_t i = 0; i < bits.size(); ++i) {
-        int32_t bit_start = start_sample_ + static_cast<int32_t>(i) * samples_per_bit_;
+    uint8_t previous = 0;  // Start at blanking (bit 0 level)
+    for (int32_t i = 0; i < TOTAL_BITS; ++i) {
+        int32_t bit_start = start_sample_ + i * samples_per_bit_;
         if (bit_start >= buffer_size) break;
 
-        int32_t bit_end = std::min(bit_start + samples_per_bit_, buffer_size);
-        uint16_t target_level = bits[i] ? high_level_ : low_level_;
-        
-        // If level changes, create transition at start of bit
-        if (target_level != current_level) {
-            int32_t transition_end = std::min(bit_start + rise_fall_samples_, bit_end);
-            write_transition(bit_start, transition_end, current_level, target_level);
-            
-            // Fill rest of bit with target level
-            for (int32_t sample = transition_end; sample < bit_end; ++sample) {
-                line_buffer[sample] = target_level;
-            }
-            current_level = target_level;
+        const uint8_t bit = bits[i] ? 1 : 0;
+        const int32_t count = std::min(samples_per_bit_, buffer_size - bit_start);
+        if (bit != previous && count < rise_fall_samples_) {
+            // Edge cut short by the end of the line
+            write_transition(line_buffer + bit_start, count,
+                             previous ? high_level_ : low_level_, bit ? high_level_ : low_level_);
         } else {
-            // No transition needed, fill with current level
-            for (int32_t sample = bit_start; sample < bit_end; ++sample) {
-                line_buffer[sample] = current_level;
-            }
+            std::memcpy(line_buffer + bit_start, cells_[previous * 2 + bit].data(),
+                        static_cast<size_t>(count) * sizeof(uint16_t));
         }
+        previous = bit;
     }
 }
 
@@ -224,7 +220,7 @@ void VITCGenerator::generate_line(VideoSystem system,
                                   bool is_second_field) const {
     (void)line_number; // reserved for future use (e.g., line-dependent flags)
 
-    std::vector<uint8_t> bits;
+    Bits bits;
     build_vitc_bits(system, total_frame, is_second_field, bits);
 
     // Debug log the timecode
@@ -243,11 +239,29 @@ void VITCGenerator::generate_line(VideoSystem system,
     render_nrz(bits, line_buffer);
 }
 
+void VITCGenerator::generate_lines(VideoSystem system,
+                                   int32_t total_frame,
+                                   uint16_t* const* line_buffers,
+                                   int32_t line_count,
+                                   bool is_second_field) const {
+    Bits bits;
+    build_vitc_bits(system, total_frame, is_second_field, bits);
+
+    ENCODE_ORC_LOG_DEBUG("VITC frame {}: {} lines (seq field {}), start {} samples",
+                         total_frame, line_count, is_second_field ? 2 : 1, start_sample_);
+
+    for (int32_t i = 0; i < line_count; ++i) {
+        render_nrz(bits, line_buffers[i]);
+    }
+}
+
 void VITCGenerator::get_vitc_bits(VideoSystem system,
                                   int32_t total_frame,
                                   bool is_second_field,
                                   std::vector<uint8_t>& bits) const {
-    build_vitc_bits(system, total_frame, is_second_field, bits);
+    Bits word;
+    build_vitc_bits(system, total_frame, is_second_field, word);
+    bits.assign(word.begin(), word.end());
 }
 
 } // namespace encode_orc
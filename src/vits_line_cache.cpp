@@ -0,0 +1,59 @@
+/*
+ * File:        vits_line_cache.cpp
+ * Module:      encode-orc
+ * Purpose:     Cache of rendered VITS lines by test signal and colour-sequence position
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "vits_line_cache.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace encode_orc {
+
+VITSLineCache::VITSLineCache(int32_t line_width, int32_t num_signals, int32_t sequence_fields,
+                             Renderer renderer)
+    : line_width_(line_width),
+      num_signals_(num_signals),
+      sequence_fields_(std::max(1, sequence_fields)),
+      renderer_(std::move(renderer)),
+      entries_(static_cast<size_t>(sequence_fields_) * num_signals_) {
+}
+
+void VITSLineCache::draw(int32_t signal, uint16_t* line_buffer, int32_t field_number) {
+    const int32_t sequence_field = field_number % sequence_fields_;
+    Entry& entry = entries_[static_cast<size_t>(sequence_field) * num_signals_ + signal];
+
+    if (!entry.built) {
+        // Samples left at their background differ between the two renders
+        std::vector<uint16_t> other(line_width_, static_cast<uint16_t>(0xFFFF));
+        entry.samples.assign(line_width_, static_cast<uint16_t>(0x0000));
+        renderer_(signal, entry.samples.data(), sequence_field);
+        renderer_(signal, other.data(), sequence_field);
+
+        int32_t n = 0;
+        while (n < line_width_) {
+            while (n < line_width_ && entry.samples[n] != other[n]) {
+                ++n;
+            }
+            const int32_t begin = n;
+            while (n < line_width_ && entry.samples[n] == other[n]) {
+                ++n;
+            }
+            if (n > begin) {
+                entry.runs.emplace_back(begin, n);
+            }
+        }
+        entry.built = true;
+    }
+
+    for (const auto& run : entry.runs) {
+        std::memcpy(line_buffer + run.first, entry.samples.data() + run.first,
+                    static_cast<size_t>(run.second - run.first) * sizeof(uint16_t));
+    }
+}
+
+} // namespace encode_orc
@@ -44,6 +44,9 @@ bool parse_yaml_config(const std::string& filename, YAMLProjectConfig& config,
             if (output["metadata_decoder"]) {
                 config.output.metadata_decoder = output["metadata_decoder"].as<std::string>();
             }
+            if (output["threads"]) {
+                config.output.threads = output["threads"].as<int32_t>();
+            }
             
             // Parse optional video levels override
             if (output["video_levels"]) {
@@ -271,6 +274,11 @@ bool validate_yaml_config(const YAMLProjectConfig& config, std::string& error_me
         return false;
     }
     
+    if (config.output.threads && config.output.threads.value() < 0) {
+        error_message = "Output threads must be 0 (auto) or a positive number";
+        return false;
+    }
+    
     if (config.sections.empty()) {
         error_message = "At least one section is required";
         return false;
@@ -188,6 +188,7 @@ bool YUV422Loader::load_frames(int32_t start_frame, int32_t end_frame,
             }
         }
         
+        cached_frame_.update_signal_range();
         frame_cached_ = true;
         frames.push_back(cached_frame_);
         return true;
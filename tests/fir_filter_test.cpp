@@ -0,0 +1,179 @@
+/*
+ * File:        fir_filter_test.cpp
+ * Module:      encode-orc
+ * Purpose:     Checks the FIR filter kernels against the reference path
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "fir_filter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace encode_orc;
+
+namespace {
+
+int s_failures = 0;
+
+/**
+ * @brief Test lines: noise, flat extremes and full-scale steps and impulses
+ *
+ * Lengths cover a PAL and an NTSC field line and short lines that leave
+ * every possible vector tail.
+ */
+std::vector<std::vector<uint16_t>> make_lines() {
+    std::vector<std::vector<uint16_t>> lines;
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<int32_t> sample(0, 65535);
+
+    for (int32_t length : {1135, 910, 1, 2, 3, 7, 15, 16, 17, 31, 33}) {
+        std::vector<uint16_t> noise(length);
+        for (auto& value : noise) {
+            value = static_cast<uint16_t>(sample(random));
+        }
+        lines.push_back(noise);
+    }
+
+    lines.emplace_back(1135, 0);
+    lines.emplace_back(1135, 65535);
+
+    std::vector<uint16_t> steps(1135);
+    for (size_t n = 0; n < steps.size(); ++n) {
+        steps[n] = ((n / 5) % 2) ? 65535 : 0;
+    }
+    lines.push_back(steps);
+
+    std::vector<uint16_t> impulses(1135, 0);
+    for (size_t n = 0; n < impulses.size(); n += 40) {
+        impulses[n] = 65535;
+    }
+    lines.push_back(impulses);
+    return lines;
+}
+
+/**
+ * @brief Largest difference between two lines
+ */
+int32_t max_difference(const std::vector<uint16_t>& a, const std::vector<uint16_t>& b) {
+    int32_t largest = 0;
+    for (size_t n = 0; n < a.size(); ++n) {
+        largest = std::max(largest, std::abs(static_cast<int32_t>(a[n]) - static_cast<int32_t>(b[n])));
+    }
+    return largest;
+}
+
+void fail(const std::string& message) {
+    std::cerr << "FAIL: " << message << "\n";
+    ++s_failures;
+}
+
+const char* precision_name(FIRFilter::Precision precision) {
+    switch (precision) {
+        case FIRFilter::Precision::Float: return "float";
+        case FIRFilter::Precision::Fixed: return "fixed";
+        default: return "exact";
+    }
+}
+
+/**
+ * @brief Check every precision of a runtime filter against its reference path
+ */
+void check_runtime_filter(const std::string& name, const std::vector<double>& taps,
+                          const std::vector<std::vector<uint16_t>>& lines) {
+    for (auto precision : {FIRFilter::Precision::Exact, FIRFilter::Precision::Float,
+                           FIRFilter::Precision::Fixed}) {
+        FIRFilter filter(taps);
+        filter.set_precision(precision);
+        const int32_t bound = filter.error_bound();
+
+        for (const auto& line : lines) {
+            const int32_t length = static_cast<int32_t>(line.size());
+            std::vector<uint16_t> output(line.size());
+            std::vector<uint16_t> reference(line.size());
+            filter.apply(line.data(), output.data(), length);
+            filter.apply_reference(line.data(), reference.data(), length);
+
+            const int32_t difference = max_difference(output, reference);
+            if (difference > bound) {
+                fail(name + " " + precision_name(precision) + " (" + FIRFilter::instruction_set() +
+                     ", " + std::to_string(length) + " samples): differs by " +
+                     std::to_string(difference) + ", bound is " + std::to_string(bound));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check a compile-time filter is bit-identical to the reference path
+ */
+template <typename Fixed>
+void check_fixed_filter(const std::string& name, const std::vector<std::vector<uint16_t>>& lines) {
+    const auto& coefficients = Fixed::coefficients();
+    const FIRFilter runtime(std::vector<double>(coefficients.begin(), coefficients.end()));
+    const Fixed filter;
+
+    for (const auto& line : lines) {
+        const int32_t length = static_cast<int32_t>(line.size());
+        std::vector<uint16_t> output(line.size());
+        std::vector<uint16_t> reference(line.size());
+        filter.apply(line.data(), output.data(), length);
+        runtime.apply_reference(line.data(), reference.data(), length);
+
+        if (output != reference) {
+            fail(name + " compile-time taps (" + std::string(FIRFilter::instruction_set()) + ", " +
+                 std::to_string(length) + " samples): differs by " +
+                 std::to_string(max_difference(output, reference)));
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    const auto lines = make_lines();
+
+    const auto& pal_uv = Filters::PalUVCoefficients::values;
+    const auto& ntsc_uv = Filters::NtscUVCoefficients::values;
+    const auto& ntsc_q = Filters::NtscQCoefficients::values;
+    const std::vector<std::pair<std::string, std::vector<double>>> tap_sets = {
+        {"PAL U/V", {pal_uv.begin(), pal_uv.end()}},
+        {"NTSC U/V", {ntsc_uv.begin(), ntsc_uv.end()}},
+        {"NTSC Q", {ntsc_q.begin(), ntsc_q.end()}},
+        // User-supplied taps from a project file: one symmetric, one not
+        {"user symmetric", {-0.05, 0.1, 0.25, 0.4, 0.25, 0.1, -0.05}},
+        {"user asymmetric", {0.05, 0.3, 0.4, 0.2, 0.05}}
+    };
+
+    int32_t instruction_sets = 0;
+    for (const char* instruction_set : {"avx2", "sse4.1", "scalar"}) {
+        if (!FIRFilter::set_instruction_set(instruction_set)) {
+            std::cout << "Skipping " << instruction_set << " (not supported by this CPU)\n";
+            continue;
+        }
+        ++instruction_sets;
+
+        for (const auto& [name, taps] : tap_sets) {
+            check_runtime_filter(name, taps, lines);
+        }
+        check_fixed_filter<Filters::PalUVFilter>("PAL U/V", lines);
+        check_fixed_filter<Filters::NtscUVFilter>("NTSC U/V", lines);
+        check_fixed_filter<Filters::NtscQFilter>("NTSC Q", lines);
+        std::cout << "Checked " << instruction_set << "\n";
+    }
+
+    if (instruction_sets == 0) {
+        fail("no instruction set could be selected");
+    }
+    if (s_failures > 0) {
+        std::cerr << s_failures << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * File:        line_modulator_test.cpp
+ * Module:      encode-orc
+ * Purpose:     Checks the fixed-point line modulator against the double-precision path
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ * SPDX-FileCopyrightText: 2026 Simon Inns
+ */
+
+#include "line_modulator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace encode_orc;
+
+namespace {
+
+int s_failures = 0;
+
+void fail(const std::string& message) {
+    std::cerr << "FAIL: " << message << "\n";
+    ++s_failures;
+}
+
+/**
+ * @brief One active line of Y/U/V input
+ */
+struct InputLine {
+    std::vector<uint16_t> y;
+    std::vector<uint16_t> u;
+    std::vector<uint16_t> v;
+    bool studio_range;
+};
+
+/**
+ * @brief Modulated levels of one line
+ */
+struct OutputLine {
+    std::vector<int32_t> luma;
+    std::vector<int32_t> chroma;
+
+    bool operator==(const OutputLine& other) const {
+        return luma == other.luma && chroma == other.chroma;
+    }
+};
+
+/**
+ * @brief Test lines: noise, the extremes and a sweep, in both input ranges
+ *
+ * Studio noise runs a little past the 10-bit codes, as interpolated
+ * edges can, so the overshoot path is covered too.
+ */
+std::vector<InputLine> make_lines(int32_t width) {
+    std::vector<InputLine> lines;
+    std::mt19937 random(54321);
+
+    for (bool studio_range : {true, false}) {
+        const int32_t top = studio_range ? 1100 : 65535;
+        std::uniform_int_distribution<int32_t> sample(0, top);
+
+        InputLine noise{std::vector<uint16_t>(width), std::vector<uint16_t>(width),
+                        std::vector<uint16_t>(width), studio_range};
+        for (int32_t n = 0; n < width; ++n) {
+            noise.y[n] = static_cast<uint16_t>(sample(random));
+            noise.u[n] = static_cast<uint16_t>(sample(random));
+            noise.v[n] = static_cast<uint16_t>(sample(random));
+        }
+        lines.push_back(noise);
+
+        const uint16_t high = studio_range ? 1023 : 65535;
+        for (uint16_t level : {uint16_t{0}, high}) {
+            lines.push_back({std::vector<uint16_t>(width, level), std::vector<uint16_t>(width, level),
+                             std::vector<uint16_t>(width, high - level), studio_range});
+        }
+
+        InputLine sweep{std::vector<uint16_t>(width), std::vector<uint16_t>(width),
+                        std::vector<uint16_t>(width), studio_range};
+        for (int32_t n = 0; n < width; ++n) {
+            const uint16_t level = static_cast<uint16_t>((static_cast<int64_t>(n) * high) / (width - 1));
+            sweep.y[n] = level;
+            sweep.u[n] = level;
+            sweep.v[n] = high - level;
+        }
+        lines.push_back(sweep);
+    }
+    return lines;
+}
+
+/**
+ * @brief A signal format and its colour-difference peaks, as the encoders use them
+ */
+struct Format {
+    std::string name;
+    VideoParameters params;
+    double u_max;
+    double v_max;
+};
+
+/**
+ * @brief Modulate every test line at a spread of field and line phases
+ */
+std::vector<OutputLine> modulate_all(const LineModulator& modulator, const SubcarrierTable& subcarrier,
+                                     const std::vector<InputLine>& lines, int32_t width, bool reference) {
+    std::vector<OutputLine> outputs;
+    for (int32_t field_number = 0; field_number < 8; ++field_number) {
+        for (int32_t line_number : {22, 100, 250}) {
+            const auto phase = subcarrier.line_phase(field_number, line_number);
+            for (const auto& line : lines) {
+                OutputLine output{std::vector<int32_t>(width), std::vector<int32_t>(width)};
+                if (reference) {
+                    modulator.modulate_reference(line.y.data(), line.u.data(), line.v.data(), line.studio_range,
+                                                 phase, output.luma.data(), output.chroma.data());
+                } else {
+                    modulator.modulate(line.y.data(), line.u.data(), line.v.data(), line.studio_range,
+                                       phase, output.luma.data(), output.chroma.data());
+                }
+                outputs.push_back(std::move(output));
+            }
+        }
+    }
+    return outputs;
+}
+
+/**
+ * @brief Largest luma or chroma difference between two sets of lines
+ */
+int32_t max_difference(const std::vector<OutputLine>& a, const std::vector<OutputLine>& b) {
+    int32_t largest = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t n = 0; n < a[i].luma.size(); ++n) {
+            largest = std::max({largest, std::abs(a[i].luma[n] - b[i].luma[n]),
+                                std::abs(a[i].chroma[n] - b[i].chroma[n])});
+        }
+    }
+    return largest;
+}
+
+void check_format(const Format& format) {
+    const auto subcarrier = SubcarrierTable::for_parameters(format.params);
+    const int32_t width = format.params.active_video_end - format.params.active_video_start;
+    const auto lines = make_lines(width);
+
+    LineModulator::set_default_precision(LineModulator::Precision::Exact);
+    const LineModulator exact(format.params, subcarrier, format.u_max, format.v_max);
+    LineModulator::set_default_precision(LineModulator::Precision::Fixed);
+    const LineModulator fixed(format.params, subcarrier, format.u_max, format.v_max);
+    LineModulator::set_default_precision(LineModulator::Precision::Exact);
+
+    if (fixed.precision() != LineModulator::Precision::Fixed) {
+        fail(format.name + ": fixed precision not available for the default levels");
+        return;
+    }
+
+    const auto reference = modulate_all(exact, *subcarrier, lines, width, true);
+    if (max_difference(modulate_all(exact, *subcarrier, lines, width, false), reference) != 0) {
+        fail(format.name + ": exact precision differs from the reference");
+    }
+
+    // The scalar kernel is the one the vector kernels must match exactly
+    std::vector<OutputLine> scalar;
+    for (const char* instruction_set : {"scalar", "sse4.1", "avx2"}) {
+        if (!LineModulator::set_instruction_set(instruction_set)) {
+            std::cout << "Skipping " << instruction_set << " (not supported by this CPU)\n";
+            continue;
+        }
+
+        const auto outputs = modulate_all(fixed, *subcarrier, lines, width, false);
+        const int32_t difference = max_difference(outputs, reference);
+        if (difference > fixed.error_bound()) {
+            fail(format.name + " fixed (" + instruction_set + "): differs from exact by " +
+                 std::to_string(difference) + ", bound is " + std::to_string(fixed.error_bound()));
+        }
+
+        if (scalar.empty()) {
+            scalar = outputs;
+        } else if (!(outputs == scalar)) {
+            fail(format.name + " fixed (" + instruction_set + "): differs from scalar by " +
+                 std::to_string(max_difference(outputs, scalar)));
+        }
+        std::cout << format.name << " " << instruction_set << ": largest error " << difference
+                  << ", bound " << fixed.error_bound() << "\n";
+    }
+}
+
+} // namespace
+
+int main() {
+    // Peaks as in PALEncoder (U/V) and NTSCEncoder (I/Q)
+    check_format({"PAL", VideoParameters::create_pal_composite(), 0.436010, 0.614975});
+    check_format({"NTSC", VideoParameters::create_ntsc_composite(), 0.5957, 0.5226});
+
+    if (s_failures > 0) {
+        std::cerr << s_failures << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}